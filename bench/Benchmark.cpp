@@ -0,0 +1,168 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace tiledl::bench;
+
+struct Registered {
+	const char* name;
+	BenchmarkFunction function;
+};
+
+/**
+ * @note A function local so registering from static initializers does
+ * not depend on the order translation units are initialised in
+ */
+static std::vector<Registered>& getRegistry()
+{
+	static std::vector<Registered> registry;
+	return registry;
+}
+
+State::State(Uint64 iterations)
+{
+	this->iterations = iterations;
+	this->remaining = iterations;
+	this->start = 0;
+	this->elapsed = 0;
+	this->items = 0;
+	this->running = false;
+}
+
+/**
+ * @brief Stop timing, such as around work inside the loop that should not count
+ */
+void State::pause()
+{
+	if (this->running) {
+		this->elapsed += SDL_GetPerformanceCounter() - this->start;
+		this->running = false;
+	}
+}
+
+void State::resume()
+{
+	if (!this->running) {
+		this->running = true;
+		this->start = SDL_GetPerformanceCounter();
+	}
+}
+
+/* ========= Getters =========*/
+
+Uint64 State::getIterations() const
+{
+	return this->iterations;
+}
+
+Uint64 State::getElapsed() const
+{
+	return this->elapsed;
+}
+
+Uint64 State::getItems() const
+{
+	return this->items;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @param items units of work in each iteration, reported as items per second
+ */
+void State::setItems(Uint64 items)
+{
+	this->items = items;
+}
+
+Registrar::Registrar(const char* name, BenchmarkFunction function)
+{
+	Runner::add(name, function);
+}
+
+Runner::Runner()
+{
+	this->minTime = 0.1;
+	this->runs = 5;
+}
+
+void Runner::add(const char* name, BenchmarkFunction function)
+{
+	Registered benchmark = { name, function };
+	getRegistry().push_back(benchmark);
+}
+
+/**
+ * @brief Run every registered benchmark in the order they were registered
+ *
+ * @param filter only run benchmarks with this in their name, empty for all
+ */
+std::vector<Result> Runner::run(const std::string& filter)
+{
+	std::vector<Result> results;
+
+	for (const Registered& benchmark : getRegistry()) {
+		if (filter.empty() || std::strstr(benchmark.name, filter.c_str()) != nullptr) {
+			results.push_back(run(benchmark.name, benchmark.function));
+		}
+	}
+
+	return results;
+}
+
+Result Runner::run(const char* name, BenchmarkFunction function)
+{
+	const double frequency = (double)SDL_GetPerformanceFrequency();
+	Uint64 iterations = 1;
+
+	// Grow the iterations until a run takes the minimum time
+	while (true) {
+		State state(iterations);
+		function(state);
+		const double seconds = state.getElapsed() / frequency;
+
+		if (seconds >= this->minTime || iterations >= ((Uint64)1 << 40)) {
+			break;
+		}
+
+		const double scale = (seconds > 0) ? this->minTime * 1.2 / seconds : 100;
+		iterations = (Uint64)(iterations * std::min(std::max(scale, 2.0), 100.0));
+	}
+
+	std::vector<double> times;
+	Uint64 items = 0;
+
+	for (int i = 0; i < this->runs; i++) {
+		State state(iterations);
+		function(state);
+		times.push_back(state.getElapsed() * 1e9 / frequency / iterations);
+		items = state.getItems();
+	}
+
+	std::sort(times.begin(), times.end());
+
+	Result result;
+	result.name = name;
+	result.iterations = iterations;
+	result.runs = this->runs;
+	result.median = times[times.size() / 2];
+	result.min = times.front();
+	result.max = times.back();
+	result.itemsPerSecond = (items > 0 && result.median > 0) ? items * 1e9 / result.median : 0;
+	return result;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @param seconds the least time each run is timed for
+ */
+void Runner::setMinTime(double seconds)
+{
+	this->minTime = std::max(seconds, 0.0);
+}
+
+void Runner::setRuns(int runs)
+{
+	this->runs = std::max(runs, 1);
+}
@@ -0,0 +1,129 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+namespace tiledl
+{
+	namespace bench
+	{
+		/**
+		 * Handed to a benchmark, the loop to time is written as
+		 * `while (state.next()) { ... }` after any setup
+		 */
+		class State
+		{
+		public:
+			State(Uint64 iterations);
+
+			inline bool next();
+			void pause();
+			void resume();
+
+			// Getters
+			Uint64 getIterations() const;
+			Uint64 getElapsed() const;
+			Uint64 getItems() const;
+
+			// Setters
+			void setItems(Uint64 items);
+
+		private:
+			Uint64 iterations;
+			Uint64 remaining;
+			Uint64 start;
+			Uint64 elapsed; // performance counter ticks spent in the loop
+			Uint64 items;   // work done per iteration, such as pixels, 0 if not set
+			bool running;
+		};
+
+		typedef void (*BenchmarkFunction)(State& state);
+
+		/**
+		 * The timing of one benchmark
+		 */
+		struct Result {
+			std::string name;
+			Uint64 iterations; // per run
+			int runs;
+			double median;  // nanoseconds per iteration
+			double min;
+			double max;
+			double itemsPerSecond; // from the median, 0 if the benchmark set no items
+		};
+
+		/**
+		 * Finds the iteration count that fills the minimum time, then
+		 * takes the median of several runs
+		 */
+		class Runner
+		{
+		public:
+			Runner();
+
+			static void add(const char* name, BenchmarkFunction function);
+
+			std::vector<Result> run(const std::string& filter);
+			Result run(const char* name, BenchmarkFunction function);
+
+			// Setters
+			void setMinTime(double seconds);
+			void setRuns(int runs);
+
+		private:
+			double minTime; // seconds per run
+			int runs;
+		};
+
+		/**
+		 * Registers a benchmark from a static initializer
+		 */
+		struct Registrar {
+			Registrar(const char* name, BenchmarkFunction function);
+		};
+
+		/**
+		 * @brief Stop the compiler from optimising away a value that is never read
+		 */
+		template <typename T>
+		inline void keep(const T& value)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			asm volatile("" : : "r"(&value) : "memory");
+#else
+			static volatile const void* sink;
+			sink = &value;
+#endif
+		}
+
+		/**
+		 * @brief Count down the iterations, timing from the first call to the last
+		 *
+		 * @return true while there is an iteration left to run
+		 */
+		inline bool State::next()
+		{
+			if (this->remaining > 0) {
+				if (this->remaining == this->iterations && !this->running) {
+					resume();
+				}
+
+				this->remaining--;
+				return true;
+			}
+
+			pause();
+			return false;
+		}
+	} // namespace bench
+} // namespace tiledl
+
+#define BENCHMARK(Name) \
+	static void Name##Benchmark(tiledl::bench::State& state); \
+	static tiledl::bench::Registrar Name##Registrar(#Name, Name##Benchmark); \
+	static void Name##Benchmark(tiledl::bench::State& state)
+
+#endif // BENCHMARK_H_
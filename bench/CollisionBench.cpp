@@ -0,0 +1,126 @@
+#include "Benchmark.h"
+#include "TileCollision.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace tiledl;
+using namespace tiledl::bench;
+
+namespace
+{
+	struct Actor {
+		Vector position, size, delta;
+	};
+
+	/**
+	 * A 64x64 grid of 16 pixel tiles with scattered walls and actors
+	 * placed in open space moving up to 40 pixels
+	 */
+	struct Scene {
+		static const int ACTORS = 1024;
+
+		Scene() : grid(64, 64, 16, 16)
+		{
+			srand(7);
+
+			for (int i = 0; i < 400; i++) {
+				grid.setSolid(rand() % 64, rand() % 64, true);
+			}
+
+			while ((int)actors.size() < ACTORS) {
+				Actor actor;
+				actor.position = Vector(rand() % 1000, rand() % 1000);
+				actor.size = Vector(4 + rand() % 12, 4 + rand() % 12);
+				actor.delta = Vector((rand() % 81) - 40, (rand() % 81) - 40);
+
+				if (!isBlocked(actor.position, actor.size)) {
+					actors.push_back(actor);
+				}
+			}
+		}
+
+		bool isBlocked(const Vector& position, const Vector& size) const
+		{
+			const int x0 = (int)std::floor(position.x / grid.getTileWidth());
+			const int y0 = (int)std::floor(position.y / grid.getTileHeight());
+			const int x1 = (int)std::ceil((position.x + size.x) / grid.getTileWidth()) - 1;
+			const int y1 = (int)std::ceil((position.y + size.y) / grid.getTileHeight()) - 1;
+
+			for (int y = y0; y <= y1; y++) {
+				for (int x = x0; x <= x1; x++) {
+					if (grid.isSolid(x, y)) {
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		/**
+		 * The naive alternative to sweeping, move a pixel at a time and
+		 * stop an axis as soon as the box overlaps a solid tile
+		 */
+		Vector substep(Vector position, const Vector& size, const Vector& delta) const
+		{
+			const int steps = (int)std::ceil(std::max(std::fabs(delta.x), std::fabs(delta.y)));
+			const Vector step = (steps > 0) ? delta / steps : Vector();
+
+			for (int i = 0; i < steps; i++) {
+				Vector next(position.x + step.x, position.y);
+
+				if (!isBlocked(next, size)) {
+					position = next;
+				}
+
+				next = Vector(position.x, position.y + step.y);
+
+				if (!isBlocked(next, size)) {
+					position = next;
+				}
+			}
+
+			return position;
+		}
+
+		TileGrid grid;
+		std::vector<Actor> actors;
+	};
+}
+
+BENCHMARK(TileCollisionSweep)
+{
+	Scene scene;
+	size_t i = 0;
+
+	while (state.next()) {
+		const Actor& actor = scene.actors[i++ & (Scene::ACTORS - 1)];
+		SweepResult result = TileCollision::sweep(scene.grid, actor.position, actor.size, actor.delta);
+		keep(result);
+	}
+}
+
+BENCHMARK(TileCollisionMove)
+{
+	Scene scene;
+	size_t i = 0;
+
+	while (state.next()) {
+		const Actor& actor = scene.actors[i++ & (Scene::ACTORS - 1)];
+		Vector position = TileCollision::move(scene.grid, actor.position, actor.size, actor.delta);
+		keep(position);
+	}
+}
+
+BENCHMARK(TileCollisionSubstep)
+{
+	Scene scene;
+	size_t i = 0;
+
+	while (state.next()) {
+		const Actor& actor = scene.actors[i++ & (Scene::ACTORS - 1)];
+		Vector position = scene.substep(actor.position, actor.size, actor.delta);
+		keep(position);
+	}
+}
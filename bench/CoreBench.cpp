@@ -0,0 +1,138 @@
+#include "Benchmark.h"
+#include "Vector.h"
+#include "Point.h"
+#include "Rectangle.h"
+#include "Color.h"
+#include "Timer.h"
+
+using namespace tiledl;
+using namespace tiledl::bench;
+
+BENCHMARK(VectorAdd)
+{
+	Vector a(1.5, 2.5), b(0.25, -0.5);
+
+	while (state.next()) {
+		a = a + b;
+		keep(a);
+	}
+}
+
+BENCHMARK(VectorScaleDivide)
+{
+	Vector a(1.5, 2.5);
+
+	while (state.next()) {
+		a = (a * 3.0) / 2.999;
+		keep(a);
+	}
+}
+
+BENCHMARK(PointAdd)
+{
+	Point a(1, 2), b(3, -2);
+
+	while (state.next()) {
+		a = a + b;
+		keep(a);
+	}
+}
+
+BENCHMARK(PointMultiplyDivide)
+{
+	Point a(7, 9), b(3, 5);
+
+	while (state.next()) {
+		a = (a * b) / b;
+		keep(a);
+	}
+}
+
+BENCHMARK(RectangleIntersects)
+{
+	Rectangle a(0, 0, 32, 32), b(16, 16, 32, 32);
+	int hits = 0;
+
+	while (state.next()) {
+		b.x = (b.x + 7) & 63;
+		hits += a.intersects(b);
+		keep(hits);
+	}
+}
+
+BENCHMARK(RectangleIsInside)
+{
+	Rectangle a(0, 0, 32, 32);
+	SDL_Point pt = { 0, 0 };
+	int hits = 0;
+
+	while (state.next()) {
+		pt.x = (pt.x + 7) & 63;
+		hits += a.isInside(pt);
+		keep(hits);
+	}
+}
+
+BENCHMARK(ColorFromRgba)
+{
+	int rgba = 0x11223344;
+
+	while (state.next()) {
+		Color color(rgba++);
+		keep(color);
+	}
+}
+
+BENCHMARK(ColorFromRgbaBigEndian)
+{
+	int rgba = 0x11223344;
+
+	while (state.next()) {
+		Color color(rgba++, BIG_ENDIAN_ORDER);
+		keep(color);
+	}
+}
+
+BENCHMARK(ColorMapToRGBA)
+{
+	SDL_Surface* surface = SDL_CreateRGBSurface(0, 1, 1, 32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000);
+	Color color(10, 20, 30, 40);
+
+	while (state.next()) {
+		color.r++;
+		Uint32 pixel = color.MapToRGBA(surface->format);
+		keep(pixel);
+	}
+
+	SDL_FreeSurface(surface);
+}
+
+BENCHMARK(PerformanceCounter)
+{
+	while (state.next()) {
+		Uint64 now = SDL_GetPerformanceCounter();
+		keep(now);
+	}
+}
+
+BENCHMARK(TimerStartStop)
+{
+	Timer timer;
+
+	while (state.next()) {
+		timer.start();
+		timer.stop();
+		keep(timer);
+	}
+}
+
+BENCHMARK(TimerDelta)
+{
+	Timer timer;
+	timer.start();
+
+	while (state.next()) {
+		float delta = timer.getDeltams();
+		keep(delta);
+	}
+}
@@ -0,0 +1,126 @@
+#include "Benchmark.h"
+#include "Renderer.h"
+#include "Surface.h"
+#include "Texture.h"
+
+using namespace tiledl;
+using namespace tiledl::bench;
+
+namespace
+{
+	/**
+	 * A software renderer drawing into a 256x256 surface
+	 */
+	struct Target {
+		Target() : surface(256, 256)
+		{
+			renderer.initSW(surface.getHandle());
+			renderer.setDrawColor(255, 255, 255, 255);
+		}
+
+		Surface surface;
+		Renderer renderer;
+	};
+}
+
+BENCHMARK(RendererClear)
+{
+	Target target;
+	state.setItems(256 * 256);
+
+	while (state.next()) {
+		target.renderer.clear();
+	}
+}
+
+BENCHMARK(RendererSetDrawColor)
+{
+	Target target;
+	Uint8 shade = 0;
+
+	while (state.next()) {
+		target.renderer.setDrawColor(shade++, 0, 0, 255);
+	}
+}
+
+BENCHMARK(RendererDrawPoint)
+{
+	Target target;
+	int x = 0;
+
+	while (state.next()) {
+		x = (x + 1) & 255;
+		target.renderer.drawPoint(x, x);
+	}
+}
+
+BENCHMARK(RendererDrawLine)
+{
+	Target target;
+	int x = 0;
+	state.setItems(256);
+
+	while (state.next()) {
+		x = (x + 1) & 255;
+		target.renderer.drawLine(x, 0, 255 - x, 255);
+	}
+}
+
+BENCHMARK(RendererDrawLines64)
+{
+	Target target;
+	std::vector<SDL_Point> points(64);
+
+	for (int i = 0; i < 64; i++) {
+		points[i].x = i * 4;
+		points[i].y = (i & 1) ? 0 : 255;
+	}
+
+	state.setItems(63);
+
+	while (state.next()) {
+		target.renderer.drawLines(points);
+	}
+}
+
+BENCHMARK(RendererDrawRect)
+{
+	Target target;
+	int x = 0;
+
+	while (state.next()) {
+		x = (x + 1) & 127;
+		target.renderer.drawRect(x, x, 64, 64);
+	}
+}
+
+BENCHMARK(RendererFillRect32)
+{
+	Target target;
+	int x = 0;
+	state.setItems(32 * 32);
+
+	while (state.next()) {
+		x = (x + 1) & 127;
+		target.renderer.fillRect(x, x, 32, 32);
+	}
+}
+
+BENCHMARK(RendererCopy32)
+{
+	Target target;
+	Surface tile(32, 32);
+	Texture texture;
+	texture.create(target.renderer.getHandle(), SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, 32, 32);
+	texture.updateTexture(nullptr, tile.getPixels(), tile.getPitch());
+
+	SDL_Rect dst = { 0, 0, 32, 32 };
+	state.setItems(32 * 32);
+
+	while (state.next()) {
+		dst.x = (dst.x + 32) & 255;
+		target.renderer.copy(texture, nullptr, &dst);
+	}
+
+	texture.destroy();
+}
@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "Surface.h"
+
+using namespace tiledl;
+using namespace tiledl::bench;
+
+BENCHMARK(SurfaceCreate64)
+{
+	while (state.next()) {
+		Surface surface(64, 64);
+		keep(surface);
+	}
+}
+
+BENCHMARK(SurfaceCreate512)
+{
+	while (state.next()) {
+		Surface surface(512, 512);
+		keep(surface);
+	}
+}
+
+BENCHMARK(SurfaceResize)
+{
+	Surface surface(64, 64);
+	bool grow = true;
+
+	while (state.next()) {
+		surface.resize(grow ? 128 : 64, grow ? 128 : 64);
+		grow = !grow;
+	}
+}
+
+BENCHMARK(SurfaceBlit64)
+{
+	Surface src(64, 64), dst(256, 256);
+	SDL_Rect to = { 0, 0, 64, 64 };
+	state.setItems(64 * 64);
+
+	while (state.next()) {
+		to.x = (to.x + 64) & 255;
+		SDL_BlitSurface(src.getHandle(), nullptr, dst.getHandle(), &to);
+	}
+}
+
+BENCHMARK(SurfaceBlitScaled)
+{
+	Surface src(64, 64), dst(256, 256);
+	state.setItems(256 * 256);
+
+	while (state.next()) {
+		SDL_BlitScaled(src.getHandle(), nullptr, dst.getHandle(), nullptr);
+	}
+}
+
+BENCHMARK(SurfaceSaveBMP)
+{
+	Surface surface(64, 64);
+	std::vector<char> buffer(64 * 64 * 4 + 1024);
+	state.setItems(64 * 64);
+
+	while (state.next()) {
+		surface.SaveBMP(SDL_RWFromMem(&buffer[0], buffer.size()), true);
+	}
+}
+
+BENCHMARK(SurfaceSavePNG)
+{
+	Surface surface(64, 64);
+	std::vector<char> buffer(64 * 64 * 4 + 1024);
+	state.setItems(64 * 64);
+
+	while (state.next()) {
+		surface.SavePNG(SDL_RWFromMem(&buffer[0], buffer.size()), true);
+	}
+}
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Compare tiledlBench results against a stored baseline.
+
+Both files are the output of `tiledlBench --format=json` or
+`tiledlBench --format=csv`. Exits with 1 if any benchmark's median
+is slower than the baseline by more than the threshold.
+
+    ./tiledlBench --format=json > baseline.json
+    ./tiledlBench --format=json > current.json
+    python3 bench/compare.py baseline.json current.json --threshold 0.10
+"""
+
+import argparse
+import csv
+import json
+import sys
+
+
+def load(path):
+    """Return {name: median_ns} from a JSON or CSV result file"""
+    with open(path) as f:
+        text = f.read()
+
+    if text.lstrip().startswith('{'):
+        rows = json.loads(text)['benchmarks']
+    else:
+        rows = csv.DictReader(text.splitlines())
+
+    return {row['name']: float(row['median_ns']) for row in rows}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help='allowed slowdown as a fraction, default 0.10')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+
+    print('%-32s %14s %14s %9s' % ('name', 'baseline ns', 'current ns', 'change'))
+
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            print('%-32s %14.2f %14s %9s' % (name, baseline[name], '-', 'removed'))
+            continue
+
+        if name not in baseline:
+            print('%-32s %14s %14.2f %9s' % (name, '-', current[name], 'new'))
+            continue
+
+        change = (current[name] - baseline[name]) / baseline[name] if baseline[name] > 0 else 0.0
+        mark = ''
+
+        if change > args.threshold:
+            mark = '  REGRESSED'
+            regressions += 1
+
+        print('%-32s %14.2f %14.2f %+8.1f%%%s' % (name, baseline[name], current[name], change * 100, mark))
+
+    if regressions:
+        print('%d benchmark(s) slower than the baseline by more than %.0f%%' % (regressions, args.threshold * 100))
+        return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
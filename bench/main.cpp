@@ -0,0 +1,101 @@
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "Benchmark.h"
+
+using namespace tiledl::bench;
+
+static void printUsage()
+{
+	std::printf("Usage: tiledlBench [--format=table|csv|json] [--filter=NAME] [--min-time=SECONDS] [--runs=N]\n");
+}
+
+static void writeTable(const std::vector<Result>& results)
+{
+	std::printf("%-32s %14s %14s %14s %12s %16s\n", "name", "median ns", "min ns", "max ns", "iterations", "items/s");
+
+	for (const Result& result : results) {
+		std::printf("%-32s %14.2f %14.2f %14.2f %12llu %16.0f\n",
+		            result.name.c_str(), result.median, result.min, result.max,
+		            (unsigned long long)result.iterations, result.itemsPerSecond);
+	}
+}
+
+static void writeCsv(const std::vector<Result>& results)
+{
+	std::printf("name,median_ns,min_ns,max_ns,iterations,runs,items_per_second\n");
+
+	for (const Result& result : results) {
+		std::printf("%s,%.3f,%.3f,%.3f,%llu,%i,%.0f\n",
+		            result.name.c_str(), result.median, result.min, result.max,
+		            (unsigned long long)result.iterations, result.runs, result.itemsPerSecond);
+	}
+}
+
+static void writeJson(const std::vector<Result>& results)
+{
+	SDL_version linked;
+	SDL_GetVersion(&linked);
+
+	std::printf("{\n\t\"sdl\": \"%i.%i.%i\",\n\t\"benchmarks\": [", linked.major, linked.minor, linked.patch);
+
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result& result = results[i];
+		std::printf("%s\n\t\t{\"name\": \"%s\", \"median_ns\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, "
+		            "\"iterations\": %llu, \"runs\": %i, \"items_per_second\": %.0f}",
+		            (i > 0) ? "," : "", result.name.c_str(), result.median, result.min, result.max,
+		            (unsigned long long)result.iterations, result.runs, result.itemsPerSecond);
+	}
+
+	std::printf("\n\t]\n}\n");
+}
+
+int main(int argc, char** argv)
+{
+	std::string format = "table";
+	std::string filter;
+	Runner runner;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+
+		if (std::strncmp(arg, "--format=", 9) == 0) {
+			format = arg + 9;
+		} else if (std::strncmp(arg, "--filter=", 9) == 0) {
+			filter = arg + 9;
+		} else if (std::strncmp(arg, "--min-time=", 11) == 0) {
+			runner.setMinTime(std::atof(arg + 11));
+		} else if (std::strncmp(arg, "--runs=", 7) == 0) {
+			runner.setRuns(std::atoi(arg + 7));
+		} else {
+			printUsage();
+			return (std::strcmp(arg, "--help") == 0) ? 0 : 1;
+		}
+	}
+
+	if (format != "table" && format != "csv" && format != "json") {
+		printUsage();
+		return 1;
+	}
+
+	// The renderer benchmarks draw with a software renderer, so no display is needed
+	if (SDL_Init(SDL_INIT_EVENTS) != 0) {
+		SDL_Log("Could not init SDL with SDL_INIT_EVENTS : %s", SDL_GetError());
+		return 1;
+	}
+
+	const std::vector<Result> results = runner.run(filter);
+
+	if (format == "csv") {
+		writeCsv(results);
+	} else if (format == "json") {
+		writeJson(results);
+	} else {
+		writeTable(results);
+	}
+
+	SDL_Quit();
+	return 0;
+}
@@ -9,4 +9,5 @@ rm -f Makefile
 rm -f Doxyfile
 
 rm -f tiledlTest
+rm -f tiledlBench
 rm -f libtiledl.so
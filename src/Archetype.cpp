@@ -0,0 +1,174 @@
+#include "Archetype.h"
+#include <algorithm>
+
+using namespace tiledl;
+
+static size_t align_up(size_t offset, size_t align)
+{
+	return (offset + align - 1) / align * align;
+}
+
+/**
+ * @param mask components of every entity in the archetype, all must be registered
+ */
+Archetype::Archetype(ComponentMask mask)
+{
+	this->mask = mask;
+	this->count = 0;
+
+	size_t rowSize = sizeof(Entity);
+
+	for (int component = 0; component < Components::MAX; component++) {
+		this->offsets[component] = 0;
+		this->sizes[component] = 0;
+		this->edges[component] = nullptr;
+
+		if (has(component)) {
+			this->components.push_back(component);
+			this->sizes[component] = Components::getInfo(component).size;
+			rowSize += this->sizes[component];
+		}
+	}
+
+	// Leave room for aligning every array
+	const size_t padding = (this->components.size() + 1) * alignof(std::max_align_t);
+	this->capacity = (int)std::max<size_t>(1, (CHUNK_BYTES - padding) / rowSize);
+
+	// The entities come first, then each component array
+	size_t offset = sizeof(Entity) * this->capacity;
+
+	for (int component : this->components) {
+		const ComponentInfo& info = Components::getInfo(component);
+		offset = align_up(offset, info.align);
+		this->offsets[component] = offset;
+		offset += info.size * this->capacity;
+	}
+
+	this->bytes = align_up(std::max<size_t>(offset, 1), sizeof(std::max_align_t));
+}
+
+Archetype::~Archetype()
+{
+	for (int chunk = 0; chunk < (int)this->chunks.size(); chunk++) {
+		for (int component : this->components) {
+			const ComponentInfo& info = Components::getInfo(component);
+			char* array = (char*)getArray(chunk, component);
+
+			for (int row = 0; row < this->chunks[chunk].count; row++) {
+				info.destroy(array + row * info.size);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Add a row for an entity, its components are left unconstructed
+ *
+ * @param chunk set to the chunk of the row
+ * @return the row in the chunk
+ */
+int Archetype::append(Entity entity, int& chunk)
+{
+	if (this->chunks.empty() || this->chunks.back().count == this->capacity) {
+		Chunk added;
+		added.memory = this->spare ? std::move(this->spare)
+		                           : std::unique_ptr<std::max_align_t[]>(
+		                                 new std::max_align_t[this->bytes / sizeof(std::max_align_t)]);
+		added.count = 0;
+		this->chunks.push_back(std::move(added));
+	}
+
+	chunk = (int)this->chunks.size() - 1;
+	const int row = this->chunks[chunk].count++;
+	((Entity*)this->chunks[chunk].memory.get())[row] = entity;
+	this->count++;
+	return row;
+}
+
+/**
+ * @brief Remove a row, the last entity of the archetype is moved into it
+ *
+ * @param destroy false if the components have already been moved out of the row
+ * @param moved set to the entity moved into the row
+ * @return true if an entity was moved
+ */
+bool Archetype::remove(int chunk, int row, bool destroy, Entity& moved)
+{
+	const int lastChunk = (int)this->chunks.size() - 1;
+	const int lastRow = this->chunks[lastChunk].count - 1;
+	const bool last = (chunk == lastChunk && row == lastRow);
+
+	for (int component : this->components) {
+		const ComponentInfo& info = Components::getInfo(component);
+
+		if (destroy) {
+			info.destroy(get(chunk, row, component));
+		}
+
+		if (!last) {
+			info.move(get(chunk, row, component), get(lastChunk, lastRow, component));
+		}
+	}
+
+	if (!last) {
+		Entity* entities = (Entity*)this->chunks[chunk].memory.get();
+		entities[row] = getEntities(lastChunk)[lastRow];
+		moved = entities[row];
+	}
+
+	if (--this->chunks[lastChunk].count == 0) {
+		this->spare = std::move(this->chunks[lastChunk].memory);
+		this->chunks.pop_back();
+	}
+
+	this->count--;
+	return !last;
+}
+
+/* ========= Getters =========*/
+
+ComponentMask Archetype::getMask() const
+{
+	return this->mask;
+}
+
+/**
+ * @return the component ids, in order
+ */
+const std::vector<int>& Archetype::getComponents() const
+{
+	return this->components;
+}
+
+int Archetype::getCount() const
+{
+	return this->count;
+}
+
+int Archetype::getChunkCount() const
+{
+	return (int)this->chunks.size();
+}
+
+/**
+ * @return most entities in one chunk
+ */
+int Archetype::getChunkCapacity() const
+{
+	return this->capacity;
+}
+
+/**
+ * @return the archetype with the component added or removed, nullptr if not known yet
+ */
+Archetype* Archetype::getEdge(int component) const
+{
+	return this->edges[component];
+}
+
+/* ========= Setters =========*/
+
+void Archetype::setEdge(int component, Archetype* archetype)
+{
+	this->edges[component] = archetype;
+}
@@ -0,0 +1,113 @@
+#ifndef ARCHETYPE_H_
+#define ARCHETYPE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include "Entity.h"
+
+namespace tiledl
+{
+	/**
+	 * Storage for every entity with exactly one set of components.
+	 *
+	 * Entities are kept in fixed size chunks, each holding an array of the
+	 * entities and one array per component side by side, so iterating a
+	 * component is a linear sweep through memory. Removing an entity moves
+	 * the last entity into its row, every chunk but the last stays full.
+	 */
+	class Archetype
+	{
+	public:
+		static const int CHUNK_BYTES = 16 * 1024;
+
+		Archetype(ComponentMask mask);
+		~Archetype();
+
+		int append(Entity entity, int& chunk);
+		bool remove(int chunk, int row, bool destroy, Entity& moved);
+
+		bool has(int component) const;
+		void* get(int chunk, int row, int component) const;
+		void* getArray(int chunk, int component) const;
+		const Entity* getEntities(int chunk) const;
+		int getChunkSize(int chunk) const;
+
+		// Getters
+		ComponentMask getMask() const;
+		const std::vector<int>& getComponents() const;
+		int getCount() const;
+		int getChunkCount() const;
+		int getChunkCapacity() const;
+		Archetype* getEdge(int component) const;
+
+		// Setters
+		void setEdge(int component, Archetype* archetype);
+
+	private:
+		Archetype(const Archetype&);
+		Archetype& operator=(const Archetype&);
+
+		struct Chunk {
+			std::unique_ptr<std::max_align_t[]> memory;
+			int count;
+		};
+
+		ComponentMask mask;
+		std::vector<int> components;
+		size_t offsets[Components::MAX]; // of each component array within a chunk
+		size_t sizes[Components::MAX];
+		size_t bytes;
+		int capacity;
+
+		std::vector<Chunk> chunks;
+		std::unique_ptr<std::max_align_t[]> spare; // last emptied chunk, saves reallocating at a boundary
+		int count;
+
+		Archetype* edges[Components::MAX]; // archetype with the component toggled
+	};
+
+	inline bool Archetype::has(int component) const
+	{
+		return (this->mask >> component) & 1;
+	}
+
+	/**
+	 * @return the component of an entity, nullptr if the archetype does not have it
+	 */
+	inline void* Archetype::get(int chunk, int row, int component) const
+	{
+		if (!has(component)) {
+			return nullptr;
+		}
+
+		return (char*)this->chunks[chunk].memory.get() + this->offsets[component] +
+		       row * this->sizes[component];
+	}
+
+	/**
+	 * @return the array of a component in a chunk, nullptr if the archetype does not have it
+	 */
+	inline void* Archetype::getArray(int chunk, int component) const
+	{
+		if (!has(component)) {
+			return nullptr;
+		}
+
+		return (char*)this->chunks[chunk].memory.get() + this->offsets[component];
+	}
+
+	inline const Entity* Archetype::getEntities(int chunk) const
+	{
+		return (const Entity*)this->chunks[chunk].memory.get();
+	}
+
+	inline int Archetype::getChunkSize(int chunk) const
+	{
+		return this->chunks[chunk].count;
+	}
+} // namespace tiledl
+
+#endif // ARCHETYPE_H_
@@ -0,0 +1,296 @@
+#include "Autotiler.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace tiledl;
+
+// Offsets of the neighbours in the order of their AutotileDirection bits
+static const int NEIGHBOURS[8][2] = {
+	{ 0, -1 }, { 1, -1 }, { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }
+};
+
+/**
+ * @brief Drop corners that are not between two connected edges, they cannot change the sprite
+ */
+static inline Uint8 reduce_mask(Uint8 mask)
+{
+	const Uint8 n = mask & AUTOTILE_NORTH, e = mask & AUTOTILE_EAST;
+	const Uint8 s = mask & AUTOTILE_SOUTH, w = mask & AUTOTILE_WEST;
+
+	if (!n || !e) {
+		mask &= ~AUTOTILE_NORTH_EAST;
+	}
+
+	if (!s || !e) {
+		mask &= ~AUTOTILE_SOUTH_EAST;
+	}
+
+	if (!s || !w) {
+		mask &= ~AUTOTILE_SOUTH_WEST;
+	}
+
+	if (!n || !w) {
+		mask &= ~AUTOTILE_NORTH_WEST;
+	}
+
+	return mask;
+}
+
+/**
+ * @brief Table from every 8 neighbour mask to its blob variant
+ *
+ * Variants are numbered in order of their reduced masks, so no connections
+ * is variant 0 and every connection is variant 46.
+ */
+static const Uint8* blob_table()
+{
+	static Uint8 table[256];
+	static bool built = [] {
+		Uint8 variants[256];
+		int count = 0;
+
+		for (int mask = 0; mask < 256; mask++) {
+			if (reduce_mask((Uint8)mask) == mask) {
+				variants[mask] = (Uint8)count++;
+			}
+		}
+
+		for (int mask = 0; mask < 256; mask++) {
+			table[mask] = variants[reduce_mask((Uint8)mask)];
+		}
+
+		return true;
+	}();
+
+	(void)built;
+	return table;
+}
+
+/**
+ * @param tiles the tiles to autotile, must outlive the Autotiler
+ * @param layer layer of tiles to autotile
+ * @param mode which neighbours are considered
+ */
+Autotiler::Autotiler(const TileStorage& tiles, int layer, AutotileMode mode)
+{
+	if ((unsigned)layer >= (unsigned)tiles.getLayerCount()) {
+		throw std::out_of_range("Autotiler layer is outside of the TileStorage");
+	}
+
+	this->tiles = &tiles;
+	this->layer = layer;
+	this->mode = mode;
+	this->edgeConnects = true;
+	rebuild();
+}
+
+Autotiler::~Autotiler()
+{
+
+}
+
+/**
+ * @brief Resolve every tile, marking every chunk dirty
+ */
+void Autotiler::rebuild()
+{
+	this->variants.resize(this->tiles->getWidth(), this->tiles->getHeight(), 1);
+	this->dirty.assign((size_t)this->variants.getChunksWide() * this->variants.getChunksHigh(), 0);
+	this->dirtyChunks.clear();
+
+	for (int y = 0; y < this->tiles->getHeight(); y++) {
+		for (int x = 0; x < this->tiles->getWidth(); x++) {
+			resolve(x, y, true);
+		}
+	}
+
+	this->variants.compact();
+}
+
+/**
+ * @brief Resolve the tiles affected by a change of a tile
+ *
+ * @note Call after every change to the layer
+ */
+void Autotiler::update(int x, int y)
+{
+	update(Rectangle(x, y, 1, 1));
+}
+
+/**
+ * @brief Resolve the tiles affected by a change of an area of tiles
+ */
+void Autotiler::update(const Rectangle& area)
+{
+	if (this->tiles->getWidth() != this->variants.getWidth() ||
+	    this->tiles->getHeight() != this->variants.getHeight()) {
+		rebuild();
+		return;
+	}
+
+	for (int y = area.y - 1; y <= area.y + area.h; y++) {
+		for (int x = area.x - 1; x <= area.x + area.w; x++) {
+			if (this->tiles->isInside(x, y)) {
+				bool edited = (x >= area.x && x < area.x + area.w && y >= area.y && y < area.y + area.h);
+				resolve(x, y, edited);
+			}
+		}
+	}
+}
+
+/**
+ * @param edited if the tile itself changed, its chunk is dirty even if the variant did not
+ */
+void Autotiler::resolve(int x, int y, bool edited)
+{
+	Uint8 variant = toVariant(getMask(x, y), this->mode);
+
+	if (variant != getVariant(x, y)) {
+		this->variants.set(0, x, y, variant);
+		markDirty(x, y);
+	} else if (edited) {
+		markDirty(x, y);
+	}
+}
+
+void Autotiler::markDirty(int x, int y)
+{
+	const int cx = x / TileChunk::SIZE;
+	const int cy = y / TileChunk::SIZE;
+	Uint8& flag = this->dirty[cy * this->variants.getChunksWide() + cx];
+
+	if (!flag) {
+		flag = 1;
+		this->dirtyChunks.push_back(Point(cx, cy));
+	}
+}
+
+Uint32 Autotiler::getGroup(Uint32 id) const
+{
+	if (this->groups.empty()) {
+		return id;
+	}
+
+	auto it = this->groups.find(id);
+	return (it == this->groups.end()) ? id : it->second;
+}
+
+bool Autotiler::connects(Uint32 group, int x, int y) const
+{
+	if (!this->tiles->isInside(x, y)) {
+		return this->edgeConnects;
+	}
+
+	return getGroup(this->tiles->get(this->layer, x, y)) == group;
+}
+
+/**
+ * @brief Get which neighbours a tile connects to
+ *
+ * @return AutotileDirection bits, only edges in AUTOTILE_4 mode
+ */
+Uint8 Autotiler::getMask(int x, int y) const
+{
+	const Uint32 group = getGroup(this->tiles->get(this->layer, x, y));
+	const int step = (this->mode == AUTOTILE_4) ? 2 : 1;
+	Uint8 mask = 0;
+
+	for (int i = 0; i < 8; i += step) {
+		if (connects(group, x + NEIGHBOURS[i][0], y + NEIGHBOURS[i][1])) {
+			mask |= (Uint8)(1 << i);
+		}
+	}
+
+	return mask;
+}
+
+int Autotiler::getVariantCount(AutotileMode mode)
+{
+	return (mode == AUTOTILE_4) ? 16 : 47;
+}
+
+/**
+ * @brief Convert a mask of AutotileDirection bits into a variant
+ *
+ * @return in AUTOTILE_4 mode north, east, south and west are bits 0 to 3,
+ *         in AUTOTILE_8 mode the blob variant from 0 to 46
+ */
+Uint8 Autotiler::toVariant(Uint8 mask, AutotileMode mode)
+{
+	if (mode == AUTOTILE_4) {
+		return (Uint8)(((mask & AUTOTILE_NORTH) ? 1 : 0) | ((mask & AUTOTILE_EAST) ? 2 : 0) |
+		               ((mask & AUTOTILE_SOUTH) ? 4 : 0) | ((mask & AUTOTILE_WEST) ? 8 : 0));
+	}
+
+	return blob_table()[mask];
+}
+
+bool Autotiler::isDirty(int cx, int cy) const
+{
+	if ((unsigned)cx >= (unsigned)this->variants.getChunksWide() ||
+	    (unsigned)cy >= (unsigned)this->variants.getChunksHigh()) {
+		return false;
+	}
+
+	return this->dirty[cy * this->variants.getChunksWide() + cx] != 0;
+}
+
+/**
+ * @brief Forget the dirty chunks, once their drawing was rebuilt
+ */
+void Autotiler::clearDirty()
+{
+	for (auto& chunk : this->dirtyChunks) {
+		this->dirty[chunk.y * this->variants.getChunksWide() + chunk.x] = 0;
+	}
+
+	this->dirtyChunks.clear();
+}
+
+/* ========= Getters =========*/
+
+AutotileMode Autotiler::getMode() const
+{
+	return this->mode;
+}
+
+int Autotiler::getLayer() const
+{
+	return this->layer;
+}
+
+/**
+ * @brief Get if tiles connect to the outside of the layer
+ */
+bool Autotiler::getEdgeConnects() const
+{
+	return this->edgeConnects;
+}
+
+/**
+ * @brief Get the chunks whose variants or tiles changed since clearDirty()
+ */
+const std::vector<Point>& Autotiler::getDirtyChunks() const
+{
+	return this->dirtyChunks;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @brief Make tiles of different ids connect to each other
+ *
+ * @note Call rebuild() after changing groups
+ */
+void Autotiler::setGroup(Uint32 id, Uint32 group)
+{
+	this->groups[id] = group;
+}
+
+/**
+ * @note Call rebuild() after changing this
+ */
+void Autotiler::setEdgeConnects(bool connects)
+{
+	this->edgeConnects = connects;
+}
@@ -0,0 +1,97 @@
+#ifndef AUTOTILER_H_
+#define AUTOTILER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <unordered_map>
+#include "TileStorage.h"
+#include "Rectangle.h"
+#include "Point.h"
+
+namespace tiledl
+{
+	enum AutotileMode {
+		AUTOTILE_4, // 16 variants from the edge neighbours
+		AUTOTILE_8  // 47 "blob" variants, corners only count between two connected edges
+	};
+
+	enum AutotileDirection {
+		AUTOTILE_NORTH = 1 << 0,
+		AUTOTILE_NORTH_EAST = 1 << 1,
+		AUTOTILE_EAST = 1 << 2,
+		AUTOTILE_SOUTH_EAST = 1 << 3,
+		AUTOTILE_SOUTH = 1 << 4,
+		AUTOTILE_SOUTH_WEST = 1 << 5,
+		AUTOTILE_WEST = 1 << 6,
+		AUTOTILE_NORTH_WEST = 1 << 7
+	};
+
+	/**
+	 * Picks the sprite variant of every tile of a layer from which of its
+	 * neighbours it connects to.
+	 *
+	 * The resolved variant of every tile is kept, palette compressed, so
+	 * drawing only reads it. After editing a tile, update() resolves just
+	 * that tile and its eight neighbours and marks the chunks whose variants
+	 * changed dirty so their cached drawing can be rebuilt.
+	 *
+	 * Tiles connect when they are in the same group, every id is its own
+	 * group unless setGroup() says otherwise.
+	 */
+	class Autotiler
+	{
+	public:
+		Autotiler(const TileStorage& tiles, int layer, AutotileMode mode);
+		~Autotiler();
+
+		void rebuild();
+		void update(int x, int y);
+		void update(const Rectangle& area);
+
+		Uint8 getVariant(int x, int y) const;
+		Uint8 getMask(int x, int y) const;
+
+		static int getVariantCount(AutotileMode mode);
+		static Uint8 toVariant(Uint8 mask, AutotileMode mode);
+
+		bool isDirty(int cx, int cy) const;
+		void clearDirty();
+
+		// Getters
+		AutotileMode getMode() const;
+		int getLayer() const;
+		bool getEdgeConnects() const;
+		const std::vector<Point>& getDirtyChunks() const;
+
+		// Setters
+		void setGroup(Uint32 id, Uint32 group);
+		void setEdgeConnects(bool connects);
+
+	private:
+		Uint32 getGroup(Uint32 id) const;
+		bool connects(Uint32 group, int x, int y) const;
+		void resolve(int x, int y, bool edited);
+		void markDirty(int x, int y);
+
+		const TileStorage* tiles;
+		int layer;
+		AutotileMode mode;
+		bool edgeConnects;
+		std::unordered_map<Uint32, Uint32> groups;
+
+		TileStorage variants;
+		std::vector<Uint8> dirty; // one flag per chunk
+		std::vector<Point> dirtyChunks;
+	};
+
+	/**
+	 * @return the variant of the tile, 0 outside of the layer
+	 */
+	inline Uint8 Autotiler::getVariant(int x, int y) const
+	{
+		return (Uint8)this->variants.get(0, x, y);
+	}
+} // namespace tiledl
+
+#endif // AUTOTILER_H_
@@ -0,0 +1,257 @@
+#include "Broadphase.h"
+#include <stdexcept>
+#include <algorithm>
+
+using namespace tiledl;
+
+static inline Uint64 pair_key(int a, int b)
+{
+	if (a > b) {
+		std::swap(a, b);
+	}
+
+	return ((Uint64)(Uint32)a << 32) | (Uint32)b;
+}
+
+/**
+ * @note Rectangles are treated as open intervals, so touching edges do not
+ * overlap, matching Rectangle::intersects.
+ */
+static inline bool overlaps(const Rectangle& a, const Rectangle& b)
+{
+	return (a.x < b.x + b.w && b.x < a.x + a.w &&
+	        a.y < b.y + b.h && b.y < a.y + a.h);
+}
+
+Broadphase::Broadphase()
+{
+	this->proxyCount = 0;
+}
+
+Broadphase::~Broadphase()
+{
+
+}
+
+inline void Broadphase::range_check(int proxy) const
+{
+	if (proxy < 0 || proxy >= (int)this->proxies.size() || !this->proxies[proxy].active) {
+		throw std::out_of_range("Broadphase proxy does not exist");
+	}
+}
+
+/**
+ * @brief Add a proxy to the broadphase
+ *
+ * @param bounds initial bounds of the proxy
+ * @return id of the proxy, ids of removed proxies are reused
+ * @note contacts with the new proxy are reported on the next update()
+ */
+int Broadphase::add(const Rectangle& bounds)
+{
+	int proxy;
+
+	if (!this->freeProxies.empty()) {
+		proxy = this->freeProxies.back();
+		this->freeProxies.pop_back();
+	} else {
+		proxy = (int)this->proxies.size();
+		this->proxies.push_back(Proxy());
+	}
+
+	this->proxies[proxy].bounds = bounds;
+	this->proxies[proxy].active = true;
+	this->proxyCount++;
+
+	// Appended endpoints are past every other proxy, so the proxy starts
+	// with no overlaps and the next sort reports its contacts as swaps
+	for (int axis = 0; axis < 2; axis++) {
+		Endpoint min = { 0, (Uint32)proxy << 1 };
+		Endpoint max = { 0, ((Uint32)proxy << 1) | 1 };
+		this->axes[axis].push_back(min);
+		this->axes[axis].push_back(max);
+	}
+
+	return proxy;
+}
+
+/**
+ * @brief Remove a proxy, reporting the end of all its contacts on the next update()
+ */
+void Broadphase::remove(int proxy)
+{
+	range_check(proxy);
+
+	for (auto it = this->pairs.begin(); it != this->pairs.end();) {
+		int a = (int)(*it >> 32);
+		int b = (int)(*it & 0xFFFFFFFF);
+
+		if (a == proxy || b == proxy) {
+			ContactEvent event = { CONTACT_END, a, b };
+			this->pending.push_back(event);
+			it = this->pairs.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	for (int axis = 0; axis < 2; axis++) {
+		auto& endpoints = this->axes[axis];
+		endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(), [proxy](const Endpoint & e) {
+			return (int)(e.data >> 1) == proxy;
+		}), endpoints.end());
+	}
+
+	this->proxies[proxy].active = false;
+	this->freeProxies.push_back(proxy);
+	this->proxyCount--;
+}
+
+/**
+ * @brief Set new bounds for a proxy
+ *
+ * @note The broadphase is only brought up to date on update()
+ */
+void Broadphase::move(int proxy, const Rectangle& bounds)
+{
+	range_check(proxy);
+	this->proxies[proxy].bounds = bounds;
+}
+
+/**
+ * @brief Remove all proxies and pairs without reporting any events
+ */
+void Broadphase::clear()
+{
+	this->proxies.clear();
+	this->freeProxies.clear();
+	this->axes[0].clear();
+	this->axes[1].clear();
+	this->pairs.clear();
+	this->events.clear();
+	this->pending.clear();
+	this->proxyCount = 0;
+}
+
+/**
+ * @brief Re-sort the endpoints against the current bounds and collect contact changes
+ *
+ * Insertion sort is linear on nearly sorted input, so a frame where little
+ * has moved costs O(n + swaps).
+ *
+ * @return the contacts that began or ended since the last update
+ */
+const std::vector<ContactEvent>& Broadphase::update()
+{
+	this->events.clear();
+	this->events.swap(this->pending);
+
+	for (auto& e : this->axes[0]) {
+		const Rectangle& bounds = this->proxies[e.data >> 1].bounds;
+		e.value = (e.data & 1) ? bounds.x + bounds.w : bounds.x;
+	}
+
+	for (auto& e : this->axes[1]) {
+		const Rectangle& bounds = this->proxies[e.data >> 1].bounds;
+		e.value = (e.data & 1) ? bounds.y + bounds.h : bounds.y;
+	}
+
+	sortAxis(this->axes[0]);
+	sortAxis(this->axes[1]);
+
+	return this->events;
+}
+
+/**
+ * @note At equal values max endpoints sort first, so touching edges are not an overlap
+ */
+static inline bool endpoint_less(int value, Uint32 data, int otherValue, Uint32 otherData)
+{
+	return value < otherValue || (value == otherValue && (data & 1) > (otherData & 1));
+}
+
+void Broadphase::sortAxis(std::vector<Endpoint>& axis)
+{
+	const int count = (int)axis.size();
+
+	for (int i = 1; i < count; i++) {
+		Endpoint key = axis[i];
+		int j = i;
+
+		while (j > 0 && endpoint_less(key.value, key.data, axis[j - 1].value, axis[j - 1].data)) {
+			const Endpoint& other = axis[j - 1];
+			int a = (int)(key.data >> 1);
+			int b = (int)(other.data >> 1);
+
+			if (a != b) {
+				bool keyMax = (key.data & 1) != 0;
+				bool otherMax = (other.data & 1) != 0;
+
+				if (!keyMax && otherMax) {
+					// A min endpoint passed a max endpoint: the intervals now overlap on this axis
+					if (overlaps(this->proxies[a].bounds, this->proxies[b].bounds)) {
+						addPair(a, b);
+					}
+				} else if (keyMax && !otherMax) {
+					// A max endpoint passed a min endpoint: the intervals separated
+					removePair(a, b);
+				}
+			}
+
+			axis[j] = other;
+			j--;
+		}
+
+		axis[j] = key;
+	}
+}
+
+void Broadphase::addPair(int a, int b)
+{
+	if (this->pairs.insert(pair_key(a, b)).second) {
+		ContactEvent event = { CONTACT_BEGIN, std::min(a, b), std::max(a, b) };
+		this->events.push_back(event);
+	}
+}
+
+void Broadphase::removePair(int a, int b)
+{
+	if (this->pairs.erase(pair_key(a, b)) != 0) {
+		ContactEvent event = { CONTACT_END, std::min(a, b), std::max(a, b) };
+		this->events.push_back(event);
+	}
+}
+
+/**
+ * @brief Checks if two proxies overlapped as of the last update()
+ */
+bool Broadphase::isOverlapping(int a, int b) const
+{
+	return this->pairs.count(pair_key(a, b)) != 0;
+}
+
+/* ========= Getters =========*/
+
+const Rectangle& Broadphase::getBounds(int proxy) const
+{
+	range_check(proxy);
+	return this->proxies[proxy].bounds;
+}
+
+/**
+ * @brief Get the events produced by the last update()
+ */
+const std::vector<ContactEvent>& Broadphase::getEvents() const
+{
+	return this->events;
+}
+
+int Broadphase::getProxyCount() const
+{
+	return this->proxyCount;
+}
+
+int Broadphase::getPairCount() const
+{
+	return (int)this->pairs.size();
+}
@@ -0,0 +1,76 @@
+#ifndef BROADPHASE_H_
+#define BROADPHASE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <unordered_set>
+#include "Rectangle.h"
+
+namespace tiledl
+{
+	enum ContactType {
+		CONTACT_BEGIN,
+		CONTACT_END
+	};
+
+	/**
+	 * A change in the overlap state of two proxies, a is always less than b
+	 */
+	struct ContactEvent {
+		ContactType type;
+		int a, b;
+	};
+
+	/**
+	 * Sort-and-sweep broadphase over Rectangle bounds.
+	 * Endpoints are kept sorted between updates so coherent scenes only pay
+	 * for the few swaps that actually happened since the last update.
+	 */
+	class Broadphase
+	{
+	public:
+		Broadphase();
+		~Broadphase();
+
+		int add(const Rectangle& bounds);
+		void remove(int proxy);
+		void move(int proxy, const Rectangle& bounds);
+		void clear();
+
+		const std::vector<ContactEvent>& update();
+
+		bool isOverlapping(int a, int b) const;
+
+		// Getters
+		const Rectangle& getBounds(int proxy) const;
+		const std::vector<ContactEvent>& getEvents() const;
+		int getProxyCount() const;
+		int getPairCount() const;
+
+	private:
+		struct Endpoint {
+			int value;
+			Uint32 data; // proxy << 1 | is max
+		};
+
+		struct Proxy {
+			Rectangle bounds;
+			bool active;
+		};
+
+		inline void range_check(int proxy) const;
+		void sortAxis(std::vector<Endpoint>& axis);
+		void addPair(int a, int b);
+		void removePair(int a, int b);
+
+		std::vector<Proxy> proxies;
+		std::vector<int> freeProxies;
+		std::vector<Endpoint> axes[2];
+		std::unordered_set<Uint64> pairs;
+		std::vector<ContactEvent> events, pending;
+		int proxyCount;
+	};
+} // namespace tiledl
+
+#endif // BROADPHASE_H_
@@ -0,0 +1,19 @@
+#ifndef CACHELINE_H_
+#define CACHELINE_H_
+#pragma once
+
+#include <cstddef>
+
+namespace tiledl
+{
+	/**
+	 * Bytes kept between values written by different threads so they never
+	 * share a cache line.
+	 *
+	 * Values are padded apart rather than aligned, the containers holding
+	 * them are allocated with plain new which ignores over-alignment.
+	 */
+	static const size_t CACHE_LINE = 64;
+} // namespace tiledl
+
+#endif // CACHELINE_H_
@@ -0,0 +1,44 @@
+#ifndef CHUNKSOURCE_H_
+#define CHUNKSOURCE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "TileChunk.h"
+#include "Point.h"
+
+namespace tiledl
+{
+	/**
+	 * Where a ChunkStreamer reads and writes the layers of world chunks.
+	 *
+	 * Called from the streaming thread only, never from two threads at once.
+	 */
+	class ChunkSource
+	{
+	public:
+		virtual ~ChunkSource() {}
+
+		/**
+		 * @param chunk position of the chunk in chunks
+		 * @param layers filled with one TileChunk per layer
+		 * @return false if the source has no such chunk
+		 */
+		virtual bool read(const Point& chunk, std::vector<TileChunk>& layers) = 0;
+
+		/**
+		 * @return false if the chunk could not be written
+		 */
+		virtual bool write(const Point& chunk, const std::vector<TileChunk>& layers) = 0;
+
+		/**
+		 * @return true if write() always fails, edits of its chunks are dropped with them
+		 */
+		virtual bool isReadOnly() const
+		{
+			return false;
+		}
+	};
+} // namespace tiledl
+
+#endif // CHUNKSOURCE_H_
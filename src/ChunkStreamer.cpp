@@ -0,0 +1,438 @@
+#include "ChunkStreamer.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+
+using namespace tiledl;
+
+static const size_t QUEUE_SIZE = 256;
+
+static inline Uint64 chunk_key(const Point& chunk)
+{
+	return ((Uint64)(Uint32)chunk.x << 32) | (Uint32)chunk.y;
+}
+
+static inline int floor_div(int a, int b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * @param source where chunks are read from and written to, must outlive the streamer
+ * @param layers number of layers in every chunk
+ * @throws std::runtime_error if the streaming thread could not be created
+ */
+ChunkStreamer::ChunkStreamer(ChunkSource& source, int layers) : requests(QUEUE_SIZE), results(QUEUE_SIZE), quitting(false)
+{
+	if (layers <= 0) {
+		throw std::invalid_argument("ChunkStreamer must have at least one layer");
+	}
+
+	this->source = &source;
+	this->readOnly = source.isReadOnly();
+	this->layers = layers;
+	this->loadRadius = 2;
+	this->keepRadius = 3;
+	this->centre = Point(0, 0);
+
+	this->wake = SDL_CreateSemaphore(0);
+	this->flushed = SDL_CreateSemaphore(0);
+	this->thread = nullptr;
+
+	if (this->wake != nullptr && this->flushed != nullptr) {
+		this->thread = SDL_CreateThread((SDL_ThreadFunction)([](void * ptr) -> int {
+			((ChunkStreamer*)(ptr))->workerLoop();
+			return 0;
+		}), "Chunk Streaming Thread", this);
+	}
+
+	// Nothing would answer requests, so the destructor could never finish
+	if (this->thread == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "ChunkStreamer (%p) : Failed to create streaming thread : %s",
+		             this, SDL_GetError());
+
+		if (this->wake != nullptr) {
+			SDL_DestroySemaphore(this->wake);
+		}
+
+		if (this->flushed != nullptr) {
+			SDL_DestroySemaphore(this->flushed);
+		}
+
+		throw std::runtime_error("Failed to create the chunk streaming thread");
+	}
+}
+
+/**
+ * @note Blocks until every modified chunk has been written
+ */
+ChunkStreamer::~ChunkStreamer()
+{
+	for (auto& it : this->loaded) {
+		if (it.second->modified) {
+			Request request = { REQUEST_WRITE, it.second->position, it.second.release() };
+			send(request);
+		}
+	}
+
+	this->loaded.clear();
+
+	// Loads still queued would fill the results with no one to take them
+	this->quitting = true;
+
+	Request quit = { REQUEST_QUIT, Point(0, 0), nullptr };
+	sendNow(quit);
+
+	if (this->thread != nullptr) {
+		SDL_WaitThread(this->thread, NULL);
+	}
+
+	Chunk* chunk;
+
+	while (this->results.pop(chunk)) {
+		delete chunk;
+	}
+
+	SDL_DestroySemaphore(this->flushed);
+	SDL_DestroySemaphore(this->wake);
+}
+
+void ChunkStreamer::workerLoop()
+{
+	while (true) {
+		SDL_SemWait(this->wake);
+
+		Request request;
+
+		while (this->requests.pop(request)) {
+			switch (request.type) {
+				case REQUEST_LOAD: {
+					if (this->quitting) {
+						break;
+					}
+
+					Chunk* chunk = new Chunk();
+					chunk->position = request.position;
+					chunk->modified = false;
+					chunk->failed = false;
+
+					// Chunks the source does not have start out empty
+					if (!this->source->read(request.position, chunk->layers)) {
+						chunk->layers.clear();
+					}
+
+					chunk->layers.resize(this->layers);
+					deliver(chunk);
+					break;
+				}
+
+				case REQUEST_WRITE:
+					if (this->source->write(request.position, request.chunk->layers)) {
+						delete request.chunk;
+					} else {
+						SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "ChunkStreamer (%p) : Failed to write chunk {%i,%i}",
+						             this, request.position.x, request.position.y);
+
+						// Hand it back so the changes are not lost
+						request.chunk->modified = true;
+						request.chunk->failed = true;
+						deliver(request.chunk);
+					}
+
+					break;
+
+				case REQUEST_FLUSH:
+					SDL_SemPost(this->flushed);
+					break;
+
+				case REQUEST_QUIT:
+					return;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Hand a chunk to the calling thread, waiting while the results are full
+ *
+ * @note Called from the streaming thread, the chunk is deleted if the streamer is being destroyed
+ */
+void ChunkStreamer::deliver(Chunk* chunk)
+{
+	while (!this->results.push(chunk)) {
+		if (this->quitting) {
+			delete chunk;
+			return;
+		}
+
+		SDL_Delay(1);
+	}
+}
+
+/**
+ * @brief Queue a request for the thread, keeping it for the next update() if the queue is full
+ */
+void ChunkStreamer::send(const Request& request)
+{
+	if (!this->backlog.empty() || !this->requests.push(request)) {
+		this->backlog.push_back(request);
+		return;
+	}
+
+	SDL_SemPost(this->wake);
+}
+
+/**
+ * @brief Queue a request for the thread after everything before it, waiting for space if needed
+ */
+void ChunkStreamer::sendNow(const Request& request)
+{
+	this->backlog.push_back(request);
+
+	for (size_t i = 0; i < this->backlog.size(); i++) {
+		while (!this->requests.push(this->backlog[i])) {
+			SDL_SemPost(this->wake);
+			SDL_Delay(1);
+			receive();
+		}
+	}
+
+	this->backlog.clear();
+	SDL_SemPost(this->wake);
+}
+
+/**
+ * @brief Take the chunks the thread finished loading and the ones it failed to write
+ *
+ * @note A chunk that failed to write stays loaded and modified, even
+ * outside the keep radius, until flush() writes it
+ */
+void ChunkStreamer::receive()
+{
+	Chunk* chunk;
+
+	while (this->results.pop(chunk)) {
+		const Uint64 key = chunk_key(chunk->position);
+		auto it = this->loaded.find(key);
+
+		if (!chunk->failed) {
+			this->requested.erase(key);
+		}
+
+		if (it != this->loaded.end()) {
+			// What is loaded is at least as new, flush() writes a copy
+			if (chunk->failed) {
+				it->second->modified = true;
+				it->second->failed = true;
+			}
+
+			delete chunk;
+		} else if (chunk->failed || isKept(chunk->position)) {
+			this->loaded[key].reset(chunk);
+		} else {
+			delete chunk;
+		}
+	}
+}
+
+bool ChunkStreamer::isKept(const Point& chunk) const
+{
+	return std::max(std::abs(chunk.x - this->centre.x), std::abs(chunk.y - this->centre.y)) <= this->keepRadius;
+}
+
+/**
+ * @brief Move the centre of the loaded area, call once a frame
+ *
+ * @param centre chunk to centre on, such as toChunk() of the camera's tile
+ */
+void ChunkStreamer::update(const Point& centre)
+{
+	this->centre = centre;
+
+	// Retry what did not fit last time, in order
+	size_t sent = 0;
+
+	while (sent < this->backlog.size() && this->requests.push(this->backlog[sent])) {
+		sent++;
+	}
+
+	if (sent > 0) {
+		this->backlog.erase(this->backlog.begin(), this->backlog.begin() + sent);
+		SDL_SemPost(this->wake);
+	}
+
+	receive();
+
+	// Drop chunks that are too far away
+	for (auto it = this->loaded.begin(); it != this->loaded.end();) {
+		if (isKept(it->second->position) || it->second->failed) {
+			it++;
+			continue;
+		}
+
+		if (it->second->modified) {
+			Request request = { REQUEST_WRITE, it->second->position, it->second.release() };
+			send(request);
+		}
+
+		it = this->loaded.erase(it);
+	}
+
+	// Request missing chunks, nearest first
+	std::vector<Point> missing;
+
+	for (int y = centre.y - this->loadRadius; y <= centre.y + this->loadRadius; y++) {
+		for (int x = centre.x - this->loadRadius; x <= centre.x + this->loadRadius; x++) {
+			Uint64 key = chunk_key(Point(x, y));
+
+			if (this->loaded.count(key) == 0 && this->requested.count(key) == 0) {
+				missing.push_back(Point(x, y));
+			}
+		}
+	}
+
+	std::sort(missing.begin(), missing.end(), [&centre](const Point & a, const Point & b) {
+		Point da = a - centre, db = b - centre;
+		return da.x * da.x + da.y * da.y < db.x * db.x + db.y * db.y;
+	});
+
+	for (auto& chunk : missing) {
+		Request request = { REQUEST_LOAD, chunk, nullptr };
+		this->requested.insert(chunk_key(chunk));
+		send(request);
+	}
+}
+
+/**
+ * @brief Write every modified chunk and wait for all queued requests to finish
+ *
+ * @note Blocks on I/O, meant for saving rather than every frame
+ */
+void ChunkStreamer::flush()
+{
+	for (auto& it : this->loaded) {
+		Chunk* chunk = it.second.get();
+
+		if (chunk->modified) {
+			Request request = { REQUEST_WRITE, chunk->position, new Chunk(*chunk) };
+			send(request);
+			chunk->modified = false;
+			chunk->failed = false;
+		}
+	}
+
+	Request request = { REQUEST_FLUSH, Point(0, 0), nullptr };
+	sendNow(request);
+
+	// Keep taking results, the thread cannot reach the flush while they are full
+	while (SDL_SemWaitTimeout(this->flushed, 1) != 0) {
+		receive();
+	}
+
+	receive();
+}
+
+/**
+ * @brief Get the chunk containing a tile
+ */
+Point ChunkStreamer::toChunk(int x, int y)
+{
+	return Point(floor_div(x, TileChunk::SIZE), floor_div(y, TileChunk::SIZE));
+}
+
+bool ChunkStreamer::isLoaded(const Point& chunk) const
+{
+	return this->loaded.count(chunk_key(chunk)) != 0;
+}
+
+/**
+ * @return the tile id, 0 if its chunk is not loaded
+ */
+Uint32 ChunkStreamer::get(int layer, int x, int y) const
+{
+	auto it = this->loaded.find(chunk_key(toChunk(x, y)));
+
+	if (it == this->loaded.end() || (unsigned)layer >= (unsigned)this->layers) {
+		return 0;
+	}
+
+	return it->second->layers[layer].get(x - floor_div(x, TileChunk::SIZE) * TileChunk::SIZE,
+	                                     y - floor_div(y, TileChunk::SIZE) * TileChunk::SIZE);
+}
+
+/**
+ * @brief Set a tile and mark its chunk to be written back when it is dropped
+ *
+ * @return false if the chunk of the tile is not loaded
+ * @note Edits of a read only source's chunks are lost when the chunk is dropped
+ */
+bool ChunkStreamer::set(int layer, int x, int y, Uint32 id)
+{
+	if ((unsigned)layer >= (unsigned)this->layers) {
+		throw std::out_of_range("Layer is outside of the ChunkStreamer");
+	}
+
+	auto it = this->loaded.find(chunk_key(toChunk(x, y)));
+
+	if (it == this->loaded.end()) {
+		return false;
+	}
+
+	it->second->layers[layer].set(x - floor_div(x, TileChunk::SIZE) * TileChunk::SIZE,
+	                              y - floor_div(y, TileChunk::SIZE) * TileChunk::SIZE, id);
+	it->second->modified = !this->readOnly;
+	return true;
+}
+
+/* ========= Getters =========*/
+
+/**
+ * @brief Get the layers of a loaded chunk
+ *
+ * @return null if the chunk is not loaded
+ * @note Changes made through the pointer are not written back unless set() is used
+ */
+std::vector<TileChunk>* ChunkStreamer::getChunk(const Point& chunk)
+{
+	auto it = this->loaded.find(chunk_key(chunk));
+	return (it == this->loaded.end()) ? nullptr : &it->second->layers;
+}
+
+int ChunkStreamer::getLoadRadius() const
+{
+	return this->loadRadius;
+}
+
+int ChunkStreamer::getKeepRadius() const
+{
+	return this->keepRadius;
+}
+
+int ChunkStreamer::getLoadedCount() const
+{
+	return (int)this->loaded.size();
+}
+
+/**
+ * @brief Get the number of chunks requested but not loaded yet
+ */
+int ChunkStreamer::getPendingCount() const
+{
+	return (int)this->requested.size();
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @param loadRadius chunks this close to the centre are loaded
+ * @param keepRadius chunks further than this are dropped, at least loadRadius
+ */
+void ChunkStreamer::setRadii(int loadRadius, int keepRadius)
+{
+	if (loadRadius < 0 || keepRadius < loadRadius) {
+		throw std::invalid_argument("ChunkStreamer keep radius must be at least the load radius");
+	}
+
+	this->loadRadius = loadRadius;
+	this->keepRadius = keepRadius;
+}
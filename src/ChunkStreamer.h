@@ -0,0 +1,104 @@
+#ifndef CHUNKSTREAMER_H_
+#define CHUNKSTREAMER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include "ChunkSource.h"
+#include "SpscQueue.h"
+#include "TileChunk.h"
+#include "Point.h"
+
+namespace tiledl
+{
+	/**
+	 * Keeps the chunks of a world around a moving centre loaded, reading and
+	 * writing them on a background thread.
+	 *
+	 * Every chunk within the load radius of the centre is requested, nearest
+	 * first, and chunks further than the keep radius are dropped, modified
+	 * ones being written back first. A chunk the source refuses to write
+	 * stays loaded until flush() retries it, chunks of a read only source are
+	 * never modified. The thread only talks to the calling
+	 * thread through two lock-free queues, so update() never waits on I/O.
+	 *
+	 * Radii are in chunks of TileChunk::SIZE tiles, measured along the
+	 * furthest axis so the loaded area is a square.
+	 */
+	class ChunkStreamer
+	{
+	public:
+		ChunkStreamer(ChunkSource& source, int layers);
+		~ChunkStreamer();
+
+		void update(const Point& centre);
+		void flush();
+
+		bool isLoaded(const Point& chunk) const;
+		Uint32 get(int layer, int x, int y) const;
+		bool set(int layer, int x, int y, Uint32 id);
+
+		static Point toChunk(int x, int y);
+
+		// Getters
+		std::vector<TileChunk>* getChunk(const Point& chunk);
+		int getLoadRadius() const;
+		int getKeepRadius() const;
+		int getLoadedCount() const;
+		int getPendingCount() const;
+
+		// Setters
+		void setRadii(int loadRadius, int keepRadius);
+
+	private:
+		struct Chunk {
+			Point position;
+			std::vector<TileChunk> layers;
+			bool modified;
+			bool failed; // the source refused the last write, kept loaded until flush() retries it
+		};
+
+		enum RequestType {
+			REQUEST_LOAD,
+			REQUEST_WRITE,
+			REQUEST_FLUSH,
+			REQUEST_QUIT
+		};
+
+		struct Request {
+			RequestType type;
+			Point position;
+			Chunk* chunk; // owned by the thread once sent
+		};
+
+		void workerLoop();
+		void deliver(Chunk* chunk);
+		void send(const Request& request);
+		void sendNow(const Request& request);
+		void receive();
+		bool isKept(const Point& chunk) const;
+
+		ChunkSource* source;
+		int layers;
+		int loadRadius, keepRadius;
+		Point centre;
+
+		std::unordered_map<Uint64, std::unique_ptr<Chunk>> loaded;
+		std::unordered_set<Uint64> requested;
+		std::vector<Request> backlog; // requests that did not fit in the queue yet
+
+		SpscQueue<Request> requests;
+		SpscQueue<Chunk*> results;
+		SDL_Thread* thread;
+		SDL_sem* wake;
+		SDL_sem* flushed;
+		std::atomic<bool> quitting; // the thread stops loading, nothing will receive them
+		bool readOnly; // of the source, set() edits without marking chunks modified
+	};
+} // namespace tiledl
+
+#endif // CHUNKSTREAMER_H_
@@ -0,0 +1,51 @@
+#include "CommandBuffer.h"
+
+using namespace tiledl;
+
+CommandBuffer::CommandBuffer()
+{
+
+}
+
+CommandBuffer::~CommandBuffer()
+{
+
+}
+
+void CommandBuffer::destroy(Entity entity)
+{
+	this->commands.push_back([entity](World& world) { world.destroy(entity); });
+}
+
+/**
+ * @brief Run every command in order, then clear them
+ *
+ * Commands recorded while playing back run in the same playback.
+ */
+void CommandBuffer::playback(World& world)
+{
+	// Commands may record more commands, so index instead of iterating
+	for (size_t i = 0; i < this->commands.size(); i++) {
+		std::function<void(World&)> command = std::move(this->commands[i]);
+		command(world);
+	}
+
+	this->commands.clear();
+}
+
+void CommandBuffer::clear()
+{
+	this->commands.clear();
+}
+
+/* ========= Getters =========*/
+
+int CommandBuffer::getCount() const
+{
+	return (int)this->commands.size();
+}
+
+bool CommandBuffer::isEmpty() const
+{
+	return this->commands.empty();
+}
@@ -0,0 +1,76 @@
+#ifndef COMMANDBUFFER_H_
+#define COMMANDBUFFER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <functional>
+#include "Entity.h"
+#include "World.h"
+
+namespace tiledl
+{
+	/**
+	 * Changes to the structure of a World, recorded to be played back later.
+	 *
+	 * Used to create, destroy and change entities while iterating, which
+	 * would otherwise move the rows being iterated. Commands run in the order
+	 * they were recorded, commands on an entity that is no longer alive by
+	 * then are skipped.
+	 */
+	class CommandBuffer
+	{
+	public:
+		CommandBuffer();
+		~CommandBuffer();
+
+		template<typename... T>
+		void create(const T&... components);
+		void destroy(Entity entity);
+		template<typename T>
+		void add(Entity entity, const T& value);
+		template<typename T>
+		void remove(Entity entity);
+
+		void playback(World& world);
+		void clear();
+
+		// Getters
+		int getCount() const;
+		bool isEmpty() const;
+
+	private:
+		std::vector<std::function<void(World&)>> commands;
+	};
+
+	/**
+	 * @brief Create an entity with components
+	 */
+	template<typename... T>
+	void CommandBuffer::create(const T&... components)
+	{
+		this->commands.push_back([components...](World& world) {
+			Entity entity = world.create();
+			int expand[] = { 0, (world.add(entity, components), 0)... };
+			(void)expand;
+		});
+	}
+
+	template<typename T>
+	void CommandBuffer::add(Entity entity, const T& value)
+	{
+		this->commands.push_back([entity, value](World& world) {
+			if (world.isAlive(entity)) {
+				world.add(entity, value);
+			}
+		});
+	}
+
+	template<typename T>
+	void CommandBuffer::remove(Entity entity)
+	{
+		this->commands.push_back([entity](World& world) { world.remove<T>(entity); });
+	}
+} // namespace tiledl
+
+#endif // COMMANDBUFFER_H_
@@ -0,0 +1,92 @@
+#include "DirectoryChunkSource.h"
+#include <cstdio>
+
+using namespace tiledl;
+
+static const Uint32 CHUNK_MAGIC = 0x43444C54; // "TLDC"
+static const Uint16 CHUNK_VERSION = 1;
+
+/**
+ * @param directory an existing directory to keep the chunk files in
+ */
+DirectoryChunkSource::DirectoryChunkSource(const char* directory)
+{
+	this->directory = directory;
+
+	if (!this->directory.empty() && this->directory.back() != '/' && this->directory.back() != '\\') {
+		this->directory += '/';
+	}
+}
+
+DirectoryChunkSource::~DirectoryChunkSource()
+{
+
+}
+
+std::string DirectoryChunkSource::getPath(const Point& chunk) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%i_%i.chunk", chunk.x, chunk.y);
+	return this->directory + name;
+}
+
+bool DirectoryChunkSource::read(const Point& chunk, std::vector<TileChunk>& layers)
+{
+	SDL_RWops* src = SDL_RWFromFile(getPath(chunk).c_str(), "rb");
+
+	if (src == nullptr) {
+		SDL_ClearError();
+		return false;
+	}
+
+	bool ok = (SDL_ReadLE32(src) == CHUNK_MAGIC && SDL_ReadLE16(src) == CHUNK_VERSION);
+	Uint16 count = SDL_ReadLE16(src);
+
+	if (ok) {
+		layers.resize(count);
+
+		for (int i = 0; ok && i < count; i++) {
+			ok = layers[i].read(src);
+		}
+	}
+
+	if (!ok) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "DirectoryChunkSource (%p) : Invalid chunk file %s",
+		             this, getPath(chunk).c_str()
+		            );
+	}
+
+	SDL_RWclose(src);
+	return ok;
+}
+
+bool DirectoryChunkSource::write(const Point& chunk, const std::vector<TileChunk>& layers)
+{
+	SDL_RWops* dst = SDL_RWFromFile(getPath(chunk).c_str(), "wb");
+
+	if (dst == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "DirectoryChunkSource (%p) : Failed to open %s : %s",
+		             this, getPath(chunk).c_str(), SDL_GetError()
+		            );
+		return false;
+	}
+
+	bool ok = (SDL_WriteLE32(dst, CHUNK_MAGIC) == 1 && SDL_WriteLE16(dst, CHUNK_VERSION) == 1 &&
+	           SDL_WriteLE16(dst, (Uint16)layers.size()) == 1);
+
+	for (size_t i = 0; ok && i < layers.size(); i++) {
+		ok = layers[i].write(dst);
+	}
+
+	if (!ok) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "DirectoryChunkSource (%p) : Failed to write %s : %s",
+		             this, getPath(chunk).c_str(), SDL_GetError()
+		            );
+	}
+
+	SDL_RWclose(dst);
+	return ok;
+}
@@ -0,0 +1,29 @@
+#ifndef DIRECTORYCHUNKSOURCE_H_
+#define DIRECTORYCHUNKSOURCE_H_
+#pragma once
+
+#include <string>
+#include "ChunkSource.h"
+
+namespace tiledl
+{
+	/**
+	 * Keeps every chunk in its own file, named by position, in a directory
+	 */
+	class DirectoryChunkSource : public ChunkSource
+	{
+	public:
+		DirectoryChunkSource(const char* directory);
+		~DirectoryChunkSource();
+
+		bool read(const Point& chunk, std::vector<TileChunk>& layers);
+		bool write(const Point& chunk, const std::vector<TileChunk>& layers);
+
+		std::string getPath(const Point& chunk) const;
+
+	private:
+		std::string directory;
+	};
+} // namespace tiledl
+
+#endif // DIRECTORYCHUNKSOURCE_H_
@@ -0,0 +1,48 @@
+#include "Entity.h"
+#include <atomic>
+#include <stdexcept>
+
+using namespace tiledl;
+
+static ComponentInfo infos[Components::MAX];
+static std::atomic<int> infoCount(0);
+static SDL_SpinLock infoLock = 0;
+
+/**
+ * @brief Register a component type
+ *
+ * @return the id of the type
+ */
+int Components::add(const ComponentInfo& info)
+{
+	// Systems may first use a type on a worker thread, the count is only
+	// published once the info is written so readers never see a torn entry
+	SDL_AtomicLock(&infoLock);
+	const int id = infoCount.load(std::memory_order_relaxed);
+
+	if (id >= MAX) {
+		SDL_AtomicUnlock(&infoLock);
+		throw std::length_error("Too many component types");
+	}
+
+	infos[id] = info;
+	infoCount.store(id + 1, std::memory_order_release);
+	SDL_AtomicUnlock(&infoLock);
+	return id;
+}
+
+/* ========= Getters =========*/
+
+const ComponentInfo& Components::getInfo(int id)
+{
+	if ((unsigned)id >= (unsigned)getCount()) {
+		throw std::out_of_range("Component id has not been registered");
+	}
+
+	return infos[id];
+}
+
+int Components::getCount()
+{
+	return infoCount.load(std::memory_order_acquire);
+}
@@ -0,0 +1,115 @@
+#ifndef ENTITY_H_
+#define ENTITY_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace tiledl
+{
+	/**
+	 * A handle to an entity of a World.
+	 *
+	 * The index is reused once the entity is destroyed, the generation is
+	 * not, so a handle kept past destroy() never finds the entity that took
+	 * its place. Generation 0 is never alive.
+	 */
+	struct Entity {
+		Uint32 index;
+		Uint32 generation;
+
+		Entity() : index(0), generation(0) {}
+		Entity(Uint32 index, Uint32 generation) : index(index), generation(generation) {}
+
+		bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const Entity& other) const { return !(*this == other); }
+	};
+
+	/**
+	 * One bit per component id
+	 */
+	typedef Uint64 ComponentMask;
+
+	/**
+	 * How to handle a component without knowing its type
+	 */
+	struct ComponentInfo {
+		size_t size;
+		size_t align;
+		void (*move)(void* dst, void* src); // move constructs dst from src, then destroys src
+		void (*destroy)(void* ptr);
+	};
+
+	/**
+	 * Gives every component type a small id the first time it is used.
+	 *
+	 * Ids are only stable within one run, never store them. const and
+	 * volatile are ignored, so a query for const T reads the T arrays.
+	 */
+	class Components
+	{
+	public:
+		static const int MAX = 64;
+
+		template<typename T>
+		static int id();
+		template<typename... T>
+		static ComponentMask mask();
+
+		static const ComponentInfo& getInfo(int id);
+		static int getCount();
+
+	private:
+		static int add(const ComponentInfo& info);
+
+		template<typename T>
+		static int typeId();
+		template<typename T>
+		static void moveComponent(void* dst, void* src);
+		template<typename T>
+		static void destroyComponent(void* ptr);
+	};
+
+	template<typename T>
+	inline int Components::id()
+	{
+		return typeId<typename std::remove_cv<T>::type>();
+	}
+
+	template<typename... T>
+	inline ComponentMask Components::mask()
+	{
+		ComponentMask mask = 0;
+		int expand[] = { 0, (mask |= (ComponentMask)1 << id<T>(), 0)... };
+		(void)expand;
+		return mask;
+	}
+
+	template<typename T>
+	int Components::typeId()
+	{
+		static_assert(alignof(T) <= alignof(std::max_align_t), "Components cannot be over aligned");
+
+		// Thread safe, every type registers once under the registry lock
+		static const int id = add({ sizeof(T), alignof(T), &moveComponent<T>, &destroyComponent<T> });
+		return id;
+	}
+
+	template<typename T>
+	void Components::moveComponent(void* dst, void* src)
+	{
+		new (dst) T(std::move(*(T*)src));
+		((T*)src)->~T();
+	}
+
+	template<typename T>
+	void Components::destroyComponent(void* ptr)
+	{
+		((T*)ptr)->~T();
+	}
+} // namespace tiledl
+
+#endif // ENTITY_H_
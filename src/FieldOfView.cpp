@@ -0,0 +1,229 @@
+#include "FieldOfView.h"
+#include <algorithm>
+#include <utility>
+
+using namespace tiledl;
+
+// Rows of the team map merged by one task
+static const int MERGE_ROWS = 32;
+
+static inline int floor_div(int a, int b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+static inline int ceil_div(int a, int b)
+{
+	return -floor_div(-a, b);
+}
+
+/**
+ * @param grid the grid to see through, must outlive the FieldOfView
+ */
+FieldOfView::FieldOfView(const TileGrid& grid)
+{
+	this->grid = &grid;
+	this->jobs = nullptr;
+}
+
+FieldOfView::~FieldOfView()
+{
+
+}
+
+/**
+ * @brief Get the tiles an observer could possibly see
+ */
+Rectangle FieldOfView::getArea(const Point& origin, int radius)
+{
+	return Rectangle(origin.x - radius, origin.y - radius, radius * 2 + 1, radius * 2 + 1);
+}
+
+/**
+ * @brief Mark the tiles visible from an origin
+ *
+ * @param origin tile to look from
+ * @param radius how many tiles can be seen in any direction
+ * @param visible map the size of the grid, only tiles within getArea() are set
+ * @note Nothing is cleared, so several origins can be computed into one map
+ */
+void FieldOfView::compute(const Point& origin, int radius, VisibilityMap& visible) const
+{
+	if (!this->grid->isInside(origin.x, origin.y) || radius < 0) {
+		return;
+	}
+
+	visible.set(origin.x, origin.y);
+
+	for (int quadrant = 0; quadrant < 4; quadrant++) {
+		Row row = { 1, -1, 1, 1, 1 };
+		scan(origin, quadrant, radius, row, visible);
+	}
+}
+
+/**
+ * @brief Scan a row of a quadrant and the rows behind it
+ *
+ * Rows are recursed into only as deep as the radius, so the stack stays small.
+ */
+void FieldOfView::scan(const Point& origin, int quadrant, int radius, Row row, VisibilityMap& visible) const
+{
+	if (row.depth > radius) {
+		return;
+	}
+
+	const int limit = radius * radius + radius;
+	const int minCol = floor_div(2 * row.depth * row.startNum + row.startDen, 2 * row.startDen);
+	const int maxCol = ceil_div(2 * row.depth * row.endNum - row.endDen, 2 * row.endDen);
+
+	// 0 - none, 1 - floor, 2 - wall
+	int previous = 0;
+
+	for (int col = minCol; col <= maxCol; col++) {
+		int x, y;
+
+		switch (quadrant) {
+			case 0:
+				x = origin.x + col;
+				y = origin.y - row.depth;
+				break;
+
+			case 1:
+				x = origin.x + row.depth;
+				y = origin.y + col;
+				break;
+
+			case 2:
+				x = origin.x + col;
+				y = origin.y + row.depth;
+				break;
+
+			default:
+				x = origin.x - row.depth;
+				y = origin.y + col;
+				break;
+		}
+
+		bool wall = this->grid->isOpaque(x, y);
+		bool symmetric = (col * row.startDen >= row.depth * row.startNum && col * row.endDen <= row.depth * row.endNum);
+
+		if ((wall || symmetric) && col * col + row.depth * row.depth <= limit && this->grid->isInside(x, y)) {
+			visible.set(x, y);
+		}
+
+		if (previous == 2 && !wall) {
+			row.startNum = 2 * col - 1;
+			row.startDen = 2 * row.depth;
+		}
+
+		if (previous == 1 && wall) {
+			Row next = row;
+			next.depth++;
+			next.endNum = 2 * col - 1;
+			next.endDen = 2 * row.depth;
+			scan(origin, quadrant, radius, next, visible);
+		}
+
+		previous = wall ? 2 : 1;
+	}
+
+	if (previous == 1) {
+		row.depth++;
+		scan(origin, quadrant, radius, row, visible);
+	}
+}
+
+/**
+ * @brief Compute what a team of observers can see together
+ *
+ * Each observer is computed into its own map, in parallel when a JobSystem
+ * is set, and the maps are merged into the team map.
+ *
+ * @param observers the observers of the team
+ * @param team filled with every tile any observer can see
+ * @return the area of the team map that changed since the last call, for
+ * passing to VisibilityMap::upload()
+ */
+Rectangle FieldOfView::compute(const std::vector<Observer>& observers, VisibilityMap& team)
+{
+	const int width = this->grid->getWidth();
+	const int height = this->grid->getHeight();
+	bool resized = false;
+
+	if (team.getWidth() != width || team.getHeight() != height) {
+		team.resize(width, height);
+		resized = true;
+	}
+
+	if (this->views.size() < observers.size()) {
+		this->views.resize(observers.size());
+		this->areas.resize(observers.size(), Rectangle(0, 0, 0, 0));
+	}
+
+	auto observe = [this, &observers, width, height](int i) {
+		VisibilityMap& view = this->views[i];
+
+		if (view.getWidth() != width || view.getHeight() != height) {
+			view.resize(width, height);
+		} else {
+			view.clear(this->areas[i]);
+		}
+
+		this->areas[i] = getArea(observers[i].position, observers[i].radius);
+		compute(observers[i].position, observers[i].radius, view);
+	};
+
+	auto merge = [this, &observers, &team, height](int band) {
+		int y0 = band * MERGE_ROWS;
+		int y1 = std::min(y0 + MERGE_ROWS, height);
+
+		for (size_t i = 0; i < observers.size(); i++) {
+			const Rectangle& area = this->areas[i];
+			int top = std::max(area.y, y0);
+			int bottom = std::min(area.y + area.h, y1);
+
+			if (top < bottom) {
+				team.merge(this->views[i], Rectangle(area.x, top, area.w, bottom - top));
+			}
+		}
+	};
+
+	const int bands = (height + MERGE_ROWS - 1) / MERGE_ROWS;
+
+	std::swap(this->previous, team);
+
+	if (team.getWidth() != width || team.getHeight() != height) {
+		team.resize(width, height);
+	} else {
+		team.clear();
+	}
+
+	if (this->jobs != nullptr) {
+		this->jobs->parallelFor((int)observers.size(), observe);
+		this->jobs->parallelFor(bands, merge);
+	} else {
+		for (int i = 0; i < (int)observers.size(); i++) {
+			observe(i);
+		}
+
+		for (int band = 0; band < bands; band++) {
+			merge(band);
+		}
+	}
+
+	if (resized || this->previous.getWidth() != width || this->previous.getHeight() != height) {
+		return Rectangle(0, 0, width, height);
+	}
+
+	return team.diff(this->previous);
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @brief Set the JobSystem observers are computed on, null computes them on the calling thread
+ */
+void FieldOfView::setJobSystem(JobSystem* jobs)
+{
+	this->jobs = jobs;
+}
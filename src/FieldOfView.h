@@ -0,0 +1,63 @@
+#ifndef FIELDOFVIEW_H_
+#define FIELDOFVIEW_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "TileGrid.h"
+#include "JobSystem.h"
+#include "VisibilityMap.h"
+#include "Point.h"
+#include "Rectangle.h"
+
+namespace tiledl
+{
+	/**
+	 * A tile that can see up to radius tiles around it
+	 */
+	struct Observer {
+		Point position;
+		int radius;
+	};
+
+	/**
+	 * Field of view over the opaque tiles of a TileGrid using symmetric
+	 * shadowcasting: a tile is visible from another exactly when the
+	 * second is visible from the first. Opaque tiles are visible themselves
+	 * but hide what is behind them.
+	 *
+	 * Slopes are kept as integer fractions, so results never depend on
+	 * floating point rounding.
+	 */
+	class FieldOfView
+	{
+	public:
+		FieldOfView(const TileGrid& grid);
+		~FieldOfView();
+
+		void compute(const Point& origin, int radius, VisibilityMap& visible) const;
+		Rectangle compute(const std::vector<Observer>& observers, VisibilityMap& team);
+
+		static Rectangle getArea(const Point& origin, int radius);
+
+		// Setters
+		void setJobSystem(JobSystem* jobs);
+
+	private:
+		struct Row {
+			int depth;
+			int startNum, startDen; // slopes as columns per row
+			int endNum, endDen;
+		};
+
+		void scan(const Point& origin, int quadrant, int radius, Row row, VisibilityMap& visible) const;
+
+		const TileGrid* grid;
+		JobSystem* jobs;
+		std::vector<VisibilityMap> views;
+		std::vector<Rectangle> areas;
+		VisibilityMap previous;
+	};
+} // namespace tiledl
+
+#endif // FIELDOFVIEW_H_
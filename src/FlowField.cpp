@@ -0,0 +1,433 @@
+#include "FlowField.h"
+#include "Pathfinder.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+using namespace tiledl;
+
+const Uint32 FlowField::INFINITE_COST;
+
+static const int DIRECTIONS[8][2] = {
+	{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+	{ 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 }
+};
+
+static const Sint8 NO_DIRECTION = -1;
+
+static inline bool open_entry_less(const Uint32 ag, const Uint32 bg)
+{
+	return ag > bg;
+}
+
+/**
+ * @param grid the grid to cover, must outlive the FlowField
+ */
+FlowField::FlowField(const TileGrid& grid)
+{
+	this->grid = &grid;
+	this->jobs = nullptr;
+	this->sectorSize = 16;
+	this->width = this->height = 0;
+	this->sectorsWide = this->sectorsHigh = 0;
+	this->version = 0;
+	this->rounds = 0;
+	this->limit = 0;
+}
+
+/**
+ * @param grid the grid to cover, must outlive the FlowField
+ * @param sectorSize width and height of a sector in tiles
+ */
+FlowField::FlowField(const TileGrid& grid, int sectorSize) : FlowField(grid)
+{
+	if (sectorSize < 1) {
+		throw std::invalid_argument("FlowField sector size must be positive");
+	}
+
+	this->sectorSize = sectorSize;
+}
+
+FlowField::~FlowField()
+{
+
+}
+
+/**
+ * @brief Compute the field towards a single goal tile
+ */
+void FlowField::compute(const Point& goal)
+{
+	compute(std::vector<Point>(1, goal));
+}
+
+/**
+ * @brief Compute the field towards the nearest of several goal tiles
+ *
+ * @note Solid goals and goals outside the grid are ignored, tiles that
+ * cannot reach any goal are left at INFINITE_COST with no direction
+ */
+void FlowField::compute(const std::vector<Point>& goals)
+{
+	prepare();
+
+	this->version = this->grid->getVersion();
+	this->rounds = 0;
+	std::fill(this->costs.begin(), this->costs.end(), INFINITE_COST);
+
+	std::vector<int> active;
+	std::vector<bool> queued(this->sectors.size(), false);
+
+	for (auto& sector : this->sectors) {
+		sector.openList.clear();
+		std::fill(sector.haloCosts.begin(), sector.haloCosts.end(), INFINITE_COST);
+	}
+
+	for (auto& goal : goals) {
+		if (this->grid->isSolid(goal.x, goal.y)) {
+			continue;
+		}
+
+		int s = (goal.y / this->sectorSize) * this->sectorsWide + goal.x / this->sectorSize;
+		open(this->sectors[s], goal.y * this->width + goal.x, 0);
+
+		if (!queued[s]) {
+			queued[s] = true;
+			active.push_back(s);
+		}
+	}
+
+	// Each round every active sector takes a snapshot of the costs around
+	// it, then settles its own tiles from that snapshot. Sectors only write
+	// their own tiles, so a round has no shared writes.
+	//
+	// Only tiles cheaper than the limit are expanded in a round, so the
+	// wavefront moves about half a sector per round and sectors are rarely
+	// relaxed again with better costs from a neighbour.
+	const Uint32 delta = (Uint32)this->sectorSize * Pathfinder::STRAIGHT_COST / 2;
+	this->limit = delta;
+
+	while (!active.empty()) {
+		this->rounds++;
+
+		run(active, &FlowField::gatherHalo);
+		run(active, &FlowField::relaxSector);
+
+		std::vector<int> changed;
+
+		for (int s : active) {
+			queued[s] = false;
+
+			if (this->sectors[s].changed) {
+				changed.push_back(s);
+			}
+		}
+
+		active.clear();
+
+		for (int s : changed) {
+			int sx = s % this->sectorsWide;
+			int sy = s / this->sectorsWide;
+
+			for (int y = std::max(sy - 1, 0); y <= std::min(sy + 1, this->sectorsHigh - 1); y++) {
+				for (int x = std::max(sx - 1, 0); x <= std::min(sx + 1, this->sectorsWide - 1); x++) {
+					int n = y * this->sectorsWide + x;
+
+					if (n != s && !queued[n]) {
+						queued[n] = true;
+						active.push_back(n);
+					}
+				}
+			}
+		}
+
+		Uint32 pending = INFINITE_COST;
+
+		for (auto& sector : this->sectors) {
+			if (!sector.openList.empty()) {
+				pending = std::min(pending, sector.openList.front().g);
+			}
+		}
+
+		if (pending == INFINITE_COST) {
+			continue;
+		}
+
+		this->limit = std::max(this->limit, pending) + delta;
+
+		for (int s = 0; s < (int)this->sectors.size(); s++) {
+			const Sector& sector = this->sectors[s];
+
+			if (!queued[s] && !sector.openList.empty() && sector.openList.front().g < this->limit) {
+				queued[s] = true;
+				active.push_back(s);
+			}
+		}
+	}
+
+	std::vector<int> all(this->sectors.size());
+
+	for (size_t i = 0; i < all.size(); i++) {
+		all[i] = (int)i;
+	}
+
+	run(all, &FlowField::buildDirections);
+}
+
+/**
+ * @brief Check if the field was computed against the current state of the grid
+ */
+bool FlowField::isCurrent() const
+{
+	return this->rounds > 0 && this->version == this->grid->getVersion() &&
+	       this->width == this->grid->getWidth() && this->height == this->grid->getHeight();
+}
+
+/**
+ * @brief (Re)build the sectors when the grid changed size
+ */
+void FlowField::prepare()
+{
+	if (this->width == this->grid->getWidth() && this->height == this->grid->getHeight() && !this->sectors.empty()) {
+		return;
+	}
+
+	this->width = this->grid->getWidth();
+	this->height = this->grid->getHeight();
+	this->sectorsWide = (this->width + this->sectorSize - 1) / this->sectorSize;
+	this->sectorsHigh = (this->height + this->sectorSize - 1) / this->sectorSize;
+
+	this->costs.assign((size_t)this->width * this->height, INFINITE_COST);
+	this->directions.assign((size_t)this->width * this->height, NO_DIRECTION);
+	this->sectors.assign((size_t)this->sectorsWide * this->sectorsHigh, Sector());
+
+	for (int sy = 0; sy < this->sectorsHigh; sy++) {
+		for (int sx = 0; sx < this->sectorsWide; sx++) {
+			Sector& sector = this->sectors[sy * this->sectorsWide + sx];
+			Rectangle& b = sector.bounds;
+			b = Rectangle(sx * this->sectorSize, sy * this->sectorSize,
+			              std::min(this->sectorSize, this->width - sx * this->sectorSize),
+			              std::min(this->sectorSize, this->height - sy * this->sectorSize));
+
+			// The ring of tiles just outside the sector
+			for (int y = b.y - 1; y <= b.y + b.h; y++) {
+				for (int x = b.x - 1; x <= b.x + b.w; x++) {
+					bool inside = (x >= b.x && y >= b.y && x < b.x + b.w && y < b.y + b.h);
+
+					if (!inside && this->grid->isInside(x, y)) {
+						sector.halo.push_back(y * this->width + x);
+					}
+				}
+			}
+
+			sector.haloCosts.resize(sector.halo.size());
+			sector.changed = false;
+		}
+	}
+}
+
+void FlowField::open(Sector& sector, int index, Uint32 g)
+{
+	if (g >= this->costs[index]) {
+		return;
+	}
+
+	this->costs[index] = g;
+	sector.changed = true;
+
+	OpenEntry entry = { g, index };
+	sector.openList.push_back(entry);
+	std::push_heap(sector.openList.begin(), sector.openList.end(), [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.g, b.g);
+	});
+}
+
+void FlowField::gatherHalo(Sector& sector)
+{
+	sector.haloChanged.clear();
+
+	for (size_t i = 0; i < sector.halo.size(); i++) {
+		Uint32 cost = this->costs[sector.halo[i]];
+
+		if (cost != sector.haloCosts[i]) {
+			sector.haloCosts[i] = cost;
+			sector.haloChanged.push_back((int)i);
+		}
+	}
+}
+
+/**
+ * @brief Dijkstra within one sector, seeded by its open list and the costs around it
+ *
+ * @note Tiles at or above the round's limit stay in the open list for a later round
+ */
+void FlowField::relaxSector(Sector& sector)
+{
+	const Rectangle& b = sector.bounds;
+	sector.changed = false;
+
+	auto inside = [&b](int x, int y) {
+		return (x >= b.x && y >= b.y && x < b.x + b.w && y < b.y + b.h);
+	};
+
+	// Only the tiles around the sector that improved since the last round can improve it
+	for (int i : sector.haloChanged) {
+		Uint32 g = sector.haloCosts[i];
+		int x = sector.halo[i] % this->width;
+		int y = sector.halo[i] / this->width;
+
+		for (int d = 0; d < 8; d++) {
+			int dx = DIRECTIONS[d][0];
+			int dy = DIRECTIONS[d][1];
+
+			if (inside(x + dx, y + dy) && canStep(x, y, dx, dy)) {
+				Uint32 step = (dx != 0 && dy != 0) ? Pathfinder::DIAGONAL_COST : Pathfinder::STRAIGHT_COST;
+				open(sector, sector.halo[i] + dy * this->width + dx, g + step);
+			}
+		}
+	}
+
+	auto compare = [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.g, b.g);
+	};
+
+	while (!sector.openList.empty() && sector.openList.front().g < this->limit) {
+		std::pop_heap(sector.openList.begin(), sector.openList.end(), compare);
+		OpenEntry entry = sector.openList.back();
+		sector.openList.pop_back();
+
+		// Entries are never removed from the heap, skip the outdated ones
+		if (entry.g != this->costs[entry.index]) {
+			continue;
+		}
+
+		int x = entry.index % this->width;
+		int y = entry.index / this->width;
+
+		for (int d = 0; d < 8; d++) {
+			int dx = DIRECTIONS[d][0];
+			int dy = DIRECTIONS[d][1];
+
+			if (inside(x + dx, y + dy) && canStep(x, y, dx, dy)) {
+				Uint32 step = (dx != 0 && dy != 0) ? Pathfinder::DIAGONAL_COST : Pathfinder::STRAIGHT_COST;
+				open(sector, entry.index + dy * this->width + dx, entry.g + step);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Point every tile of a sector along a shortest path to the goals
+ */
+void FlowField::buildDirections(Sector& sector)
+{
+	const Rectangle& b = sector.bounds;
+
+	for (int y = b.y; y < b.y + b.h; y++) {
+		for (int x = b.x; x < b.x + b.w; x++) {
+			int index = y * this->width + x;
+			Uint32 best = this->costs[index];
+			Sint8 direction = NO_DIRECTION;
+
+			// The neighbour the cost came from, so following directions walks a shortest path
+			if (best != INFINITE_COST && best != 0) {
+				for (int d = 0; d < 8; d++) {
+					int dx = DIRECTIONS[d][0];
+					int dy = DIRECTIONS[d][1];
+					Uint32 cost = getCost(x + dx, y + dy);
+					Uint32 step = (dx != 0 && dy != 0) ? Pathfinder::DIAGONAL_COST : Pathfinder::STRAIGHT_COST;
+
+					if (cost != INFINITE_COST && cost + step <= best && canStep(x, y, dx, dy)) {
+						best = cost + step;
+						direction = (Sint8)d;
+						break;
+					}
+				}
+			}
+
+			this->directions[index] = direction;
+		}
+	}
+}
+
+void FlowField::run(const std::vector<int>& sectors, void (FlowField::*task)(Sector&))
+{
+	if (this->jobs != nullptr) {
+		this->jobs->parallelFor((int)sectors.size(), [this, &sectors, task](int i) {
+			(this->*task)(this->sectors[sectors[i]]);
+		});
+	} else {
+		for (int s : sectors) {
+			(this->*task)(this->sectors[s]);
+		}
+	}
+}
+
+/* ========= Getters =========*/
+
+/**
+ * @brief Get the step to take from a tile towards the goals
+ *
+ * @return offset to the next tile, (0, 0) at a goal or where no goal can be reached
+ */
+Point FlowField::getDirection(int x, int y) const
+{
+	if ((unsigned)x >= (unsigned)this->width || (unsigned)y >= (unsigned)this->height) {
+		return Point(0, 0);
+	}
+
+	Sint8 direction = this->directions[y * this->width + x];
+
+	if (direction == NO_DIRECTION) {
+		return Point(0, 0);
+	}
+
+	return Point(DIRECTIONS[direction][0], DIRECTIONS[direction][1]);
+}
+
+/**
+ * @brief Get the unit direction to move in from a position in pixels
+ */
+Vector FlowField::getDirection(const Vector& position) const
+{
+	Point tile = this->grid->toTile(Point((int)std::floor(position.x), (int)std::floor(position.y)));
+	Point step = getDirection(tile.x, tile.y);
+
+	if (step.x != 0 && step.y != 0) {
+		const double diagonal = std::sqrt(0.5);
+		return Vector(step.x * diagonal, step.y * diagonal);
+	}
+
+	return Vector(step.x, step.y);
+}
+
+int FlowField::getSectorSize() const
+{
+	return this->sectorSize;
+}
+
+/**
+ * @brief Get the TileGrid version the field was last computed against
+ */
+Uint32 FlowField::getVersion() const
+{
+	return this->version;
+}
+
+/**
+ * @brief Get the number of sector relaxation rounds the last compute() took
+ */
+int FlowField::getRoundCount() const
+{
+	return this->rounds;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @brief Set the JobSystem sectors are relaxed on, null relaxes them on the calling thread
+ */
+void FlowField::setJobSystem(JobSystem* jobs)
+{
+	this->jobs = jobs;
+}
@@ -0,0 +1,109 @@
+#ifndef FLOWFIELD_H_
+#define FLOWFIELD_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "TileGrid.h"
+#include "JobSystem.h"
+#include "Point.h"
+#include "Vector.h"
+#include "Rectangle.h"
+
+namespace tiledl
+{
+	/**
+	 * Path costs from every tile of a TileGrid to the nearest of a set of
+	 * goal tiles, and the direction to step from each tile to follow them.
+	 *
+	 * Any number of units heading for the same goals only need one field,
+	 * and looking up a direction is a single array read.
+	 *
+	 * The grid is split into square sectors that are relaxed independently,
+	 * in parallel when a JobSystem is set, and repeated until no sector
+	 * changes. Costs and moves match Pathfinder.
+	 */
+	class FlowField
+	{
+	public:
+		static const Uint32 INFINITE_COST = 0xFFFFFFFF;
+
+		FlowField(const TileGrid& grid);
+		FlowField(const TileGrid& grid, int sectorSize);
+		~FlowField();
+
+		void compute(const Point& goal);
+		void compute(const std::vector<Point>& goals);
+
+		bool isCurrent() const;
+
+		// Getters
+		Uint32 getCost(int x, int y) const;
+		Point getDirection(int x, int y) const;
+		Vector getDirection(const Vector& position) const;
+		int getSectorSize() const;
+		Uint32 getVersion() const;
+		int getRoundCount() const;
+
+		// Setters
+		void setJobSystem(JobSystem* jobs);
+
+	private:
+		struct OpenEntry {
+			Uint32 g;
+			Sint32 index;
+		};
+
+		struct Sector {
+			Rectangle bounds;
+			std::vector<Sint32> halo;
+			std::vector<Uint32> haloCosts;
+			std::vector<int> haloChanged;
+			std::vector<OpenEntry> openList;
+			bool changed;
+		};
+
+		void prepare();
+		bool canStep(int x, int y, int dx, int dy) const;
+		void open(Sector& sector, int index, Uint32 g);
+		void gatherHalo(Sector& sector);
+		void relaxSector(Sector& sector);
+		void buildDirections(Sector& sector);
+		void run(const std::vector<int>& sectors, void (FlowField::*task)(Sector&));
+
+		const TileGrid* grid;
+		JobSystem* jobs;
+		int sectorSize;
+		int width, height;
+		int sectorsWide, sectorsHigh;
+		std::vector<Sector> sectors;
+		std::vector<Uint32> costs;
+		std::vector<Sint8> directions;
+		Uint32 version;
+		Uint32 limit;
+		int rounds;
+	};
+
+	inline Uint32 FlowField::getCost(int x, int y) const
+	{
+		if ((unsigned)x >= (unsigned)this->width || (unsigned)y >= (unsigned)this->height) {
+			return INFINITE_COST;
+		}
+
+		return this->costs[y * this->width + x];
+	}
+
+	/**
+	 * @brief Check a move between neighbouring tiles is allowed, diagonals may not cut corners
+	 */
+	inline bool FlowField::canStep(int x, int y, int dx, int dy) const
+	{
+		if (this->grid->isSolid(x + dx, y + dy)) {
+			return false;
+		}
+
+		return (dx == 0 || dy == 0 || (!this->grid->isSolid(x + dx, y) && !this->grid->isSolid(x, y + dy)));
+	}
+} // namespace tiledl
+
+#endif // FLOWFIELD_H_
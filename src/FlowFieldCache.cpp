@@ -0,0 +1,120 @@
+#include "FlowFieldCache.h"
+#include <stdexcept>
+
+using namespace tiledl;
+
+static inline Uint64 goal_key(const Point& goal)
+{
+	return ((Uint64)(Uint32)goal.x << 32) | (Uint32)goal.y;
+}
+
+/**
+ * @param grid the grid fields are computed on, must outlive the cache
+ * @param capacity the most fields kept at once
+ */
+FlowFieldCache::FlowFieldCache(const TileGrid& grid, int capacity)
+{
+	if (capacity < 1) {
+		throw std::invalid_argument("FlowFieldCache capacity must be positive");
+	}
+
+	this->grid = &grid;
+	this->jobs = nullptr;
+	this->capacity = capacity;
+	this->clock = 0;
+	this->computed = 0;
+}
+
+FlowFieldCache::~FlowFieldCache()
+{
+
+}
+
+/**
+ * @brief Get the field towards a goal tile, computing it if it is missing or out of date
+ *
+ * @note The reference is valid until the next call to get() or invalidate()
+ */
+const FlowField& FlowFieldCache::get(const Point& goal)
+{
+	Uint64 key = goal_key(goal);
+	auto it = this->entries.find(key);
+
+	if (it == this->entries.end()) {
+		if ((int)this->entries.size() >= this->capacity) {
+			evict();
+		}
+
+		Entry entry;
+		entry.field.reset(new FlowField(*this->grid));
+		entry.field->setJobSystem(this->jobs);
+		it = this->entries.emplace(key, std::move(entry)).first;
+	}
+
+	Entry& entry = it->second;
+	entry.lastUsed = ++this->clock;
+
+	if (!entry.field->isCurrent()) {
+		entry.field->compute(goal);
+		this->computed++;
+	}
+
+	return *entry.field;
+}
+
+/**
+ * @brief Drop every cached field
+ */
+void FlowFieldCache::invalidate()
+{
+	this->entries.clear();
+}
+
+void FlowFieldCache::evict()
+{
+	auto oldest = this->entries.begin();
+
+	for (auto it = this->entries.begin(); it != this->entries.end(); it++) {
+		if (it->second.lastUsed < oldest->second.lastUsed) {
+			oldest = it;
+		}
+	}
+
+	if (oldest != this->entries.end()) {
+		this->entries.erase(oldest);
+	}
+}
+
+/* ========= Getters =========*/
+
+int FlowFieldCache::getSize() const
+{
+	return (int)this->entries.size();
+}
+
+int FlowFieldCache::getCapacity() const
+{
+	return this->capacity;
+}
+
+/**
+ * @brief Get the number of fields computed since the cache was created
+ */
+int FlowFieldCache::getComputeCount() const
+{
+	return this->computed;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @brief Set the JobSystem new fields are computed on
+ */
+void FlowFieldCache::setJobSystem(JobSystem* jobs)
+{
+	this->jobs = jobs;
+
+	for (auto& it : this->entries) {
+		it.second.field->setJobSystem(jobs);
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef FLOWFIELDCACHE_H_
+#define FLOWFIELDCACHE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <unordered_map>
+#include "FlowField.h"
+
+namespace tiledl
+{
+	/**
+	 * Keeps the FlowFields of recently used goal tiles.
+	 *
+	 * A field is recomputed the next time it is requested after the grid
+	 * changed, and the least recently used field is dropped once the cache
+	 * is full.
+	 */
+	class FlowFieldCache
+	{
+	public:
+		FlowFieldCache(const TileGrid& grid, int capacity);
+		~FlowFieldCache();
+
+		const FlowField& get(const Point& goal);
+		void invalidate();
+
+		// Getters
+		int getSize() const;
+		int getCapacity() const;
+		int getComputeCount() const;
+
+		// Setters
+		void setJobSystem(JobSystem* jobs);
+
+	private:
+		struct Entry {
+			std::unique_ptr<FlowField> field;
+			Uint64 lastUsed;
+		};
+
+		void evict();
+
+		const TileGrid* grid;
+		JobSystem* jobs;
+		int capacity;
+		std::unordered_map<Uint64, Entry> entries;
+		Uint64 clock;
+		int computed;
+	};
+} // namespace tiledl
+
+#endif // FLOWFIELDCACHE_H_
@@ -0,0 +1,156 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace tiledl;
+
+static const double MIN_SPIN_MARGIN = 0.0005; // seconds
+
+FramePacer::FramePacer()
+{
+	this->frequency = SDL_GetPerformanceFrequency();
+	this->targetFps = 0;
+	this->interval = 0;
+	this->spinMargin = 0.002;
+	this->lateness = 0;
+	reset();
+}
+
+FramePacer::~FramePacer()
+{
+
+}
+
+/**
+ * @brief End a frame, waiting until the next one is due
+ *
+ * Call once per frame, after presenting it. Returns at once when uncapped.
+ */
+void FramePacer::wait()
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	if (this->interval > 0 && this->last != 0) {
+		if (now > this->deadline) {
+			// Missed, start over from now rather than rushing the frames after
+			this->missed++;
+			this->deadline = now;
+		} else {
+			const double remaining = (double)(this->deadline - now) / this->frequency;
+			const double sleep = remaining - this->spinMargin;
+
+			if (sleep >= 0.001) {
+				const Uint32 ms = (Uint32)(sleep * 1000);
+				SDL_Delay(ms);
+
+				// Learn how late sleeps wake, the margin covers the usual lateness
+				const Uint64 woke = SDL_GetPerformanceCounter();
+				const double late = std::max(0.0, (double)(woke - now) / this->frequency - ms / 1000.0);
+				this->lateness += (late - this->lateness) * 0.1;
+				this->spinMargin = std::max(MIN_SPIN_MARGIN, std::max(this->lateness * 2, late));
+				this->spinMargin = std::min(this->spinMargin, (double)this->interval / this->frequency / 2);
+			}
+
+			while ((now = SDL_GetPerformanceCounter()) < this->deadline) {
+				// Spin the last fraction
+			}
+		}
+
+		this->deadline += this->interval;
+	} else {
+		this->deadline = now + this->interval;
+	}
+
+	if (this->last != 0) {
+		const double frame = (double)(now - this->last) * 1000.0 / this->frequency;
+		this->frames++;
+
+		const double delta = frame - this->mean;
+		this->mean += delta / this->frames;
+		this->m2 += delta * (frame - this->mean);
+	}
+
+	this->last = now;
+}
+
+/**
+ * @brief Forget the last frame, such as after a pause, so the next wait() does not count as missed
+ */
+void FramePacer::reset()
+{
+	this->last = 0;
+	this->deadline = 0;
+	resetStats();
+}
+
+void FramePacer::resetStats()
+{
+	this->frames = 0;
+	this->missed = 0;
+	this->mean = 0;
+	this->m2 = 0;
+}
+
+/* ========= Getters =========*/
+
+int FramePacer::getTargetFps() const
+{
+	return this->targetFps;
+}
+
+/**
+ * @brief Get the number of frames timed since the stats were reset
+ */
+Uint64 FramePacer::getFrameCount() const
+{
+	return this->frames;
+}
+
+/**
+ * @brief Get the number of frames that ended after their deadline
+ */
+Uint64 FramePacer::getMissedCount() const
+{
+	return this->missed;
+}
+
+/**
+ * @return the mean time between frames in milliseconds
+ */
+double FramePacer::getFrameTimeMean() const
+{
+	return this->mean;
+}
+
+/**
+ * @return the variance of the time between frames in milliseconds squared
+ */
+double FramePacer::getFrameTimeVariance() const
+{
+	return (this->frames > 1) ? this->m2 / (this->frames - 1) : 0;
+}
+
+double FramePacer::getFrameTimeStdDev() const
+{
+	return std::sqrt(getFrameTimeVariance());
+}
+
+/**
+ * @return how long before a deadline sleeping stops and spinning starts, in seconds
+ */
+double FramePacer::getSpinMargin() const
+{
+	return this->spinMargin;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @param fps frames per second to hold to, 0 for uncapped
+ */
+void FramePacer::setTargetFps(int fps)
+{
+	this->targetFps = std::max(fps, 0);
+	this->interval = (this->targetFps > 0) ? this->frequency / this->targetFps : 0;
+	this->last = 0;
+}
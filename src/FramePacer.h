@@ -0,0 +1,56 @@
+#ifndef FRAMEPACER_H_
+#define FRAMEPACER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+
+namespace tiledl
+{
+	/**
+	 * Holds a loop to a target rate by waiting out the rest of each frame.
+	 *
+	 * SDL_Delay() sleeps for most of the wait, the last part is spun on the
+	 * performance counter because sleeps wake late by up to a scheduler
+	 * tick. How much to spin is learnt from how late the sleeps wake. Frames
+	 * that miss their deadline start the next frame from now instead of
+	 * rushing to catch up.
+	 */
+	class FramePacer
+	{
+	public:
+		FramePacer();
+		~FramePacer();
+
+		void wait();
+		void reset();
+		void resetStats();
+
+		// Getters
+		int getTargetFps() const;
+		Uint64 getFrameCount() const;
+		Uint64 getMissedCount() const;
+		double getFrameTimeMean() const;
+		double getFrameTimeVariance() const;
+		double getFrameTimeStdDev() const;
+		double getSpinMargin() const;
+
+		// Setters
+		void setTargetFps(int fps);
+
+	private:
+		int targetFps;
+		Uint64 frequency;
+		Uint64 interval; // in counter ticks, 0 if uncapped
+		Uint64 deadline; // counter value the current frame ends at
+		Uint64 last;     // counter value the last frame ended at, 0 before the first
+
+		double spinMargin; // seconds before the deadline to stop sleeping
+		double lateness;   // moving average of how late sleeps wake, in seconds
+
+		// Frame times in milliseconds, Welford's running mean and variance
+		Uint64 frames, missed;
+		double mean, m2;
+	};
+} // namespace tiledl
+
+#endif // FRAMEPACER_H_
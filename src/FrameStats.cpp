@@ -0,0 +1,304 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <stdexcept>
+#include <atomic>
+
+#ifdef TILEDL_COUNT_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+static std::atomic<Uint64> allocationCount(0);
+
+void* operator new(size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = std::malloc(size ? size : 1);
+
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+#endif
+
+using namespace tiledl;
+
+static const int DEFAULT_CAPACITY = 240;
+
+FrameStats::FrameStats()
+{
+	this->samples.resize(DEFAULT_CAPACITY);
+	this->graphScale = 33.3f;
+	clear();
+}
+
+/**
+ * @param capacity number of frames of history to keep
+ */
+FrameStats::FrameStats(int capacity)
+{
+	if (capacity <= 0) {
+		throw std::invalid_argument("FrameStats capacity must be greater than zero");
+	}
+
+	this->samples.resize(capacity);
+	this->graphScale = 33.3f;
+	clear();
+}
+
+FrameStats::~FrameStats()
+{
+
+}
+
+/**
+ * @brief Add the sample of a frame, replacing the oldest once full
+ */
+void FrameStats::record(const FrameSample& sample)
+{
+	this->samples[this->next] = sample;
+	this->next = (this->next + 1) % (int)this->samples.size();
+	this->count = std::min(this->count + 1, (int)this->samples.size());
+}
+
+void FrameStats::clear()
+{
+	this->next = 0;
+	this->count = 0;
+}
+
+/**
+ * @param age 0 for the newest sample, up to getCount() - 1 for the oldest
+ * @throws std::out_of_range if there is no sample that old
+ */
+const FrameSample& FrameStats::getSample(int age) const
+{
+	if ((unsigned)age >= (unsigned)this->count) {
+		throw std::out_of_range("FrameStats has no sample that old");
+	}
+
+	const int size = (int)this->samples.size();
+	return this->samples[(this->next - 1 - age + size) % size];
+}
+
+/**
+ * @return the mean of every field over the history, all zero if empty
+ */
+FrameSample FrameStats::getAverage() const
+{
+	double totals[7] = { 0 };
+
+	for (int age = 0; age < this->count; age++) {
+		const FrameSample& sample = getSample(age);
+		totals[0] += sample.frameTime;
+		totals[1] += sample.updateTime;
+		totals[2] += sample.renderTime;
+		totals[3] += sample.drawCalls;
+		totals[4] += sample.stateChanges;
+		totals[5] += sample.textureSwitches;
+		totals[6] += sample.allocations;
+	}
+
+	const double n = std::max(this->count, 1);
+	FrameSample average;
+	average.frameTime = (float)(totals[0] / n);
+	average.updateTime = (float)(totals[1] / n);
+	average.renderTime = (float)(totals[2] / n);
+	average.drawCalls = (Uint32)(totals[3] / n + 0.5);
+	average.stateChanges = (Uint32)(totals[4] / n + 0.5);
+	average.textureSwitches = (Uint32)(totals[5] / n + 0.5);
+	average.allocations = (Uint32)(totals[6] / n + 0.5);
+	return average;
+}
+
+/**
+ * @return the largest of every field over the history, all zero if empty
+ */
+FrameSample FrameStats::getMax() const
+{
+	FrameSample max = FrameSample();
+
+	for (int age = 0; age < this->count; age++) {
+		const FrameSample& sample = getSample(age);
+		max.frameTime = std::max(max.frameTime, sample.frameTime);
+		max.updateTime = std::max(max.updateTime, sample.updateTime);
+		max.renderTime = std::max(max.renderTime, sample.renderTime);
+		max.drawCalls = std::max(max.drawCalls, sample.drawCalls);
+		max.stateChanges = std::max(max.stateChanges, sample.stateChanges);
+		max.textureSwitches = std::max(max.textureSwitches, sample.textureSwitches);
+		max.allocations = std::max(max.allocations, sample.allocations);
+	}
+
+	return max;
+}
+
+/**
+ * @brief Count the frames in the history slower than a frame time
+ */
+int FrameStats::getSpikeCount(float frameTime) const
+{
+	int spikes = 0;
+
+	for (int age = 0; age < this->count; age++) {
+		spikes += getSample(age).frameTime > frameTime;
+	}
+
+	return spikes;
+}
+
+/**
+ * @brief Draw the history as a graph, oldest on the left
+ *
+ * The frame time is drawn in white, the update time in green and the
+ * render time in red over a translucent background, with a line at 60 and
+ * 30 frames per second. When allocations are counted, frames that
+ * allocated are marked in blue along the bottom. Leaves the draw colour
+ * changed, the blend mode is restored.
+ */
+void FrameStats::draw(Renderer& renderer, const Rectangle& area)
+{
+	if (area.w <= 0 || area.h <= 0) {
+		return;
+	}
+
+	const SDL_BlendMode blend = renderer.getBlendMode();
+	renderer.setBlendMode(SDL_BLENDMODE_BLEND);
+	renderer.setDrawColor(0, 0, 0, 160);
+	renderer.fillRect(area);
+	renderer.setBlendMode(blend);
+
+	const int bottom = area.y + area.h - 1;
+	const float pixelsPerMs = (area.h - 1) / this->graphScale;
+
+	// Budgets
+	renderer.setDrawColor(255, 255, 0, 255);
+
+	for (float budget : { 1000.0f / 60, 1000.0f / 30 }) {
+		if (budget <= this->graphScale) {
+			const int y = bottom - (int)(budget * pixelsPerMs);
+			renderer.drawLine(area.x, y, area.x + area.w - 1, y);
+		}
+	}
+
+	if (this->count == 0) {
+		return;
+	}
+
+	const int shown = std::min(this->count, area.w);
+	const float step = (shown > 1) ? (float)(area.w - 1) / (shown - 1) : 0;
+	const Uint8 colors[3][3] = { { 255, 255, 255 }, { 0, 255, 0 }, { 255, 0, 0 } };
+
+	for (int series = 0; series < 3; series++) {
+		this->points.resize(shown);
+
+		for (int i = 0; i < shown; i++) {
+			const FrameSample& sample = getSample(shown - 1 - i);
+			const float value = (series == 0) ? sample.frameTime : (series == 1) ? sample.updateTime : sample.renderTime;
+			const float height = std::min(std::max(value, 0.0f), this->graphScale) * pixelsPerMs;
+
+			this->points[i].x = area.x + (int)(i * step);
+			this->points[i].y = bottom - (int)height;
+		}
+
+		renderer.setDrawColor(colors[series][0], colors[series][1], colors[series][2], 255);
+
+		if (shown == 1) {
+			renderer.drawPoint(this->points[0]);
+		} else {
+			renderer.drawLines(this->points);
+		}
+	}
+
+	// Without counting every sample has 0 allocations, which would read as none made
+	if (!isCountingAllocations()) {
+		return;
+	}
+
+	this->points.clear();
+
+	for (int i = 0; i < shown; i++) {
+		if (getSample(shown - 1 - i).allocations > 0) {
+			SDL_Point point = { area.x + (int)(i * step), bottom };
+			this->points.push_back(point);
+		}
+	}
+
+	renderer.setDrawColor(0, 128, 255, 255);
+
+	for (const SDL_Point& point : this->points) {
+		renderer.drawPoint(point);
+	}
+}
+
+/**
+ * @brief Get the number of heap allocations made by the process so far
+ *
+ * @return the count, always 0 unless built with TILEDL_COUNT_ALLOCATIONS
+ */
+Uint64 FrameStats::getAllocationCount()
+{
+#ifdef TILEDL_COUNT_ALLOCATIONS
+	return allocationCount.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+bool FrameStats::isCountingAllocations()
+{
+#ifdef TILEDL_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+/* ========= Getters =========*/
+
+/**
+ * @brief Get the number of samples in the history
+ */
+int FrameStats::getCount() const
+{
+	return this->count;
+}
+
+int FrameStats::getCapacity() const
+{
+	return (int)this->samples.size();
+}
+
+float FrameStats::getGraphScale() const
+{
+	return this->graphScale;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @param milliseconds frame time at the top of the graph, longer times are clipped
+ */
+void FrameStats::setGraphScale(float milliseconds)
+{
+	if (milliseconds <= 0) {
+		throw std::invalid_argument("FrameStats graph scale must be greater than zero");
+	}
+
+	this->graphScale = milliseconds;
+}
@@ -0,0 +1,70 @@
+#ifndef FRAMESTATS_H_
+#define FRAMESTATS_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Renderer.h"
+#include "Rectangle.h"
+
+namespace tiledl
+{
+	/**
+	 * The measurements of one frame
+	 */
+	struct FrameSample {
+		float frameTime;  // milliseconds since the previous frame
+		float updateTime; // milliseconds of the last update tick
+		float renderTime; // milliseconds spent in render()
+		Uint32 drawCalls;
+		Uint32 stateChanges;    // draw colour and target changes
+		Uint32 textureSwitches; // copies from a different texture than the copy before
+		Uint32 allocations;     // heap allocations, 0 unless built with TILEDL_COUNT_ALLOCATIONS
+	};
+
+	/**
+	 * Keeps the samples of the last frames in a ring buffer and draws them
+	 * as an overlay graph.
+	 *
+	 * Recording a sample is a copy into the ring with no allocation or
+	 * logging, so it is cheap enough to leave on in release builds.
+	 */
+	class FrameStats
+	{
+	public:
+		FrameStats();
+		FrameStats(int capacity);
+		~FrameStats();
+
+		void record(const FrameSample& sample);
+		void clear();
+
+		const FrameSample& getSample(int age) const;
+		FrameSample getAverage() const;
+		FrameSample getMax() const;
+		int getSpikeCount(float frameTime) const;
+
+		void draw(Renderer& renderer, const Rectangle& area);
+
+		static Uint64 getAllocationCount();
+		static bool isCountingAllocations();
+
+		// Getters
+		int getCount() const;
+		int getCapacity() const;
+		float getGraphScale() const;
+
+		// Setters
+		void setGraphScale(float milliseconds);
+
+	private:
+		std::vector<FrameSample> samples;
+		int next;  // slot of the next sample
+		int count; // samples recorded, up to the capacity
+		float graphScale; // milliseconds at the top of the graph
+
+		std::vector<SDL_Point> points; // reused when drawing
+	};
+} // namespace tiledl
+
+#endif // FRAMESTATS_H_
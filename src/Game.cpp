@@ -1,14 +1,24 @@
 #include "Game.h"
 #include "Timer.h"
 #include <stdexcept>
+#include <cstdio>
 
 using namespace tiledl;
 
-Game::Game()
+Game::Game() : events(EVENT_QUEUE_CAPACITY), eventOverflows(0), frames(0), updateTime(0)
 {
+	headless = false;
+	dumpEvery = 0;
+	frameLimit = 0;
+	glcontex = nullptr;
 	inited = false;
+	quit = false;
 	inited_on = 0;
 	updateThread = nullptr;
+	hasPendingEvent = false;
+	eventTime = 0;
+	statsOverlay = false;
+	inputLock = SDL_CreateMutex();
 
 	background.r = background.g = background.b = background.a = 0;
 }
@@ -23,10 +33,17 @@ Game::~Game()
 			SDL_WaitThread(updateThread, NULL);
 		}
 
-		SDL_GL_DeleteContext(glcontex);
+		jobs.stop();
+
+		if (!headless) {
+			SDL_GL_DeleteContext(glcontex);
+		}
+
 		renderer.destroy();
 		window.destroy();
 	}
+
+	SDL_DestroyMutex(inputLock);
 }
 /**
  * @note Compares the renderer and the window pointers
@@ -107,6 +124,43 @@ int Game::init(const char* title, int width, int height, Uint32 windowFlags, int
 	return 0;
 }
 
+/**
+ * @brief Initialise without a window, rendering in software into a Surface
+ *
+ * No display or GPU is needed. The loops run uncapped, so call
+ * setFrameLimit() or set quit to end them.
+ *
+ * @return 0 on success, 2 if the renderer could not be created
+ */
+int Game::initHeadless(int width, int height)
+{
+	if (this->inited == true) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Game (%p): Already initialised", this);
+		return -1;
+	}
+
+	frame.reset(new Surface(width, height));
+
+	if (frame->isNull() || !renderer.initSW(frame->getHandle())) {
+		SDL_LogCritical(SDL_LOG_CATEGORY_ERROR, "Game (%p): Failed to create a software renderer. %s",
+		                this, SDL_GetError());
+		SDL_ClearError();
+		frame.reset();
+		return 2;
+	}
+
+	SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Game (%p): Created headless %ix%i renderer", this, width, height);
+
+	windowSettings.width = width;
+	windowSettings.height = height;
+	glcontex = nullptr;
+	headless = true;
+
+	inited_on = SDL_ThreadID();
+	inited = true;
+	return 0;
+}
+
 /**
  * @note Requires the Game to be init'd
  */
@@ -124,6 +178,11 @@ void Game::start()
 	applySettings();
 	quit = false;
 
+	// Workers for the update and render threads to share
+	if (!jobs.isRunning()) {
+		jobs.start();
+	}
+
 	// Create a Update Thread
 	updateThread = SDL_CreateThread((SDL_ThreadFunction)([](void * ptr) -> int {
 		((Game*)(ptr))->updateLoop();
@@ -146,20 +205,18 @@ void Game::updateLoop()
 
 	while (!quit) {
 		updatetimer.start();
+		const Uint64 updateStart = SDL_GetPerformanceCounter();
 
-		// Event Handling
-		SDL_PumpEvents();
-		SDL_Event event;
-
-		while (SDL_PollEvent(&event) && !quit) {
-			this->event(event);
-		}
+		// Event Handling, pumped by the render loop
+		handleEvents();
 
 		// General updates
 		{
 			update();
 		}
 
+		updateTime = (float)((SDL_GetPerformanceCounter() - updateStart) * 1000.0 / SDL_GetPerformanceFrequency());
+
 		const char* error = SDL_GetError();
 
 		if (*error != '\0') {
@@ -167,7 +224,9 @@ void Game::updateLoop()
 			SDL_ClearError();
 		}
 
+		// Headless too, an unpaced loop would spin a whole core
 		SDL_Delay(1); // HACK: temporary Update thread limiter, should have "Update per second" cap and boolean (like V-Sync)
+
 		updatetimer.stop();
 
 #ifdef DEBUG
@@ -181,13 +240,24 @@ void Game::updateLoop()
 void Game::renderLoop()
 {
 	Timer frametimer, rendertimer;
+	const double frequency = (double)SDL_GetPerformanceFrequency();
+	Uint64 frameStart = SDL_GetPerformanceCounter();
 
 	frametimer.start();
 
 	while (!quit) {
+		const Uint64 allocations = FrameStats::getAllocationCount();
+		// SDL only pumps events on the main thread on some platforms
+		pumpEvents();
+
+		// The update thread publishes while rendering, so render() reads a copy
+		SDL_LockMutex(inputLock);
+		frameInput = handoff;
+		SDL_UnlockMutex(inputLock);
 
 		//Rendering
 
+		const Uint64 renderStart = SDL_GetPerformanceCounter();
 		rendertimer.start();
 		{
 			//SDL_GL_MakeCurrent(window, glcontex); Makes rendered output flip and distort
@@ -196,17 +266,269 @@ void Game::renderLoop()
 			render();
 		}
 		rendertimer.stop(); // TODO: Should rendertimer include V-Sync times?
+		const Uint64 renderEnd = SDL_GetPerformanceCounter();
+		const RenderStats calls = renderer.getStats(); // before the overlay adds its own
+
+		if (statsOverlay) {
+			stats.draw(renderer, Rectangle(8, 8, stats.getCapacity(), 80));
+		}
+
 		renderer.present();
+		renderer.resetStats();
+
+		const Uint64 frame = ++frames;
+
+		if (headless && dumpEvery > 0 && frame % dumpEvery == 0) {
+			dumpFrame();
+		}
+
+		if (frameLimit > 0 && frame >= frameLimit) {
+			quit = true;
+		}
+
+		pacer.wait();
+
+		// Times the whole frame including pacing, spikes show up without logging
+		const Uint64 frameEnd = SDL_GetPerformanceCounter();
+		FrameSample sample = FrameSample();
+		sample.frameTime = (float)((frameEnd - frameStart) * 1000.0 / frequency);
+		sample.renderTime = (float)((renderEnd - renderStart) * 1000.0 / frequency);
+		sample.updateTime = updateTime;
+		sample.drawCalls = calls.getDrawCalls();
+		sample.stateChanges = calls.colorChanges + calls.targetChanges;
+		sample.textureSwitches = calls.textureSwitches;
+		sample.allocations = (Uint32)(FrameStats::getAllocationCount() - allocations);
+		stats.record(sample);
+		frameStart = frameEnd;
 
 #ifdef DEBUG
 		frametimer.stop();
-		SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, "Game (%p): : Frame Time : %g Render Time : %g",
-		               this, frametimer.getDeltas(), rendertimer.getDeltas());
+		SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, "Game (%p): : Frame Time : %g Render Time : %g Std Dev : %gms",
+		               this, frametimer.getDeltas(), rendertimer.getDeltas(), pacer.getFrameTimeStdDev());
 #endif
 		frametimer.start();
 	}
 }
 
+/**
+ * @brief Move the pending SDL events into the queue for the update thread
+ *
+ * @note Call from the main thread only. When the queue is full the rest
+ * of the events stay in SDL's queue until the next call.
+ */
+void Game::pumpEvents()
+{
+	SDL_PumpEvents();
+	const Uint64 now = SDL_GetPerformanceCounter();
+
+	while (true) {
+		if (!hasPendingEvent) {
+			if (SDL_PollEvent(&pendingEvent.event) == 0) {
+				break;
+			}
+
+			pendingEvent.time = now;
+			hasPendingEvent = true;
+		}
+
+		if (!events.push(pendingEvent)) {
+			eventOverflows++;
+			break;
+		}
+
+		hasPendingEvent = false;
+	}
+}
+
+/**
+ * @brief Call event() for the events queued by pumpEvents(), then publish the input of the tick
+ *
+ * At most one queue's worth is handled per call, so a flood of events
+ * cannot hold up the rest of the update. Every event is also folded into
+ * input, so motion can be read from its snapshot instead.
+ *
+ * @note Call from the update thread only, once per tick
+ */
+void Game::handleEvents()
+{
+	QueuedEvent queued;
+
+	for (size_t i = 0; i < events.getCapacity() && !quit && events.pop(queued); i++) {
+		recorder.record(queued);
+		dispatch(queued);
+	}
+
+	recorder.tick(SDL_GetPerformanceCounter());
+	publishInput();
+}
+
+void Game::dispatch(const QueuedEvent& queued)
+{
+	SDL_Event event = queued.event;
+	input.handle(event);
+
+	eventTime = queued.time;
+	this->event(event);
+}
+
+/**
+ * @brief Publish the input of the tick and hand a copy over for the next frame
+ */
+void Game::publishInput()
+{
+	const InputSnapshot& published = input.publish();
+
+	SDL_LockMutex(inputLock);
+	handoff = published;
+	SDL_UnlockMutex(inputLock);
+}
+
+/**
+ * @brief Record every handled event and tick into a log for replay()
+ *
+ * @note Call before start() or from the update thread
+ * @return true on success
+ */
+bool Game::startRecording(const char* path)
+{
+	return recorder.open(path);
+}
+
+void Game::stopRecording()
+{
+	recorder.close();
+}
+
+/**
+ * @brief Run update() once per tick of a recorded log, with its events, as fast as possible
+ *
+ * Nothing is rendered or pumped and the Game does not need to be
+ * initialised, so a long session replays in a fraction of the time for
+ * measuring update throughput. Stops early when quit is set.
+ *
+ * @return the number of ticks replayed, -1 if the log could not be opened
+ */
+int Game::replay(const char* path)
+{
+	InputReplay log;
+
+	if (!log.open(path)) {
+		return -1;
+	}
+
+	std::vector<QueuedEvent> tickEvents;
+	int ticks = 0;
+
+	while (!quit && log.readTick(tickEvents)) {
+		for (const QueuedEvent& queued : tickEvents) {
+			dispatch(queued);
+		}
+
+		publishInput();
+		update();
+		ticks++;
+	}
+
+	return ticks;
+}
+
+/**
+ * @brief Get the number of times pumpEvents() found the queue full
+ */
+Uint64 Game::getEventOverflowCount() const
+{
+	return eventOverflows.load();
+}
+
+void Game::dumpFrame()
+{
+	char name[32];
+	snprintf(name, sizeof(name), "frame_%06llu.png", (unsigned long long)frames.load());
+	const std::string path = dumpPrefix + name;
+
+	if (!frame->SavePNG(path.c_str())) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Game (%p): Failed to save frame %s", this, path.c_str());
+	}
+}
+
+bool Game::isHeadless() const
+{
+	return headless;
+}
+
+/**
+ * @brief Get the Surface rendered into when headless
+ *
+ * @return the surface, nullptr if not headless
+ */
+Surface* Game::getFrame()
+{
+	return frame.get();
+}
+
+/**
+ * @brief Get the number of frames presented by the render loop
+ */
+Uint64 Game::getFrameCount() const
+{
+	return frames.load();
+}
+
+/**
+ * @brief Save every nth headless frame as a PNG
+ *
+ * @param prefix directory and start of the file name, "frame_000001.png" is appended
+ * @param every frames between dumps, 0 to stop dumping
+ */
+void Game::setFrameDump(const std::string& prefix, int every)
+{
+	dumpPrefix = prefix;
+	dumpEvery = (every > 0) ? every : 0;
+}
+
+/**
+ * @brief Quit once the render loop has presented a number of frames
+ *
+ * @param frames the number of frames, 0 for no limit
+ */
+void Game::setFrameLimit(Uint64 frames)
+{
+	frameLimit = frames;
+}
+
+/**
+ * @brief Get the JobSystem shared by the Game's work, such as pathfinding and baking
+ *
+ * @note Running from start() on, before that jobs run on the thread that runs them
+ */
+JobSystem& Game::getJobs()
+{
+	return jobs;
+}
+
+/**
+ * @brief Get the samples of the last frames
+ *
+ * @note Written by the render loop, read from the main thread only
+ */
+const FrameStats& Game::getStats() const
+{
+	return stats;
+}
+
+bool Game::isStatsOverlay() const
+{
+	return statsOverlay;
+}
+
+/**
+ * @brief Draw the frame stats graph over the top left of every frame
+ */
+void Game::setStatsOverlay(bool enabled)
+{
+	statsOverlay = enabled;
+}
+
 void Game::render()
 {
 	throw std::runtime_error("Game::render is called");
@@ -248,7 +570,7 @@ void Game::applySettings()
  */
 void Game::applyWindowSettings()
 {
-	if (!inited) {
+	if (!inited || headless) {
 		return;
 	}
 
@@ -278,6 +600,12 @@ void Game::applyWindowSettings()
  */
 void Game::applyRenderSettings()
 {
+	pacer.setTargetFps(renderSettings.targetFps);
+
+	if (headless) {
+		return;
+	}
+
 	//FIXME: This should be only be run on the render(inited_on) thread
 	if (SDL_ThreadID() != inited_on) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
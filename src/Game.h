@@ -3,8 +3,18 @@
 #pragma once
 
 #include <SDL2/SDL.h>
+#include <atomic>
+#include <memory>
+#include <string>
 #include "Renderer.h"
 #include "Window.h"
+#include "Surface.h"
+#include "JobSystem.h"
+#include "SpscQueue.h"
+#include "InputState.h"
+#include "InputRecorder.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
 
 namespace tiledl
 {
@@ -38,16 +48,20 @@ namespace tiledl
 		bool doublebuffer = true;
 		bool antialias = false;
 		int samples = 0; // FIXME: Better name for Anti-Alias samples
+		int targetFps = 0; // render rate to pace to without V-Sync, 0 for uncapped
 	};
 
 	class Game
 	{
 	public:
+		static const int EVENT_QUEUE_CAPACITY = 1024;
+
 		Game();
 		~Game();
 		bool operator== (const Game& other) const;
 
 		int init(const char* title, int width, int height, Uint32 windowFlags, int deviceIndex, Uint32 rendererFlags);
+		int initHeadless(int width, int height);
 		void start();
 
 		virtual void render();
@@ -64,21 +78,70 @@ namespace tiledl
 		void renderLoop();
 		void updateLoop();
 
+		void pumpEvents();
+		void handleEvents();
+		Uint64 getEventOverflowCount() const;
+
+		bool isHeadless() const;
+		Surface* getFrame();
+		Uint64 getFrameCount() const;
+		void setFrameDump(const std::string& prefix, int every);
+		void setFrameLimit(Uint64 frames);
+
+		bool startRecording(const char* path);
+		void stopRecording();
+		int replay(const char* path);
+
+		JobSystem& getJobs();
+		const FrameStats& getStats() const;
+		bool isStatsOverlay() const;
+		void setStatsOverlay(bool enabled);
+
 	protected:
 		Renderer renderer;
 		Window window;
+		JobSystem jobs; // running between start() and the Game being destroyed
+		InputState input; // published once per update tick, read with input.getSnapshot() from the update thread
+		InputSnapshot frameInput; // the last published input, copied at the start of each frame for render()
+		FramePacer pacer; // paces the render loop to renderSettings.targetFps
+		FrameStats stats; // a sample per frame, recorded by the render loop
 		SDL_GLContext glcontex;
 
-		bool inited, quit;
+		bool inited;
+		std::atomic<bool> quit; // set from any thread, such as by the frame limit on the render thread
 		SDL_Color background;
 
 		WindowSettings windowSettings;
 		RenderSettings renderSettings;
 
 		SDL_threadID inited_on; // FIXME : Correct name
+		Uint64 eventTime; // time of the event being handled, SDL_GetPerformanceCounter() when it was pumped
+
 	private:
+		void dispatch(const QueuedEvent& queued);
+		void publishInput();
+		void dumpFrame();
+
 		SDL_Thread* updateThread;
 
+		SpscQueue<QueuedEvent> events; // from the main thread to the update thread
+		InputSnapshot handoff; // the last published input, guarded by inputLock
+		SDL_mutex* inputLock;
+		QueuedEvent pendingEvent;      // polled but not yet queued, the queue was full
+		bool hasPendingEvent;
+		std::atomic<Uint64> eventOverflows;
+		InputRecorder recorder;
+
+		bool headless;
+		std::unique_ptr<Surface> frame; // rendered into when headless
+		std::string dumpPrefix;
+		int dumpEvery; // frames between PNG dumps, 0 for none
+		Uint64 frameLimit; // quit after this many frames, 0 for no limit
+		std::atomic<Uint64> frames;
+
+		bool statsOverlay;
+		std::atomic<float> updateTime; // milliseconds of the last update tick
+
 	};
 } // namespace tiledl
 #endif // GAMEWINDOW_H
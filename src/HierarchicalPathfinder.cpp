@@ -0,0 +1,712 @@
+#include "HierarchicalPathfinder.h"
+#include "Pathfinder.h"
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+using namespace tiledl;
+
+static const Uint32 INFINITE_COST = std::numeric_limits<Uint32>::max();
+static const Sint32 NO_NODE = -1;
+static const Sint32 START_NODE = -2;
+static const Sint32 GOAL_NODE = -3;
+
+// Runs of open border at least this long get an entrance at each end
+static const int LONG_ENTRANCE = 6;
+
+// East, south, west, north
+static const int SIDES[4][2] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+
+static const int DIRECTIONS[8][2] = {
+	{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+	{ 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 }
+};
+
+static inline Sint32 node_id(int cluster, int local)
+{
+	return (cluster << 8) | local;
+}
+
+static inline bool open_entry_less(Uint32 af, Uint32 ag, Uint32 bf, Uint32 bg)
+{
+	return af > bf || (af == bf && ag < bg);
+}
+
+/**
+ * @param grid the grid to search, must outlive the HierarchicalPathfinder
+ * @param clusterSize width and height of a cluster in tiles, between 4 and 64
+ */
+HierarchicalPathfinder::HierarchicalPathfinder(const TileGrid& grid, int clusterSize)
+{
+	if (clusterSize < 4 || clusterSize > 64) {
+		throw std::invalid_argument("HierarchicalPathfinder cluster size must be between 4 and 64");
+	}
+
+	this->grid = &grid;
+	this->clusterSize = clusterSize;
+	this->width = this->height = 0;
+	this->clustersWide = this->clustersHigh = 0;
+	this->updatedClusters = 0;
+	this->localGeneration = 0;
+	this->generation = 0;
+	this->goalG = INFINITE_COST;
+	this->goalParent = NO_NODE;
+	this->pathCost = 0;
+
+	rebuild();
+}
+
+HierarchicalPathfinder::~HierarchicalPathfinder()
+{
+
+}
+
+/**
+ * @brief Rebuild every cluster from the current grid
+ */
+void HierarchicalPathfinder::rebuild()
+{
+	this->width = this->grid->getWidth();
+	this->height = this->grid->getHeight();
+	this->clustersWide = (this->width + this->clusterSize - 1) / this->clusterSize;
+	this->clustersHigh = (this->height + this->clusterSize - 1) / this->clusterSize;
+
+	this->clusters.assign((size_t)this->clustersWide * this->clustersHigh, Cluster());
+
+	for (int cy = 0; cy < this->clustersHigh; cy++) {
+		for (int cx = 0; cx < this->clustersWide; cx++) {
+			Cluster& cluster = this->clusters[cy * this->clustersWide + cx];
+			int x = cx * this->clusterSize;
+			int y = cy * this->clusterSize;
+			cluster.bounds = Rectangle(x, y, std::min(this->clusterSize, this->width - x),
+			                           std::min(this->clusterSize, this->height - y));
+			cluster.dirtyNodes = cluster.dirtyDistances = true;
+		}
+	}
+
+	LocalNode empty = { 0, 0, NO_NODE, false };
+	this->localNodes.assign((size_t)this->clusterSize * this->clusterSize, empty);
+	this->localGeneration = 0;
+	this->generation = 0;
+
+	flush();
+}
+
+/**
+ * @brief Recompute the clusters affected by a change to one tile
+ */
+void HierarchicalPathfinder::update(const Point& tile)
+{
+	update(Rectangle(tile.x, tile.y, 1, 1));
+}
+
+/**
+ * @brief Recompute the clusters affected by changes to an area of tiles
+ *
+ * @note If the grid was resized everything is rebuilt
+ */
+void HierarchicalPathfinder::update(const Rectangle& area)
+{
+	if (this->width != this->grid->getWidth() || this->height != this->grid->getHeight()) {
+		rebuild();
+		return;
+	}
+
+	int x0 = std::max(area.x, 0);
+	int y0 = std::max(area.y, 0);
+	int x1 = std::min(area.x + area.w, this->width);
+	int y1 = std::min(area.y + area.h, this->height);
+
+	for (int y = y0; y < y1; y++) {
+		for (int x = x0; x < x1; x++) {
+			markDirty(x, y);
+		}
+	}
+
+	flush();
+}
+
+int HierarchicalPathfinder::clusterIndex(const Point& tile) const
+{
+	return (tile.y / this->clusterSize) * this->clustersWide + tile.x / this->clusterSize;
+}
+
+/**
+ * @return index of the cluster next to a side of another, -1 at the edge of the grid
+ */
+int HierarchicalPathfinder::neighbour(int cluster, int side) const
+{
+	int cx = cluster % this->clustersWide + SIDES[side][0];
+	int cy = cluster / this->clustersWide + SIDES[side][1];
+
+	if (cx < 0 || cy < 0 || cx >= this->clustersWide || cy >= this->clustersHigh) {
+		return -1;
+	}
+
+	return cy * this->clustersWide + cx;
+}
+
+HierarchicalPathfinder::Node& HierarchicalPathfinder::getNode(Sint32 id)
+{
+	return this->clusters[id >> 8].nodes[id & 0xFF];
+}
+
+/**
+ * @brief Interior tiles only change the costs inside their cluster, border
+ * tiles also change the entrances shared with the neighbouring cluster
+ */
+void HierarchicalPathfinder::markDirty(int x, int y)
+{
+	int index = clusterIndex(Point(x, y));
+	Cluster& cluster = this->clusters[index];
+	const Rectangle& b = cluster.bounds;
+
+	cluster.dirtyDistances = true;
+
+	bool onSide[4] = {
+		x == b.x + b.w - 1,
+		y == b.y + b.h - 1,
+		x == b.x,
+		y == b.y
+	};
+
+	for (int side = 0; side < 4; side++) {
+		int other = neighbour(index, side);
+
+		if (onSide[side] && other >= 0) {
+			cluster.dirtyNodes = true;
+			this->clusters[other].dirtyNodes = true;
+			this->clusters[other].dirtyDistances = true;
+		}
+	}
+}
+
+void HierarchicalPathfinder::flush()
+{
+	const int count = (int)this->clusters.size();
+	this->updatedClusters = 0;
+
+	for (int i = 0; i < count; i++) {
+		if (this->clusters[i].dirtyNodes) {
+			buildNodes(i);
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (this->clusters[i].dirtyNodes) {
+			linkNodes(i);
+			this->clusters[i].dirtyNodes = false;
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (this->clusters[i].dirtyDistances) {
+			buildDistances(i);
+			this->clusters[i].dirtyDistances = false;
+			this->updatedClusters++;
+		}
+	}
+}
+
+void HierarchicalPathfinder::buildNodes(int cluster)
+{
+	this->clusters[cluster].nodes.clear();
+
+	for (int side = 0; side < 4; side++) {
+		if (neighbour(cluster, side) >= 0) {
+			addEntrances(cluster, side);
+		}
+	}
+
+	this->clusters[cluster].dirtyDistances = true;
+}
+
+/**
+ * @brief Add a node for every entrance on one side of a cluster
+ *
+ * Both clusters of a border walk it in the same order, so they always
+ * agree on where the entrances are.
+ */
+void HierarchicalPathfinder::addEntrances(int cluster, int side)
+{
+	Cluster& c = this->clusters[cluster];
+	const Rectangle& b = c.bounds;
+	const bool vertical = (SIDES[side][0] != 0);
+	const int length = vertical ? b.h : b.w;
+
+	auto cell = [&](int t) -> Point {
+		switch (side) {
+			case 0:
+				return Point(b.x + b.w - 1, b.y + t);
+			case 1:
+				return Point(b.x + t, b.y + b.h - 1);
+			case 2:
+				return Point(b.x, b.y + t);
+			default:
+				return Point(b.x + t, b.y);
+		}
+	};
+
+	auto open = [&](int t) -> bool {
+		Point inside = cell(t);
+		return !this->grid->isSolid(inside.x, inside.y) &&
+		       !this->grid->isSolid(inside.x + SIDES[side][0], inside.y + SIDES[side][1]);
+	};
+
+	auto add = [&](int t) {
+		if (c.nodes.size() >= 256) {
+			SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+			            "HierarchicalPathfinder (%p) : Too many entrances in cluster %i",
+			            this, cluster
+			           );
+			return;
+		}
+
+		Node node = { cell(t), side, NO_NODE, 0, 0, NO_NODE, false };
+		c.nodes.push_back(node);
+	};
+
+	int t = 0;
+
+	while (t < length) {
+		if (!open(t)) {
+			t++;
+			continue;
+		}
+
+		int start = t;
+
+		while (t < length && open(t)) {
+			t++;
+		}
+
+		int end = t - 1;
+
+		if (end - start + 1 >= LONG_ENTRANCE) {
+			add(start);
+			add(end);
+		} else {
+			add(start + (end - start) / 2);
+		}
+	}
+}
+
+/**
+ * @brief Link every node of a cluster with the node across the border, both ways
+ */
+void HierarchicalPathfinder::linkNodes(int cluster)
+{
+	Cluster& c = this->clusters[cluster];
+
+	for (int i = 0; i < (int)c.nodes.size(); i++) {
+		Node& node = c.nodes[i];
+		int other = neighbour(cluster, node.side);
+		Point target = node.tile + Point(SIDES[node.side][0], SIDES[node.side][1]);
+		int opposite = (node.side + 2) % 4;
+
+		node.mate = NO_NODE;
+
+		auto& nodes = this->clusters[other].nodes;
+
+		for (int j = 0; j < (int)nodes.size(); j++) {
+			if (nodes[j].side == opposite && nodes[j].tile == target) {
+				node.mate = node_id(other, j);
+				nodes[j].mate = node_id(cluster, i);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Compute the path cost between every pair of nodes within a cluster
+ */
+void HierarchicalPathfinder::buildDistances(int cluster)
+{
+	Cluster& c = this->clusters[cluster];
+	const int count = (int)c.nodes.size();
+
+	c.distances.assign((size_t)count * count, INFINITE_COST);
+
+	for (int i = 0; i < count; i++) {
+		localSearch(c.bounds, c.nodes[i].tile, nullptr);
+
+		for (int j = 0; j < count; j++) {
+			c.distances[i * count + j] = localCost(c.bounds, c.nodes[j].tile);
+		}
+	}
+}
+
+/* ========= Searches within one cluster =========*/
+
+bool HierarchicalPathfinder::localPassable(const Rectangle& bounds, int x, int y) const
+{
+	return (x >= bounds.x && y >= bounds.y && x < bounds.x + bounds.w && y < bounds.y + bounds.h &&
+	        !this->grid->isSolid(x, y));
+}
+
+/**
+ * @brief Search the tiles of one cluster
+ *
+ * @param to if null every reachable tile is costed, otherwise stops once it is reached
+ */
+void HierarchicalPathfinder::localSearch(const Rectangle& bounds, const Point& from, const Point* to)
+{
+	this->localGeneration++;
+
+	if (this->localGeneration == 0) {
+		for (auto& node : this->localNodes) {
+			node.generation = 0;
+		}
+
+		this->localGeneration = 1;
+	}
+
+	auto compare = [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.f, a.g, b.f, b.g);
+	};
+
+	this->localOpenList.clear();
+	localOpen(bounds, (from.y - bounds.y) * bounds.w + (from.x - bounds.x), NO_NODE, 0, to);
+
+	while (!this->localOpenList.empty()) {
+		std::pop_heap(this->localOpenList.begin(), this->localOpenList.end(), compare);
+		OpenEntry entry = this->localOpenList.back();
+		this->localOpenList.pop_back();
+
+		LocalNode& node = this->localNodes[entry.id];
+
+		if (node.closed || entry.g != node.g) {
+			continue;
+		}
+
+		node.closed = true;
+
+		const int x = bounds.x + entry.id % bounds.w;
+		const int y = bounds.y + entry.id / bounds.w;
+
+		if (to != nullptr && to->x == x && to->y == y) {
+			return;
+		}
+
+		for (int i = 0; i < 8; i++) {
+			int dx = DIRECTIONS[i][0];
+			int dy = DIRECTIONS[i][1];
+
+			if (!localPassable(bounds, x + dx, y + dy)) {
+				continue;
+			}
+
+			if (dx != 0 && dy != 0 && (!localPassable(bounds, x + dx, y) || !localPassable(bounds, x, y + dy))) {
+				continue;
+			}
+
+			Uint32 step = (dx != 0 && dy != 0) ? Pathfinder::DIAGONAL_COST : Pathfinder::STRAIGHT_COST;
+			localOpen(bounds, entry.id + dy * bounds.w + dx, entry.id, node.g + step, to);
+		}
+	}
+}
+
+void HierarchicalPathfinder::localOpen(const Rectangle& bounds, int index, int parent, Uint32 g, const Point* to)
+{
+	LocalNode& node = this->localNodes[index];
+
+	if (node.generation != this->localGeneration) {
+		node.generation = this->localGeneration;
+		node.g = INFINITE_COST;
+		node.parent = NO_NODE;
+		node.closed = false;
+	}
+
+	if (node.closed || g >= node.g) {
+		return;
+	}
+
+	node.g = g;
+	node.parent = parent;
+
+	Uint32 h = 0;
+
+	if (to != nullptr) {
+		h = Pathfinder::distance(Point(bounds.x + index % bounds.w, bounds.y + index / bounds.w), *to);
+	}
+
+	OpenEntry entry = { g + h, g, index };
+	this->localOpenList.push_back(entry);
+	std::push_heap(this->localOpenList.begin(), this->localOpenList.end(), [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.f, a.g, b.f, b.g);
+	});
+}
+
+/**
+ * @return cost to a tile found by the last localSearch(), INFINITE_COST if it was not reached
+ */
+Uint32 HierarchicalPathfinder::localCost(const Rectangle& bounds, const Point& tile) const
+{
+	const LocalNode& node = this->localNodes[(tile.y - bounds.y) * bounds.w + (tile.x - bounds.x)];
+
+	if (node.generation != this->localGeneration) {
+		return INFINITE_COST;
+	}
+
+	return node.g;
+}
+
+/* ========= Abstract search =========*/
+
+void HierarchicalPathfinder::openNode(Sint32 id, Sint32 parent, Uint32 g, const Point& goal)
+{
+	Node& node = getNode(id);
+
+	if (node.generation != this->generation) {
+		node.generation = this->generation;
+		node.g = INFINITE_COST;
+		node.parent = NO_NODE;
+		node.closed = false;
+	}
+
+	if (node.closed || g >= node.g) {
+		return;
+	}
+
+	node.g = g;
+	node.parent = parent;
+
+	OpenEntry entry = { g + Pathfinder::distance(node.tile, goal), g, id };
+	this->openList.push_back(entry);
+	std::push_heap(this->openList.begin(), this->openList.end(), [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.f, a.g, b.f, b.g);
+	});
+}
+
+void HierarchicalPathfinder::openGoal(Sint32 parent, Uint32 g)
+{
+	if (g >= this->goalG) {
+		return;
+	}
+
+	this->goalG = g;
+	this->goalParent = parent;
+
+	OpenEntry entry = { g, g, GOAL_NODE };
+	this->openList.push_back(entry);
+	std::push_heap(this->openList.begin(), this->openList.end(), [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.f, a.g, b.f, b.g);
+	});
+}
+
+/**
+ * @brief Find a path on the abstract graph
+ *
+ * @param path filled with the start, the entrances passed through and the goal
+ * @return true if a path was found, otherwise false and path is empty
+ * @note consecutive waypoints are within one cluster or either side of a border
+ */
+bool HierarchicalPathfinder::findAbstractPath(const Point& start, const Point& goal, std::vector<Point>& path)
+{
+	path.clear();
+	this->pathCost = 0;
+
+	if (this->width != this->grid->getWidth() || this->height != this->grid->getHeight()) {
+		rebuild();
+	}
+
+	if (this->grid->isSolid(start.x, start.y) || this->grid->isSolid(goal.x, goal.y)) {
+		return false;
+	}
+
+	this->generation++;
+
+	if (this->generation == 0) {
+		for (auto& cluster : this->clusters) {
+			for (auto& node : cluster.nodes) {
+				node.generation = 0;
+			}
+		}
+
+		this->generation = 1;
+	}
+
+	const int startCluster = clusterIndex(start);
+	const int goalCluster = clusterIndex(goal);
+	const Cluster& sc = this->clusters[startCluster];
+	const Cluster& gc = this->clusters[goalCluster];
+
+	this->openList.clear();
+	this->goalG = INFINITE_COST;
+	this->goalParent = NO_NODE;
+
+	// Connect the goal to the entrances of its cluster
+	localSearch(gc.bounds, goal, nullptr);
+	this->goalCosts.resize(gc.nodes.size());
+
+	for (size_t i = 0; i < gc.nodes.size(); i++) {
+		this->goalCosts[i] = localCost(gc.bounds, gc.nodes[i].tile);
+	}
+
+	// Connect the start to the entrances of its cluster, and the goal when they share one
+	localSearch(sc.bounds, start, nullptr);
+	this->startCosts.resize(sc.nodes.size());
+
+	for (size_t i = 0; i < sc.nodes.size(); i++) {
+		this->startCosts[i] = localCost(sc.bounds, sc.nodes[i].tile);
+	}
+
+	if (startCluster == goalCluster && localCost(sc.bounds, goal) != INFINITE_COST) {
+		openGoal(START_NODE, localCost(sc.bounds, goal));
+	}
+
+	for (size_t i = 0; i < sc.nodes.size(); i++) {
+		if (this->startCosts[i] != INFINITE_COST) {
+			openNode(node_id(startCluster, (int)i), START_NODE, this->startCosts[i], goal);
+		}
+	}
+
+	auto compare = [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.f, a.g, b.f, b.g);
+	};
+
+	while (!this->openList.empty()) {
+		std::pop_heap(this->openList.begin(), this->openList.end(), compare);
+		OpenEntry entry = this->openList.back();
+		this->openList.pop_back();
+
+		if (entry.id == GOAL_NODE) {
+			if (entry.g != this->goalG) {
+				continue;
+			}
+
+			this->pathCost = this->goalG;
+			path.push_back(goal);
+
+			for (Sint32 id = this->goalParent; id != START_NODE; id = getNode(id).parent) {
+				if (getNode(id).tile != path.back()) {
+					path.push_back(getNode(id).tile);
+				}
+			}
+
+			if (start != path.back()) {
+				path.push_back(start);
+			}
+
+			std::reverse(path.begin(), path.end());
+			return true;
+		}
+
+		Node& node = getNode(entry.id);
+
+		if (node.closed || entry.g != node.g) {
+			continue;
+		}
+
+		node.closed = true;
+
+		const int cluster = entry.id >> 8;
+		const int local = entry.id & 0xFF;
+		const Cluster& c = this->clusters[cluster];
+		const int count = (int)c.nodes.size();
+
+		if (cluster == goalCluster && this->goalCosts[local] != INFINITE_COST) {
+			openGoal(entry.id, node.g + this->goalCosts[local]);
+		}
+
+		if (node.mate != NO_NODE) {
+			openNode(node.mate, entry.id, node.g + Pathfinder::STRAIGHT_COST, goal);
+		}
+
+		for (int j = 0; j < count; j++) {
+			Uint32 cost = c.distances[local * count + j];
+
+			if (j != local && cost != INFINITE_COST) {
+				openNode(node_id(cluster, j), entry.id, node.g + cost, goal);
+			}
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Find a path and refine it to every tile from start to goal
+ *
+ * @param path filled with every tile from start to goal, inclusive
+ * @return true if a path was found, otherwise false and path is empty
+ */
+bool HierarchicalPathfinder::findPath(const Point& start, const Point& goal, std::vector<Point>& path)
+{
+	std::vector<Point> waypoints;
+
+	if (!findAbstractPath(start, goal, waypoints)) {
+		path.clear();
+		return false;
+	}
+
+	path.clear();
+	path.push_back(waypoints.front());
+
+	for (size_t i = 1; i < waypoints.size(); i++) {
+		const Point& from = waypoints[i - 1];
+		const Point& to = waypoints[i];
+		int cluster = clusterIndex(from);
+
+		// Waypoints in different clusters are the two tiles of an entrance
+		if (cluster != clusterIndex(to)) {
+			path.push_back(to);
+			continue;
+		}
+
+		const Rectangle& bounds = this->clusters[cluster].bounds;
+		localSearch(bounds, from, &to);
+
+		size_t end = path.size();
+		int index = (to.y - bounds.y) * bounds.w + (to.x - bounds.x);
+
+		while (this->localNodes[index].parent != NO_NODE) {
+			path.push_back(Point(bounds.x + index % bounds.w, bounds.y + index / bounds.w));
+			index = this->localNodes[index].parent;
+		}
+
+		std::reverse(path.begin() + end, path.end());
+	}
+
+	return true;
+}
+
+/* ========= Getters =========*/
+
+int HierarchicalPathfinder::getClusterSize() const
+{
+	return this->clusterSize;
+}
+
+int HierarchicalPathfinder::getClusterCount() const
+{
+	return (int)this->clusters.size();
+}
+
+int HierarchicalPathfinder::getNodeCount() const
+{
+	int count = 0;
+
+	for (auto& cluster : this->clusters) {
+		count += (int)cluster.nodes.size();
+	}
+
+	return count;
+}
+
+/**
+ * @brief Get the number of clusters recomputed by the last rebuild() or update()
+ */
+int HierarchicalPathfinder::getUpdatedClusterCount() const
+{
+	return this->updatedClusters;
+}
+
+/**
+ * @brief Get the cost of the last path found, in Pathfinder costs
+ */
+Uint32 HierarchicalPathfinder::getPathCost() const
+{
+	return this->pathCost;
+}
@@ -0,0 +1,113 @@
+#ifndef HIERARCHICALPATHFINDER_H_
+#define HIERARCHICALPATHFINDER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "TileGrid.h"
+#include "Point.h"
+#include "Rectangle.h"
+
+namespace tiledl
+{
+	/**
+	 * HPA* over the passable tiles of a TileGrid.
+	 *
+	 * The grid is split into square clusters. Entrances along every shared
+	 * cluster border become abstract nodes, linked across the border and to
+	 * each other inside a cluster by precomputed path costs. Long queries are
+	 * searched on this small graph and only refined to tiles inside the
+	 * clusters the path goes through.
+	 *
+	 * Call update() after changing tiles of the grid; only the clusters that
+	 * contain the change, and their neighbours when a border tile changed,
+	 * are recomputed.
+	 */
+	class HierarchicalPathfinder
+	{
+	public:
+		HierarchicalPathfinder(const TileGrid& grid, int clusterSize);
+		~HierarchicalPathfinder();
+
+		void rebuild();
+		void update(const Point& tile);
+		void update(const Rectangle& area);
+
+		bool findPath(const Point& start, const Point& goal, std::vector<Point>& path);
+		bool findAbstractPath(const Point& start, const Point& goal, std::vector<Point>& path);
+
+		// Getters
+		int getClusterSize() const;
+		int getClusterCount() const;
+		int getNodeCount() const;
+		int getUpdatedClusterCount() const;
+		Uint32 getPathCost() const;
+
+	private:
+		struct Node {
+			Point tile;
+			int side;
+			Sint32 mate;
+			Uint32 generation, g;
+			Sint32 parent;
+			bool closed;
+		};
+
+		struct Cluster {
+			Rectangle bounds;
+			std::vector<Node> nodes;
+			std::vector<Uint32> distances; // nodes x nodes
+			bool dirtyNodes, dirtyDistances;
+		};
+
+		struct LocalNode {
+			Uint32 generation, g;
+			Sint32 parent;
+			bool closed;
+		};
+
+		struct OpenEntry {
+			Uint32 f, g;
+			Sint32 id;
+		};
+
+		int clusterIndex(const Point& tile) const;
+		int neighbour(int cluster, int side) const;
+		Node& getNode(Sint32 id);
+
+		void markDirty(int x, int y);
+		void flush();
+		void buildNodes(int cluster);
+		void addEntrances(int cluster, int side);
+		void linkNodes(int cluster);
+		void buildDistances(int cluster);
+
+		bool localPassable(const Rectangle& bounds, int x, int y) const;
+		void localSearch(const Rectangle& bounds, const Point& from, const Point* to);
+		void localOpen(const Rectangle& bounds, int index, int parent, Uint32 g, const Point* to);
+		Uint32 localCost(const Rectangle& bounds, const Point& tile) const;
+
+		void openNode(Sint32 id, Sint32 parent, Uint32 g, const Point& goal);
+		void openGoal(Sint32 parent, Uint32 g);
+
+		const TileGrid* grid;
+		int clusterSize;
+		int width, height;
+		int clustersWide, clustersHigh;
+		std::vector<Cluster> clusters;
+		int updatedClusters;
+
+		std::vector<LocalNode> localNodes;
+		std::vector<OpenEntry> localOpenList;
+		Uint32 localGeneration;
+
+		std::vector<OpenEntry> openList;
+		std::vector<Uint32> startCosts, goalCosts;
+		Uint32 generation;
+		Uint32 goalG;
+		Sint32 goalParent;
+		Uint32 pathCost;
+	};
+} // namespace tiledl
+
+#endif // HIERARCHICALPATHFINDER_H_
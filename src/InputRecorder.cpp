@@ -0,0 +1,306 @@
+#include "InputRecorder.h"
+#include <cstring>
+#include <algorithm>
+
+using namespace tiledl;
+
+/*
+ * File layout, every value little endian:
+ *
+ * Header, 8 bytes
+ *   Uint32 magic        "TLDI"
+ *   Uint16 version      readers refuse versions newer than their own
+ *   Uint16 event size   sizeof(SDL_Event) of the recording build
+ *
+ * Records until the end of the file
+ *   Uint8 kind          RECORD_EVENT or RECORD_TICK
+ *   Uint32 delay        microseconds since the previous record
+ *   RECORD_EVENT only:
+ *     Uint8 length, the first length bytes of the SDL_Event, the rest are zero
+ */
+static const Uint32 INPUT_MAGIC = 0x49444C54; // "TLDI"
+static const Uint8 RECORD_EVENT = 1;
+static const Uint8 RECORD_TICK = 2;
+
+const Uint16 InputRecorder::VERSION;
+
+static Uint64 to_microseconds(Uint64 counter)
+{
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	return (counter / frequency) * 1000000 + (counter % frequency) * 1000000 / frequency;
+}
+
+static Uint64 from_microseconds(Uint64 microseconds)
+{
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	return (microseconds / 1000000) * frequency + (microseconds % 1000000) * frequency / 1000000;
+}
+
+InputRecorder::InputRecorder()
+{
+	this->file = nullptr;
+	this->start = this->previous = 0;
+	this->events = this->ticks = 0;
+}
+
+InputRecorder::~InputRecorder()
+{
+	close();
+}
+
+/**
+ * @brief Start a new log, replacing any file at the path
+ *
+ * @return true on success
+ */
+bool InputRecorder::open(const char* path)
+{
+	close();
+	this->file = SDL_RWFromFile(path, "wb");
+
+	if (this->file == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "InputRecorder (%p) : Failed to open %s : %s",
+		             this, path, SDL_GetError());
+		return false;
+	}
+
+	if (SDL_WriteLE32(this->file, INPUT_MAGIC) != 1 || SDL_WriteLE16(this->file, VERSION) != 1 ||
+	    SDL_WriteLE16(this->file, (Uint16)sizeof(SDL_Event)) != 1) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "InputRecorder (%p) : Failed to write to %s : %s",
+		             this, path, SDL_GetError());
+		close();
+		return false;
+	}
+
+	this->start = 0;
+	this->previous = 0;
+	this->events = this->ticks = 0;
+	return true;
+}
+
+void InputRecorder::close()
+{
+	if (this->file != nullptr) {
+		SDL_RWclose(this->file);
+		this->file = nullptr;
+	}
+}
+
+bool InputRecorder::isOpen() const
+{
+	return this->file != nullptr;
+}
+
+/**
+ * @param time SDL_GetPerformanceCounter() of the record, the first record is time 0
+ */
+bool InputRecorder::writeRecord(Uint8 kind, Uint64 time)
+{
+	if (this->file == nullptr) {
+		return false;
+	}
+
+	if (this->events == 0 && this->ticks == 0) {
+		this->start = time;
+	}
+
+	// Times only go forward, even if a record arrives late
+	const Uint64 now = std::max(to_microseconds(time - std::min(time, this->start)), this->previous);
+	const Uint32 delay = (Uint32)std::min<Uint64>(now - this->previous, 0xFFFFFFFF);
+	this->previous += delay;
+
+	return SDL_WriteU8(this->file, kind) == 1 && SDL_WriteLE32(this->file, delay) == 1;
+}
+
+/**
+ * @brief Add an event to the current tick
+ *
+ * @return false if not open or the write failed
+ */
+bool InputRecorder::record(const QueuedEvent& event)
+{
+	const Uint8* bytes = (const Uint8*)&event.event;
+	Uint8 length = (Uint8)std::min<size_t>(sizeof(SDL_Event), 255);
+
+	while (length > 0 && bytes[length - 1] == 0) {
+		length--;
+	}
+
+	if (!writeRecord(RECORD_EVENT, event.time) || SDL_WriteU8(this->file, length) != 1 ||
+	    (length > 0 && SDL_RWwrite(this->file, bytes, length, 1) != 1)) {
+		return false;
+	}
+
+	this->events++;
+	return true;
+}
+
+/**
+ * @brief End the current tick
+ *
+ * @param time SDL_GetPerformanceCounter() at the end of the tick
+ * @return false if not open or the write failed
+ */
+bool InputRecorder::tick(Uint64 time)
+{
+	if (!writeRecord(RECORD_TICK, time)) {
+		return false;
+	}
+
+	this->ticks++;
+	return true;
+}
+
+/* ========= Getters =========*/
+
+Uint64 InputRecorder::getEventCount() const
+{
+	return this->events;
+}
+
+Uint64 InputRecorder::getTickCount() const
+{
+	return this->ticks;
+}
+
+InputReplay::InputReplay()
+{
+	this->file = nullptr;
+	this->start = 0;
+	this->elapsed = 0;
+	this->ticks = 0;
+}
+
+InputReplay::~InputReplay()
+{
+	close();
+}
+
+/**
+ * @return true on success, otherwise the file is left closed
+ */
+bool InputReplay::open(const char* path)
+{
+	close();
+	this->file = SDL_RWFromFile(path, "rb");
+
+	if (this->file == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "InputReplay (%p) : Failed to open %s : %s",
+		             this, path, SDL_GetError());
+		return false;
+	}
+
+	Uint8 header[8];
+	Uint32 magic = 0;
+
+	if (SDL_RWread(this->file, header, sizeof(header), 1) == 1) {
+		memcpy(&magic, header, sizeof(magic));
+	}
+
+	if (SDL_SwapLE32(magic) != INPUT_MAGIC) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "InputReplay (%p) : %s is not an input log", this, path);
+		close();
+		return false;
+	}
+
+	Uint16 version, eventSize;
+	memcpy(&version, header + 4, sizeof(version));
+	memcpy(&eventSize, header + 6, sizeof(eventSize));
+	version = SDL_SwapLE16(version);
+	eventSize = SDL_SwapLE16(eventSize);
+
+	if (version == 0 || version > InputRecorder::VERSION) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "InputReplay (%p) : %s is version %i, only up to %i is supported",
+		             this, path, version, InputRecorder::VERSION);
+		close();
+		return false;
+	}
+
+	if (eventSize != sizeof(SDL_Event)) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "InputReplay (%p) : %s was recorded with %i byte events, not %i",
+		             this, path, eventSize, (int)sizeof(SDL_Event));
+		close();
+		return false;
+	}
+
+	this->start = SDL_GetPerformanceCounter();
+	this->elapsed = 0;
+	this->ticks = 0;
+	return true;
+}
+
+void InputReplay::close()
+{
+	if (this->file != nullptr) {
+		SDL_RWclose(this->file);
+		this->file = nullptr;
+	}
+}
+
+bool InputReplay::isOpen() const
+{
+	return this->file != nullptr;
+}
+
+/**
+ * @brief Read the events of the next tick
+ *
+ * Event times are moved to when replaying started, keeping the gaps
+ * between them as recorded.
+ *
+ * @param events cleared, then filled with the events of the tick
+ * @return false at the end of the log, or if it is cut short
+ */
+bool InputReplay::readTick(std::vector<QueuedEvent>& events)
+{
+	events.clear();
+
+	if (this->file == nullptr) {
+		return false;
+	}
+
+	Uint8 kind;
+
+	while (SDL_RWread(this->file, &kind, 1, 1) == 1) {
+		Uint32 delay;
+
+		if (SDL_RWread(this->file, &delay, sizeof(delay), 1) != 1) {
+			break;
+		}
+
+		this->elapsed += SDL_SwapLE32(delay);
+
+		if (kind == RECORD_TICK) {
+			this->ticks++;
+			return true;
+		}
+
+		Uint8 length;
+		QueuedEvent queued;
+		SDL_zero(queued.event);
+
+		if (kind != RECORD_EVENT || SDL_RWread(this->file, &length, 1, 1) != 1 || length > sizeof(SDL_Event) ||
+		    (length > 0 && SDL_RWread(this->file, &queued.event, length, 1) != 1)) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "InputReplay (%p) : Corrupt record after tick %llu",
+			             this, (unsigned long long)this->ticks);
+			break;
+		}
+
+		queued.time = this->start + from_microseconds(this->elapsed);
+		events.push_back(queued);
+	}
+
+	// Events after the last tick never reached an update
+	events.clear();
+	return false;
+}
+
+/* ========= Getters =========*/
+
+/**
+ * @brief Get the number of ticks read so far
+ */
+Uint64 InputReplay::getTickCount() const
+{
+	return this->ticks;
+}
@@ -0,0 +1,86 @@
+#ifndef INPUTRECORDER_H_
+#define INPUTRECORDER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+namespace tiledl
+{
+	/**
+	 * An SDL_Event pumped on the main thread, waiting for the update thread
+	 */
+	struct QueuedEvent {
+		SDL_Event event;
+		Uint64 time; // SDL_GetPerformanceCounter() when it was pumped
+	};
+
+	/**
+	 * Writes the events handled by a Game, and the ends of the update ticks
+	 * between them, into a compact binary log for InputReplay.
+	 *
+	 * Events are stored as their raw bytes without the trailing zeroes, so
+	 * a log only replays on builds with the same SDL_Event layout and
+	 * pointers in user events mean nothing when replayed.
+	 */
+	class InputRecorder
+	{
+	public:
+		static const Uint16 VERSION = 1;
+
+		InputRecorder();
+		~InputRecorder();
+
+		bool open(const char* path);
+		void close();
+		bool isOpen() const;
+
+		bool record(const QueuedEvent& event);
+		bool tick(Uint64 time);
+
+		// Getters
+		Uint64 getEventCount() const;
+		Uint64 getTickCount() const;
+
+	private:
+		InputRecorder(const InputRecorder&);
+		InputRecorder& operator=(const InputRecorder&);
+
+		bool writeRecord(Uint8 kind, Uint64 time);
+
+		SDL_RWops* file;
+		Uint64 start;    // time of the first record
+		Uint64 previous; // microseconds from start to the last record
+		Uint64 events, ticks;
+	};
+
+	/**
+	 * Reads a log written by an InputRecorder back one tick at a time.
+	 */
+	class InputReplay
+	{
+	public:
+		InputReplay();
+		~InputReplay();
+
+		bool open(const char* path);
+		void close();
+		bool isOpen() const;
+
+		bool readTick(std::vector<QueuedEvent>& events);
+
+		// Getters
+		Uint64 getTickCount() const;
+
+	private:
+		InputReplay(const InputReplay&);
+		InputReplay& operator=(const InputReplay&);
+
+		SDL_RWops* file;
+		Uint64 start;   // time replaying started
+		Uint64 elapsed; // microseconds from the start of the log to the last record read
+		Uint64 ticks;
+	};
+} // namespace tiledl
+
+#endif // INPUTRECORDER_H_
@@ -0,0 +1,156 @@
+#include "InputState.h"
+
+using namespace tiledl;
+
+InputSnapshot::InputSnapshot()
+{
+	tick = 0;
+	buttonsDown = buttonsPressed = buttonsReleased = 0;
+	mouseX = mouseY = 0;
+	motionX = motionY = 0;
+	wheelX = wheelY = 0;
+	motionEvents = 0;
+}
+
+InputState::InputState()
+{
+	reset();
+}
+
+InputState::~InputState()
+{
+
+}
+
+/**
+ * @brief Fold an event into the snapshot of the current tick
+ *
+ * @return true if the event was keyboard or mouse input
+ */
+bool InputState::handle(const SDL_Event& event)
+{
+	InputSnapshot& back = this->snapshots[1 - this->front];
+
+	switch (event.type) {
+	case SDL_KEYDOWN:
+	case SDL_KEYUP: {
+		const SDL_Scancode key = event.key.keysym.scancode;
+
+		if ((unsigned)key >= SDL_NUM_SCANCODES) {
+			return true;
+		}
+
+		if (event.type == SDL_KEYDOWN) {
+			// Repeats are not new presses
+			if (!event.key.repeat) {
+				back.keysPressed.set(key);
+			}
+
+			back.keysDown.set(key);
+		} else {
+			back.keysReleased.set(key);
+			back.keysDown.reset(key);
+		}
+
+		return true;
+	}
+
+	case SDL_MOUSEMOTION:
+		back.mouseX = event.motion.x;
+		back.mouseY = event.motion.y;
+		back.motionX += event.motion.xrel;
+		back.motionY += event.motion.yrel;
+		back.motionEvents++;
+		return true;
+
+	case SDL_MOUSEBUTTONDOWN:
+	case SDL_MOUSEBUTTONUP: {
+		if ((unsigned)(event.button.button - 1) >= 32) {
+			return true;
+		}
+
+		const Uint32 bit = (Uint32)1 << (event.button.button - 1);
+		back.mouseX = event.button.x;
+		back.mouseY = event.button.y;
+
+		if (event.type == SDL_MOUSEBUTTONDOWN) {
+			back.buttonsPressed |= bit;
+			back.buttonsDown |= bit;
+		} else {
+			back.buttonsReleased |= bit;
+			back.buttonsDown &= ~bit;
+		}
+
+		return true;
+	}
+
+	case SDL_MOUSEWHEEL:
+		back.wheelX += event.wheel.x;
+		back.wheelY += event.wheel.y;
+		return true;
+
+	case SDL_WINDOWEVENT:
+		// Keys let go while unfocused never send their key up
+		if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
+			back.keysReleased |= back.keysDown;
+			back.keysDown.reset();
+			back.buttonsReleased |= back.buttonsDown;
+			back.buttonsDown = 0;
+		}
+
+		return false;
+
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief End the tick, the gathered input becomes the snapshot
+ *
+ * @return the published snapshot
+ */
+const InputSnapshot& InputState::publish()
+{
+	this->front = 1 - this->front;
+
+	// Start the next tick from the held keys and position, without the edges and totals
+	const InputSnapshot& published = this->snapshots[this->front];
+	InputSnapshot& back = this->snapshots[1 - this->front];
+	back.tick = published.tick + 1;
+	back.keysDown = published.keysDown;
+	back.keysPressed.reset();
+	back.keysReleased.reset();
+	back.buttonsDown = published.buttonsDown;
+	back.buttonsPressed = back.buttonsReleased = 0;
+	back.mouseX = published.mouseX;
+	back.mouseY = published.mouseY;
+	back.motionX = back.motionY = 0;
+	back.wheelX = back.wheelY = 0;
+	back.motionEvents = 0;
+
+	return published;
+}
+
+/**
+ * @brief Release everything and clear both snapshots
+ */
+void InputState::reset()
+{
+	this->snapshots[0] = InputSnapshot();
+	this->snapshots[1] = InputSnapshot();
+	this->snapshots[1].tick = 1;
+	this->front = 0;
+}
+
+/* ========= Getters =========*/
+
+/**
+ * @brief Get the snapshot of the last published tick
+ *
+ * @note Stays the same until the next publish()
+ */
+const InputSnapshot& InputState::getSnapshot() const
+{
+	return this->snapshots[this->front];
+}
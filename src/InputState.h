@@ -0,0 +1,96 @@
+#ifndef INPUTSTATE_H_
+#define INPUTSTATE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <bitset>
+
+namespace tiledl
+{
+	/**
+	 * The keyboard and mouse as of one update tick.
+	 *
+	 * Pressed and released are edges, set if the key went down or up at any
+	 * point during the tick, so a tap shorter than a tick is both pressed and
+	 * released without being down.
+	 */
+	struct InputSnapshot {
+		Uint64 tick;
+
+		std::bitset<SDL_NUM_SCANCODES> keysDown, keysPressed, keysReleased;
+		Uint32 buttonsDown, buttonsPressed, buttonsReleased; // SDL_BUTTON() masks
+
+		int mouseX, mouseY;   // last position in the window
+		int motionX, motionY; // total relative motion during the tick
+		int wheelX, wheelY;   // total wheel scrolled during the tick
+		int motionEvents;     // motion events coalesced into the tick
+
+		InputSnapshot();
+
+		bool isKeyDown(SDL_Scancode key) const;
+		bool isKeyPressed(SDL_Scancode key) const;
+		bool isKeyReleased(SDL_Scancode key) const;
+		bool isButtonDown(int button) const;
+		bool isButtonPressed(int button) const;
+		bool isButtonReleased(int button) const;
+	};
+
+	/**
+	 * Folds keyboard and mouse events into a snapshot published once per
+	 * update tick, for polling instead of walking the events.
+	 *
+	 * Events are gathered into a back snapshot by handle(), publish() makes
+	 * it the front snapshot returned by getSnapshot() and starts the next
+	 * tick with the edges and totals cleared. Mouse motion folds into one
+	 * position and a running total however many events arrive.
+	 */
+	class InputState
+	{
+	public:
+		InputState();
+		~InputState();
+
+		bool handle(const SDL_Event& event);
+		const InputSnapshot& publish();
+		void reset();
+
+		// Getters
+		const InputSnapshot& getSnapshot() const;
+
+	private:
+		InputSnapshot snapshots[2];
+		int front; // index of the published snapshot
+	};
+
+	inline bool InputSnapshot::isKeyDown(SDL_Scancode key) const
+	{
+		return (unsigned)key < SDL_NUM_SCANCODES && keysDown[key];
+	}
+
+	inline bool InputSnapshot::isKeyPressed(SDL_Scancode key) const
+	{
+		return (unsigned)key < SDL_NUM_SCANCODES && keysPressed[key];
+	}
+
+	inline bool InputSnapshot::isKeyReleased(SDL_Scancode key) const
+	{
+		return (unsigned)key < SDL_NUM_SCANCODES && keysReleased[key];
+	}
+
+	inline bool InputSnapshot::isButtonDown(int button) const
+	{
+		return (unsigned)(button - 1) < 32 && (buttonsDown & ((Uint32)1 << (button - 1))) != 0;
+	}
+
+	inline bool InputSnapshot::isButtonPressed(int button) const
+	{
+		return (unsigned)(button - 1) < 32 && (buttonsPressed & ((Uint32)1 << (button - 1))) != 0;
+	}
+
+	inline bool InputSnapshot::isButtonReleased(int button) const
+	{
+		return (unsigned)(button - 1) < 32 && (buttonsReleased & ((Uint32)1 << (button - 1))) != 0;
+	}
+} // namespace tiledl
+
+#endif // INPUTSTATE_H_
@@ -0,0 +1,454 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+using namespace tiledl;
+
+namespace
+{
+	/**
+	 * The deques a thread has claimed, given back when the thread exits
+	 */
+	struct Claims {
+		std::vector<std::weak_ptr<std::atomic<SDL_threadID>>> owners;
+
+		~Claims()
+		{
+			const SDL_threadID id = SDL_ThreadID();
+
+			for (auto& owner : this->owners) {
+				// Expired if the JobSystem stopped first
+				if (auto claimed = owner.lock()) {
+					SDL_threadID expected = id;
+					claimed->compare_exchange_strong(expected, 0);
+				}
+			}
+		}
+	};
+
+	thread_local Claims claims;
+}
+
+JobSystem::JobSystem() : nextThread(0), sleeping(0), quit(false), full(false), executed(0), stolen(0)
+{
+	this->wake = nullptr;
+	this->running = false;
+}
+
+JobSystem::~JobSystem()
+{
+	stop();
+}
+
+/**
+ * @brief Start a worker for every core but the calling thread's
+ */
+bool JobSystem::start()
+{
+	return start(SDL_GetCPUCount() - 1);
+}
+
+/**
+ * @brief Start the worker threads
+ *
+ * @param threads number of worker threads, 0 runs jobs only on the threads waiting for them
+ * @return false if already running or the threads could not be created
+ */
+bool JobSystem::start(int threads)
+{
+	if (this->running) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "JobSystem (%p) : Already started", this);
+		return false;
+	}
+
+	this->wake = SDL_CreateSemaphore(0);
+
+	if (this->wake == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "JobSystem (%p) : Failed to create semaphore : %s",
+		             this, SDL_GetError());
+		return false;
+	}
+
+	threads = std::max(threads, 0);
+	this->workers.clear();
+
+	for (int i = 0; i < threads + EXTERNAL_THREADS; i++) {
+		this->workers.emplace_back(new Worker());
+		this->workers.back()->random = 0x9E3779B9u * (i + 1);
+	}
+
+	this->quit = false;
+	this->full = false;
+	this->nextThread = 0;
+	this->running = true;
+
+	for (int i = 0; i < threads; i++) {
+		SDL_Thread* thread = SDL_CreateThread((SDL_ThreadFunction)([](void * ptr) -> int {
+			((JobSystem*)(ptr))->workerLoop();
+			return 0;
+		}), "Job Worker", this);
+
+		if (thread == nullptr) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "JobSystem (%p) : Failed to create worker thread : %s",
+			             this, SDL_GetError());
+			stop();
+			return false;
+		}
+
+		this->threads.push_back(thread);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Stop the worker threads, running any jobs still queued
+ *
+ * @note No other thread may run or wait on jobs while stopping
+ */
+void JobSystem::stop()
+{
+	if (!this->running) {
+		return;
+	}
+
+	this->quit = true;
+
+	for (size_t i = 0; i < this->threads.size(); i++) {
+		SDL_SemPost(this->wake);
+	}
+
+	for (auto thread : this->threads) {
+		SDL_WaitThread(thread, NULL);
+	}
+
+	this->threads.clear();
+
+	// Every owner has stopped, so stealing drains the deques from here
+	for (auto& worker : this->workers) {
+		while (Job* job = worker->deque.steal()) {
+			execute(job);
+		}
+	}
+
+	this->workers.clear();
+	this->running = false;
+
+	SDL_DestroySemaphore(this->wake);
+	this->wake = nullptr;
+}
+
+/**
+ * @brief Get the deque of the calling thread, claiming one on first use
+ *
+ * @return the index into workers, -1 if every deque is taken
+ * @note A claimed deque is given back when the thread exits
+ */
+int JobSystem::getWorkerIndex()
+{
+	const SDL_threadID id = SDL_ThreadID();
+
+	for (int i = 0; i < (int)this->workers.size(); i++) {
+		if (this->workers[i]->owner->load(std::memory_order_relaxed) == id) {
+			return i;
+		}
+	}
+
+	for (int i = (int)this->threads.size(); i < (int)this->workers.size(); i++) {
+		SDL_threadID unclaimed = 0;
+
+		if (this->workers[i]->owner->compare_exchange_strong(unclaimed, id)) {
+			auto& owners = claims.owners;
+			owners.erase(std::remove_if(owners.begin(), owners.end(),
+			[](const std::weak_ptr<std::atomic<SDL_threadID>>& owner) {
+				return owner.expired();
+			}), owners.end());
+			owners.push_back(this->workers[i]->owner);
+			return i;
+		}
+	}
+
+	if (!this->full.exchange(true)) {
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+		            "JobSystem (%p) : All %i deques for other threads are claimed, thread %lu runs its jobs inline",
+		            this, EXTERNAL_THREADS, (unsigned long)id);
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Take a job from the pool of a deque, only call from its owner
+ */
+JobSystem::Job* JobSystem::allocate(int index)
+{
+	Worker& worker = *this->workers[index];
+
+	if (worker.free == nullptr) {
+		worker.free = worker.returned.exchange(nullptr, std::memory_order_acquire);
+	}
+
+	if (worker.free == nullptr) {
+		Job* block = new Job[JOB_BLOCK];
+		worker.blocks.emplace_back(block);
+
+		for (int i = 0; i < JOB_BLOCK; i++) {
+			block[i].home = &worker;
+			block[i].next = (i + 1 < JOB_BLOCK) ? &block[i + 1] : nullptr;
+		}
+
+		worker.free = block;
+	}
+
+	Job* job = worker.free;
+	worker.free = job->next;
+	return job;
+}
+
+/**
+ * @brief Give a finished job back to the pool it came from, from any thread
+ */
+void JobSystem::release(Job* job)
+{
+	job->function = nullptr;
+
+	// Only the owner takes from returned, and it takes the whole list, so pushing cannot suffer ABA
+	Worker* home = job->home;
+	Job* head = home->returned.load(std::memory_order_relaxed);
+
+	do {
+		job->next = head;
+	} while (!home->returned.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/**
+ * @brief Push a job to a deque, running it now if the deque is full
+ */
+void JobSystem::queue(int index, Job* job)
+{
+	job->counter->count.fetch_add(1, std::memory_order_relaxed);
+
+	if (!this->workers[index]->deque.push(job)) {
+		execute(job);
+		return;
+	}
+
+	if (this->sleeping.load() > 0) {
+		SDL_SemPost(this->wake);
+	}
+}
+
+/**
+ * @brief Queue a job on the calling thread's deque
+ *
+ * @param counter counts the job until it finishes, must outlive the job
+ * @note Jobs must not throw
+ */
+void JobSystem::run(const std::function<void()>& function, JobCounter& counter)
+{
+	const int index = this->running ? getWorkerIndex() : -1;
+
+	// Run it now if there is nowhere to queue it
+	if (index < 0) {
+		function();
+		this->executed.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	Job* job = allocate(index);
+	job->function = function;
+	job->task = nullptr;
+	job->counter = &counter;
+	queue(index, job);
+}
+
+/**
+ * @brief Run queued jobs until every job of the counter has finished
+ */
+void JobSystem::wait(JobCounter& counter)
+{
+	if (counter.isDone()) {
+		return;
+	}
+
+	const int index = this->running ? getWorkerIndex() : -1;
+
+	while (!counter.isDone()) {
+		Job* job = this->running ? find(index) : nullptr;
+
+		if (job != nullptr) {
+			execute(job);
+		} else {
+			// The last jobs are running on other threads
+			SDL_Delay(0);
+		}
+	}
+}
+
+/**
+ * @brief Take a job from a deque, the thread's own first
+ *
+ * @param index deque of the calling thread, -1 for none
+ */
+JobSystem::Job* JobSystem::find(int index)
+{
+	Uint32 random = (Uint32)SDL_ThreadID();
+
+	if (index >= 0) {
+		Worker& worker = *this->workers[index];
+
+		if (Job* job = worker.deque.pop()) {
+			return job;
+		}
+
+		// xorshift, only the owner touches its state
+		worker.random ^= worker.random << 13;
+		worker.random ^= worker.random >> 17;
+		worker.random ^= worker.random << 5;
+		random = worker.random;
+	}
+
+	// Start at a random victim so thieves spread out
+	const int count = (int)this->workers.size();
+
+	for (int i = 0; i < count; i++) {
+		const int victim = (int)((random + i) % count);
+
+		if (victim == index) {
+			continue;
+		}
+
+		if (Job* job = this->workers[victim]->deque.steal()) {
+			this->stolen.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+void JobSystem::execute(Job* job)
+{
+	if (job->task != nullptr) {
+		runRange(job->begin, job->end, job->grain, job->task, job->counter);
+	} else {
+		job->function();
+	}
+
+	// Back in the pool before the counter lets a waiter go on
+	JobCounter* counter = job->counter;
+	release(job);
+	counter->count.fetch_sub(1, std::memory_order_release);
+	this->executed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JobSystem::workerLoop()
+{
+	const int index = this->nextThread.fetch_add(1);
+	this->workers[index]->owner->store(SDL_ThreadID());
+
+	while (!this->quit.load()) {
+		if (Job* job = find(index)) {
+			execute(job);
+			continue;
+		}
+
+		// Announce sleeping before the last look, a push after it posts the semaphore
+		this->sleeping.fetch_add(1);
+		bool idle = true;
+
+		for (auto& worker : this->workers) {
+			idle = idle && worker->deque.isEmpty();
+		}
+
+		if (idle && !this->quit.load()) {
+			SDL_SemWaitTimeout(this->wake, 10);
+		}
+
+		this->sleeping.fetch_sub(1);
+	}
+}
+
+/**
+ * @brief Run a range of indices, splitting off its upper half as a job until it is a single grain
+ */
+void JobSystem::runRange(int begin, int end, int grain, const std::function<void(int)>* task, JobCounter* counter)
+{
+	const int index = getWorkerIndex();
+
+	while (index >= 0 && end - begin > grain) {
+		const int middle = begin + (end - begin) / 2;
+		Job* job = allocate(index);
+		job->task = task;
+		job->begin = middle;
+		job->end = end;
+		job->grain = grain;
+		job->counter = counter;
+		queue(index, job);
+		end = middle;
+	}
+
+	for (int i = begin; i < end; i++) {
+		(*task)(i);
+	}
+}
+
+/**
+ * @brief Run task(i) for every i in [0, count) across the workers
+ *
+ * @param grain fewest indices run as one job, 0 to pick one from the number of threads
+ * @note Tasks run in no particular order and may run concurrently, they
+ * must only write to data no other index touches
+ */
+void JobSystem::parallelFor(int count, const std::function<void(int)>& task, int grain)
+{
+	if (count <= 0) {
+		return;
+	}
+
+	if (grain <= 0) {
+		grain = std::max(1, count / ((getThreadCount() + 1) * 8));
+	}
+
+	if (!this->running || count <= grain) {
+		for (int i = 0; i < count; i++) {
+			task(i);
+		}
+
+		return;
+	}
+
+	JobCounter counter;
+	runRange(0, count, grain, &task, &counter);
+	wait(counter);
+}
+
+/* ========= Getters =========*/
+
+bool JobSystem::isRunning() const
+{
+	return this->running;
+}
+
+/**
+ * @brief Get the number of worker threads, not counting the threads waiting on jobs
+ */
+int JobSystem::getThreadCount() const
+{
+	return (int)this->threads.size();
+}
+
+/**
+ * @brief Get the number of jobs that have finished
+ */
+Uint64 JobSystem::getExecutedCount() const
+{
+	return this->executed.load();
+}
+
+/**
+ * @brief Get the number of jobs taken from another thread's deque
+ */
+Uint64 JobSystem::getStolenCount() const
+{
+	return this->stolen.load();
+}
@@ -0,0 +1,120 @@
+#ifndef JOBSYSTEM_H_
+#define JOBSYSTEM_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include "WorkStealingDeque.h"
+
+namespace tiledl
+{
+	/**
+	 * Counts the unfinished jobs of a group, JobSystem::wait() returns
+	 * once it reaches zero.
+	 *
+	 * A job that runs more jobs with the counter it was run with keeps the
+	 * counter above zero until its children finish as well.
+	 */
+	struct JobCounter {
+		std::atomic<int> count;
+
+		JobCounter() : count(0) {}
+		bool isDone() const { return count.load(std::memory_order_acquire) == 0; }
+	};
+
+	/**
+	 * A work-stealing pool of worker threads for fanning work out from any
+	 * thread, such as the update and render threads of a Game.
+	 *
+	 * Every worker, and every other thread that runs jobs, owns a
+	 * WorkStealingDeque. Jobs are pushed to the deque of the thread that
+	 * runs them, idle workers steal from the other deques. wait() runs jobs
+	 * while it waits instead of blocking, so jobs may wait on their own
+	 * children without tying up a thread.
+	 *
+	 * Other threads claim one of EXTERNAL_THREADS deques the first time they
+	 * run a job and give it back when they exit. Jobs come from a pool kept
+	 * with each deque, finished jobs return to the pool they came from.
+	 *
+	 * Before start() and after stop() every job runs immediately on the
+	 * thread that runs it.
+	 */
+	class JobSystem
+	{
+	public:
+		static const int EXTERNAL_THREADS = 8; // most threads besides the workers that can queue jobs at once
+		static const int DEQUE_CAPACITY = 4096;
+
+		JobSystem();
+		~JobSystem();
+
+		bool start();
+		bool start(int threads);
+		void stop();
+
+		void run(const std::function<void()>& function, JobCounter& counter);
+		void wait(JobCounter& counter);
+		void parallelFor(int count, const std::function<void(int)>& task, int grain = 0);
+
+		// Getters
+		bool isRunning() const;
+		int getThreadCount() const;
+		Uint64 getExecutedCount() const;
+		Uint64 getStolenCount() const;
+
+	private:
+		JobSystem(const JobSystem&);
+		JobSystem& operator=(const JobSystem&);
+
+		static const int JOB_BLOCK = 64; // jobs a pool grows by
+
+		struct Worker;
+
+		struct Job {
+			std::function<void()> function;
+			const std::function<void(int)>* task; // a range of a parallelFor instead of function
+			int begin, end, grain;
+			JobCounter* counter;
+			Worker* home; // pool it returns to
+			Job* next;
+		};
+
+		struct Worker {
+			WorkStealingDeque<Job> deque;
+			std::shared_ptr<std::atomic<SDL_threadID>> owner; // 0 if not claimed
+			Uint32 random;
+
+			Job* free; // only touched by the owner
+			std::atomic<Job*> returned; // finished on other threads
+			std::vector<std::unique_ptr<Job[]>> blocks;
+
+			Worker() : deque(DEQUE_CAPACITY), owner(new std::atomic<SDL_threadID>(0)), random(0),
+				free(nullptr), returned(nullptr) {}
+		};
+
+		int getWorkerIndex();
+		Job* allocate(int index);
+		void release(Job* job);
+		void queue(int index, Job* job);
+		Job* find(int index);
+		void execute(Job* job);
+		void runRange(int begin, int end, int grain, const std::function<void(int)>* task, JobCounter* counter);
+		void workerLoop();
+
+		std::vector<std::unique_ptr<Worker>> workers; // the threads first, then other threads
+		std::vector<SDL_Thread*> threads;
+		std::atomic<int> nextThread;
+		SDL_sem* wake;
+		std::atomic<int> sleeping;
+		std::atomic<bool> quit;
+		std::atomic<bool> full; // logged running jobs inline for want of a deque
+		bool running;
+
+		std::atomic<Uint64> executed, stolen;
+	};
+} // namespace tiledl
+
+#endif // JOBSYSTEM_H_
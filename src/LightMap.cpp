@@ -0,0 +1,407 @@
+#include "LightMap.h"
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+
+using namespace tiledl;
+
+static const int NEIGHBOURS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+/**
+ * @param grid the grid light spreads over, must outlive the LightMap
+ */
+LightMap::LightMap(const TileGrid& grid) : LightMap(grid, 16)
+{
+
+}
+
+/**
+ * @param grid the grid light spreads over, must outlive the LightMap
+ * @param falloff levels of light lost per tile
+ */
+LightMap::LightMap(const TileGrid& grid, Uint8 falloff)
+{
+	if (falloff == 0) {
+		throw std::invalid_argument("LightMap falloff must be greater than zero");
+	}
+
+	this->grid = &grid;
+	this->falloff = falloff;
+	this->width = this->height = 0;
+	clearDirty();
+	prepare();
+}
+
+LightMap::~LightMap()
+{
+
+}
+
+/**
+ * @brief Reallocate the levels when the grid changed size, dropping lights outside of it
+ */
+void LightMap::prepare()
+{
+	if (this->width == this->grid->getWidth() && this->height == this->grid->getHeight()) {
+		return;
+	}
+
+	std::vector<std::pair<Point, Light>> kept;
+
+	for (auto& it : this->lights) {
+		Point tile(it.first % this->width, it.first / this->width);
+
+		if (this->grid->isInside(tile.x, tile.y)) {
+			kept.push_back(std::make_pair(tile, it.second));
+		}
+	}
+
+	this->width = this->grid->getWidth();
+	this->height = this->grid->getHeight();
+	this->lights.clear();
+
+	for (auto& light : kept) {
+		this->lights[light.first.y * this->width + light.first.x] = light.second;
+	}
+
+	rebuild();
+}
+
+/**
+ * @brief Relight every tile from scratch
+ */
+void LightMap::rebuild()
+{
+	for (int c = 0; c < LIGHT_CHANNELS; c++) {
+		this->levels[c].assign((size_t)this->width * this->height, 0);
+
+		for (auto& it : this->lights) {
+			seed(c, it.first, it.second.level[c]);
+		}
+
+		propagate(c);
+	}
+
+	this->dirtyX0 = this->dirtyY0 = 0;
+	this->dirtyX1 = this->width;
+	this->dirtyY1 = this->height;
+}
+
+/**
+ * @brief Place a light on a tile, replacing any light already on it
+ *
+ * @param color level of each channel on the tile itself
+ */
+void LightMap::addLight(const Point& tile, const Color& color)
+{
+	prepare();
+
+	if (!this->grid->isInside(tile.x, tile.y)) {
+		throw std::out_of_range("Light is outside of the TileGrid");
+	}
+
+	int index = tile.y * this->width + tile.x;
+
+	if (this->lights.count(index) != 0) {
+		removeLight(tile);
+	}
+
+	Light light = { { color.r, color.g, color.b } };
+	this->lights[index] = light;
+
+	for (int c = 0; c < LIGHT_CHANNELS; c++) {
+		seed(c, index, light.level[c]);
+		propagate(c);
+	}
+}
+
+/**
+ * @brief Remove the light on a tile, if there is one
+ */
+void LightMap::removeLight(const Point& tile)
+{
+	prepare();
+
+	if (!this->grid->isInside(tile.x, tile.y)) {
+		return;
+	}
+
+	auto it = this->lights.find(tile.y * this->width + tile.x);
+
+	if (it == this->lights.end()) {
+		return;
+	}
+
+	int index = it->first;
+	this->lights.erase(it);
+
+	for (int c = 0; c < LIGHT_CHANNELS; c++) {
+		clear(c, index);
+		unpropagate(c);
+		propagate(c);
+	}
+}
+
+/**
+ * @brief Relight around a tile after its opacity changed
+ */
+void LightMap::update(const Point& tile)
+{
+	if (this->width != this->grid->getWidth() || this->height != this->grid->getHeight()) {
+		prepare();
+		return;
+	}
+
+	if (!this->grid->isInside(tile.x, tile.y)) {
+		return;
+	}
+
+	const int index = tile.y * this->width + tile.x;
+	auto light = this->lights.find(index);
+
+	for (int c = 0; c < LIGHT_CHANNELS; c++) {
+		clear(c, index);
+		unpropagate(c);
+
+		// A tile that became clear is lit from its neighbours
+		for (int n = 0; n < 4; n++) {
+			int x = tile.x + NEIGHBOURS[n][0];
+			int y = tile.y + NEIGHBOURS[n][1];
+
+			if (this->grid->isInside(x, y) && this->levels[c][y * this->width + x] > 0) {
+				this->addQueue.push_back(y * this->width + x);
+			}
+		}
+
+		if (light != this->lights.end()) {
+			seed(c, index, light->second.level[c]);
+		}
+
+		propagate(c);
+	}
+}
+
+/**
+ * @brief Raise the level of a tile and queue it to spread
+ */
+void LightMap::seed(int channel, int index, Uint8 level)
+{
+	if (level > this->levels[channel][index]) {
+		this->levels[channel][index] = level;
+		this->addQueue.push_back(index);
+		markDirty(index);
+	}
+}
+
+/**
+ * @brief Darken a tile and queue the light it spread to be removed
+ */
+void LightMap::clear(int channel, int index)
+{
+	Uint8 level = this->levels[channel][index];
+
+	if (level > 0) {
+		this->levels[channel][index] = 0;
+		RemoveEntry entry = { index, level };
+		this->removeQueue.push_back(entry);
+		markDirty(index);
+	}
+}
+
+/**
+ * @brief Spread the light of every queued tile, breadth first
+ */
+void LightMap::propagate(int channel)
+{
+	std::vector<Uint8>& level = this->levels[channel];
+
+	for (size_t head = 0; head < this->addQueue.size(); head++) {
+		const int index = this->addQueue[head];
+		const Uint8 current = level[index];
+
+		if (current <= this->falloff) {
+			continue;
+		}
+
+		const Uint8 next = current - this->falloff;
+		const int x = index % this->width;
+		const int y = index / this->width;
+
+		for (int n = 0; n < 4; n++) {
+			int nx = x + NEIGHBOURS[n][0];
+			int ny = y + NEIGHBOURS[n][1];
+
+			// Opaque and outside tiles take no light
+			if (this->grid->isOpaque(nx, ny)) {
+				continue;
+			}
+
+			int neighbour = ny * this->width + nx;
+
+			if (level[neighbour] < next) {
+				level[neighbour] = next;
+				this->addQueue.push_back(neighbour);
+				markDirty(neighbour);
+			}
+		}
+	}
+
+	this->addQueue.clear();
+}
+
+/**
+ * @brief Darken the tiles lit by the queued tiles, breadth first
+ *
+ * Tiles at least as bright as the light being removed were lit from
+ * elsewhere, they are queued to spread back once propagate() is called.
+ */
+void LightMap::unpropagate(int channel)
+{
+	std::vector<Uint8>& level = this->levels[channel];
+
+	for (size_t head = 0; head < this->removeQueue.size(); head++) {
+		const RemoveEntry entry = this->removeQueue[head];
+		const int x = entry.index % this->width;
+		const int y = entry.index / this->width;
+
+		for (int n = 0; n < 4; n++) {
+			int nx = x + NEIGHBOURS[n][0];
+			int ny = y + NEIGHBOURS[n][1];
+
+			if (this->grid->isOpaque(nx, ny)) {
+				// Only a light on an opaque tile can be lit, and it may need to spread back
+				if (this->grid->isInside(nx, ny) && level[ny * this->width + nx] > 0) {
+					this->addQueue.push_back(ny * this->width + nx);
+				}
+
+				continue;
+			}
+
+			int neighbour = ny * this->width + nx;
+			Uint8 current = level[neighbour];
+
+			if (current != 0 && current < entry.level) {
+				level[neighbour] = 0;
+				RemoveEntry next = { neighbour, current };
+				this->removeQueue.push_back(next);
+				markDirty(neighbour);
+
+				auto light = this->lights.find(neighbour);
+
+				if (light != this->lights.end()) {
+					seed(channel, neighbour, light->second.level[channel]);
+				}
+			} else if (current >= entry.level) {
+				this->addQueue.push_back(neighbour);
+			}
+		}
+	}
+
+	this->removeQueue.clear();
+}
+
+void LightMap::markDirty(int index)
+{
+	const int x = index % this->width;
+	const int y = index / this->width;
+
+	this->dirtyX0 = std::min(this->dirtyX0, x);
+	this->dirtyY0 = std::min(this->dirtyY0, y);
+	this->dirtyX1 = std::max(this->dirtyX1, x + 1);
+	this->dirtyY1 = std::max(this->dirtyY1, y + 1);
+}
+
+/**
+ * @brief Write an area of the light map into a streaming texture, one texel per tile
+ *
+ * Draw the texture over the scene, scaled to the tile size, with
+ * SDL_BLENDMODE_MOD to darken everything outside of the light.
+ *
+ * @param texture a SDL_PIXELFORMAT_ABGR8888 streaming texture at least as large as the grid
+ * @param area area of tiles to write, such as getDirtyRect()
+ * @param ambient least light of every tile, such as daylight
+ * @return true on success, an empty area is always a success
+ */
+bool LightMap::upload(Texture& texture, const Rectangle& area, const Color& ambient) const
+{
+	if (texture.getFormat() != SDL_PIXELFORMAT_ABGR8888) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "LightMap (%p) : Texture (%p) must be SDL_PIXELFORMAT_ABGR8888",
+		             this, &texture
+		            );
+		return false;
+	}
+
+	int x0 = std::max(area.x, 0);
+	int y0 = std::max(area.y, 0);
+	int x1 = std::min(area.x + area.w, this->width);
+	int y1 = std::min(area.y + area.h, this->height);
+
+	if (x0 >= x1 || y0 >= y1) {
+		return true;
+	}
+
+	SDL_Rect rect = { x0, y0, x1 - x0, y1 - y0 };
+	void* pixels;
+	int pitch;
+
+	if (!texture.lock(&rect, &pixels, &pitch)) {
+		return false;
+	}
+
+	for (int y = y0; y < y1; y++) {
+		Uint32* row = (Uint32*)((Uint8*)pixels + (y - y0) * pitch);
+
+		for (int x = x0; x < x1; x++) {
+			int index = y * this->width + x;
+			Uint32 r = std::max(this->levels[LIGHT_RED][index], ambient.r);
+			Uint32 g = std::max(this->levels[LIGHT_GREEN][index], ambient.g);
+			Uint32 b = std::max(this->levels[LIGHT_BLUE][index], ambient.b);
+
+			row[x - x0] = 0xFF000000 | (b << 16) | (g << 8) | r;
+		}
+	}
+
+	texture.unlock();
+	return true;
+}
+
+/**
+ * @brief Forget which tiles changed, call after uploading getDirtyRect()
+ */
+void LightMap::clearDirty()
+{
+	this->dirtyX0 = this->dirtyY0 = std::numeric_limits<int>::max();
+	this->dirtyX1 = this->dirtyY1 = std::numeric_limits<int>::min();
+}
+
+/* ========= Getters =========*/
+
+Color LightMap::getColor(int x, int y) const
+{
+	return Color(getLevel(x, y, LIGHT_RED), getLevel(x, y, LIGHT_GREEN), getLevel(x, y, LIGHT_BLUE));
+}
+
+/**
+ * @brief Get the smallest area containing every tile whose light changed since clearDirty()
+ *
+ * @return the area in tiles, empty if nothing changed
+ */
+Rectangle LightMap::getDirtyRect() const
+{
+	if (this->dirtyX1 < this->dirtyX0) {
+		return Rectangle(0, 0, 0, 0);
+	}
+
+	return Rectangle(this->dirtyX0, this->dirtyY0, this->dirtyX1 - this->dirtyX0, this->dirtyY1 - this->dirtyY0);
+}
+
+int LightMap::getLightCount() const
+{
+	return (int)this->lights.size();
+}
+
+Uint8 LightMap::getFalloff() const
+{
+	return this->falloff;
+}
@@ -0,0 +1,95 @@
+#ifndef LIGHTMAP_H_
+#define LIGHTMAP_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <unordered_map>
+#include "TileGrid.h"
+#include "Texture.h"
+#include "Color.h"
+#include "Point.h"
+#include "Rectangle.h"
+
+namespace tiledl
+{
+	enum LightChannel {
+		LIGHT_RED,
+		LIGHT_GREEN,
+		LIGHT_BLUE,
+		LIGHT_CHANNELS
+	};
+
+	/**
+	 * Per tile light levels spread from point lights over a TileGrid.
+	 *
+	 * Light spreads to the 4 neighbours of a tile, losing falloff levels per
+	 * tile, and stops at opaque tiles. Each channel is one byte per tile.
+	 *
+	 * Adding or removing a light, or changing the opacity of a tile, only
+	 * visits the tiles whose light changes: removed light is cleared with a
+	 * flood that stops where brighter light from elsewhere is found, and that
+	 * light is then spread back into the cleared tiles.
+	 */
+	class LightMap
+	{
+	public:
+		LightMap(const TileGrid& grid);
+		LightMap(const TileGrid& grid, Uint8 falloff);
+		~LightMap();
+
+		void addLight(const Point& tile, const Color& color);
+		void removeLight(const Point& tile);
+		void update(const Point& tile);
+		void rebuild();
+
+		bool upload(Texture& texture, const Rectangle& area, const Color& ambient) const;
+		void clearDirty();
+
+		// Getters
+		Uint8 getLevel(int x, int y, LightChannel channel) const;
+		Color getColor(int x, int y) const;
+		Rectangle getDirtyRect() const;
+		int getLightCount() const;
+		Uint8 getFalloff() const;
+
+	private:
+		struct Light {
+			Uint8 level[LIGHT_CHANNELS];
+		};
+
+		struct RemoveEntry {
+			Sint32 index;
+			Uint8 level;
+		};
+
+		void prepare();
+		void seed(int channel, int index, Uint8 level);
+		void clear(int channel, int index);
+		void propagate(int channel);
+		void unpropagate(int channel);
+		void markDirty(int index);
+
+		const TileGrid* grid;
+		int width, height;
+		Uint8 falloff;
+		std::vector<Uint8> levels[LIGHT_CHANNELS];
+		std::unordered_map<Sint32, Light> lights;
+
+		std::vector<Sint32> addQueue;
+		std::vector<RemoveEntry> removeQueue;
+
+		int dirtyX0, dirtyY0, dirtyX1, dirtyY1;
+	};
+
+	inline Uint8 LightMap::getLevel(int x, int y, LightChannel channel) const
+	{
+		if ((unsigned)x >= (unsigned)this->width || (unsigned)y >= (unsigned)this->height) {
+			return 0;
+		}
+
+		return this->levels[channel][y * this->width + x];
+	}
+} // namespace tiledl
+
+#endif // LIGHTMAP_H_
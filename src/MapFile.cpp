@@ -0,0 +1,633 @@
+#include "MapFile.h"
+#include <sstream>
+#include <cstring>
+#include <stdexcept>
+#include <climits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TILEDL_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace tiledl;
+
+/*
+ * File layout, every value little endian:
+ *
+ * Header, HEADER_SIZE bytes
+ *   Uint32 magic            "TLDM"
+ *   Uint16 version          readers refuse versions newer than their own
+ *   Uint16 layers
+ *   Uint32 width, height    in tiles
+ *   Uint32 index offset     the header may grow in later versions
+ *   Uint32 property count
+ *   Uint64 property offset
+ *
+ * Chunk index, one entry per chunk in rows of chunks
+ *   Uint64 offset, Uint32 size of the chunk's block
+ *
+ * Chunk blocks, one TileChunk::write() per layer
+ *
+ * Properties
+ *   Uint16 key length, key, Uint32 value length, value
+ */
+static const Uint32 MAP_MAGIC = 0x4D444C54; // "TLDM"
+static const Uint32 HEADER_SIZE = 32;
+static const Uint32 INDEX_ENTRY_SIZE = 12;
+
+const Uint16 MapFile::VERSION;
+
+static inline Uint16 load16(const Uint8* p)
+{
+	Uint16 value;
+	memcpy(&value, p, sizeof(value));
+	return SDL_SwapLE16(value);
+}
+
+static inline Uint32 load32(const Uint8* p)
+{
+	Uint32 value;
+	memcpy(&value, p, sizeof(value));
+	return SDL_SwapLE32(value);
+}
+
+static inline Uint64 load64(const Uint8* p)
+{
+	Uint64 value;
+	memcpy(&value, p, sizeof(value));
+	return SDL_SwapLE64(value);
+}
+
+MapFile::MapFile()
+{
+	this->mapped = nullptr;
+	this->fileSize = 0;
+	this->file = nullptr;
+	this->version = 0;
+	this->width = this->height = this->layers = 0;
+	this->chunksWide = this->chunksHigh = 0;
+	this->indexOffset = 0;
+}
+
+MapFile::~MapFile()
+{
+	close();
+}
+
+/**
+ * @brief Open a map file, reading only its header and properties
+ *
+ * @return true on success, otherwise the file is left closed
+ */
+bool MapFile::open(const char* path)
+{
+	close();
+	this->path = path;
+
+#ifdef TILEDL_MMAP
+	int fd = ::open(path, O_RDONLY);
+
+	if (fd >= 0) {
+		struct stat info;
+
+		if (fstat(fd, &info) == 0 && info.st_size > 0) {
+			void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (data != MAP_FAILED) {
+				this->mapped = (const Uint8*)data;
+				this->fileSize = (size_t)info.st_size;
+			}
+		}
+
+		::close(fd);
+	}
+#endif
+
+	if (this->mapped == nullptr) {
+		this->file = SDL_RWFromFile(path, "rb");
+
+		if (this->file == nullptr) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile (%p) : Failed to open %s : %s",
+			             this, path, SDL_GetError());
+			return false;
+		}
+
+		Sint64 size = SDL_RWsize(this->file);
+		this->fileSize = (size > 0) ? (size_t)size : 0;
+	}
+
+	Uint8 header[HEADER_SIZE];
+
+	if (!readBytes(0, HEADER_SIZE, header) || load32(header) != MAP_MAGIC) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile (%p) : %s is not a map file", this, path);
+		close();
+		return false;
+	}
+
+	this->version = load16(header + 4);
+
+	if (this->version == 0 || this->version > VERSION) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile (%p) : %s is version %i, only up to %i is supported",
+		             this, path, this->version, VERSION);
+		close();
+		return false;
+	}
+
+	this->layers = load16(header + 6);
+	this->width = (int)load32(header + 8);
+	this->height = (int)load32(header + 12);
+	this->indexOffset = load32(header + 16);
+
+	if (this->width < 0 || this->height < 0) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile (%p) : %s is corrupt", this, path);
+		close();
+		return false;
+	}
+
+	// Chunks are numbered with an int
+	const Uint64 chunksWide = ((Uint64)this->width + TileChunk::SIZE - 1) / TileChunk::SIZE;
+	const Uint64 chunksHigh = ((Uint64)this->height + TileChunk::SIZE - 1) / TileChunk::SIZE;
+	const Uint64 indexSize = chunksWide * chunksHigh * INDEX_ENTRY_SIZE;
+
+	if (chunksWide * chunksHigh > INT_MAX || this->indexOffset < HEADER_SIZE ||
+	    this->indexOffset + indexSize > this->fileSize ||
+	    !readProperties(load64(header + 24), load32(header + 20))) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile (%p) : %s is corrupt", this, path);
+		close();
+		return false;
+	}
+
+	this->chunksWide = (int)chunksWide;
+	this->chunksHigh = (int)chunksHigh;
+	return true;
+}
+
+void MapFile::close()
+{
+#ifdef TILEDL_MMAP
+	if (this->mapped != nullptr) {
+		munmap((void*)this->mapped, this->fileSize);
+	}
+#endif
+
+	if (this->file != nullptr) {
+		SDL_RWclose(this->file);
+	}
+
+	this->mapped = nullptr;
+	this->file = nullptr;
+	this->fileSize = 0;
+	this->version = 0;
+	this->width = this->height = this->layers = 0;
+	this->chunksWide = this->chunksHigh = 0;
+	this->properties.clear();
+	this->buffer.clear();
+	this->buffer.shrink_to_fit();
+}
+
+bool MapFile::isOpen() const
+{
+	return this->mapped != nullptr || this->file != nullptr;
+}
+
+/**
+ * @brief Copy bytes of the file
+ *
+ * @return false if the range is outside of the file
+ */
+bool MapFile::readBytes(Uint64 offset, Uint32 size, void* dst)
+{
+	const Uint8* bytes = getBytes(offset, size);
+
+	if (bytes == nullptr) {
+		return false;
+	}
+
+	memcpy(dst, bytes, size);
+	return true;
+}
+
+/**
+ * @brief Get bytes of the file, from the mapping when there is one
+ *
+ * @return null if the range is outside of the file
+ * @note Only valid until the next call when the file is not mapped
+ */
+const Uint8* MapFile::getBytes(Uint64 offset, Uint32 size)
+{
+	if (offset > this->fileSize || size > this->fileSize - offset) {
+		return nullptr;
+	}
+
+	if (this->mapped != nullptr) {
+		return this->mapped + offset;
+	}
+
+	if (this->file == nullptr) {
+		return nullptr;
+	}
+
+	this->buffer.resize(size);
+
+	if (SDL_RWseek(this->file, (Sint64)offset, RW_SEEK_SET) < 0 ||
+	    (size > 0 && SDL_RWread(this->file, this->buffer.data(), size, 1) != 1)) {
+		return nullptr;
+	}
+
+	return this->buffer.data();
+}
+
+bool MapFile::readProperties(Uint64 offset, Uint32 count)
+{
+	for (Uint32 i = 0; i < count; i++) {
+		Uint8 length[4];
+
+		if (!readBytes(offset, 2, length)) {
+			return false;
+		}
+
+		// getBytes() checks the lengths against the file before anything is allocated for them
+		const Uint32 keySize = load16(length);
+		const Uint8* bytes = getBytes(offset + 2, keySize);
+
+		if (bytes == nullptr) {
+			return false;
+		}
+
+		std::string key((const char*)bytes, keySize);
+
+		if (!readBytes(offset + 2 + keySize, 4, length)) {
+			return false;
+		}
+
+		const Uint32 valueSize = load32(length);
+		offset += 6 + keySize;
+		bytes = getBytes(offset, valueSize);
+
+		if (bytes == nullptr) {
+			return false;
+		}
+
+		offset += valueSize;
+		this->properties[key] = std::string((const char*)bytes, valueSize);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Read every layer of one chunk
+ *
+ * @param cx column of the chunk
+ * @param cy row of the chunk
+ * @param layers filled with one TileChunk per layer
+ * @return false if the chunk is outside of the map or could not be read
+ */
+bool MapFile::readChunk(int cx, int cy, std::vector<TileChunk>& layers)
+{
+	if (!isOpen() || (unsigned)cx >= (unsigned)this->chunksWide || (unsigned)cy >= (unsigned)this->chunksHigh) {
+		return false;
+	}
+
+	Uint8 entry[INDEX_ENTRY_SIZE];
+	Uint64 index = (Uint64)cy * this->chunksWide + cx;
+
+	if (!readBytes(this->indexOffset + index * INDEX_ENTRY_SIZE, INDEX_ENTRY_SIZE, entry)) {
+		return false;
+	}
+
+	Uint32 size = load32(entry + 8);
+	const Uint8* block = getBytes(load64(entry), size);
+	SDL_RWops* src = (block != nullptr) ? SDL_RWFromConstMem(block, (int)size) : nullptr;
+
+	if (src == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile (%p) : Chunk %i, %i of %s is outside of the file",
+		             this, cx, cy, this->path.c_str());
+		return false;
+	}
+
+	bool ok = true;
+	layers.resize(this->layers);
+
+	for (int i = 0; ok && i < this->layers; i++) {
+		ok = layers[i].read(src);
+	}
+
+	SDL_RWclose(src);
+
+	if (!ok) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile (%p) : Chunk %i, %i of %s is corrupt",
+		             this, cx, cy, this->path.c_str());
+	}
+
+	return ok;
+}
+
+/**
+ * @brief Read the whole map
+ *
+ * @note Prefer readChunk() or a ChunkStreamer for large maps
+ */
+bool MapFile::load(TileStorage& storage)
+{
+	if (!isOpen()) {
+		return false;
+	}
+
+	std::vector<TileChunk> chunk;
+	storage.resize(this->width, this->height, this->layers);
+
+	for (int cy = 0; cy < this->chunksHigh; cy++) {
+		for (int cx = 0; cx < this->chunksWide; cx++) {
+			if (!readChunk(cx, cy, chunk)) {
+				return false;
+			}
+
+			for (int i = 0; i < this->layers; i++) {
+				storage.getChunk(i, cx, cy) = chunk[i];
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Read a chunk for a ChunkStreamer
+ */
+bool MapFile::read(const Point& chunk, std::vector<TileChunk>& layers)
+{
+	return readChunk(chunk.x, chunk.y, layers);
+}
+
+/**
+ * @brief Map files are read only, use save() to write a whole map
+ *
+ * @return false
+ */
+bool MapFile::write(const Point& chunk, const std::vector<TileChunk>&)
+{
+	SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile (%p) : Cannot write chunk %i, %i, map files are read only",
+	             this, chunk.x, chunk.y);
+	return false;
+}
+
+/**
+ * @brief Map files are read only as a ChunkSource, a ChunkStreamer drops
+ * edited chunks instead of keeping them to write
+ */
+bool MapFile::isReadOnly() const
+{
+	return true;
+}
+
+/**
+ * @brief Write a map file
+ *
+ * @param path file to create or replace
+ * @param storage tiles of the map, chunks are compacted as they are written
+ * @param properties string properties of the map, such as its name
+ * @return true on success
+ */
+bool MapFile::save(const char* path, const TileStorage& storage, const std::map<std::string, std::string>& properties)
+{
+	if (storage.getLayerCount() > 0xFFFF) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : Too many layers to save %s", path);
+		return false;
+	}
+
+	SDL_RWops* dst = SDL_RWFromFile(path, "wb");
+
+	if (dst == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : Failed to open %s : %s", path, SDL_GetError());
+		return false;
+	}
+
+	const int count = storage.getChunksWide() * storage.getChunksHigh();
+	std::vector<Uint64> offsets(count);
+	std::vector<Uint32> sizes(count);
+
+	// Header and index are written last, once the offsets are known
+	std::vector<Uint8> zeros(HEADER_SIZE + (size_t)count * INDEX_ENTRY_SIZE, 0);
+	bool ok = (SDL_RWwrite(dst, zeros.data(), zeros.size(), 1) == 1);
+
+	for (int i = 0; ok && i < count; i++) {
+		offsets[i] = (Uint64)SDL_RWtell(dst);
+
+		for (int layer = 0; ok && layer < storage.getLayerCount(); layer++) {
+			TileChunk chunk(storage.getChunk(layer, i % storage.getChunksWide(), i / storage.getChunksWide()));
+			chunk.compact();
+			ok = chunk.write(dst);
+		}
+
+		sizes[i] = (Uint32)((Uint64)SDL_RWtell(dst) - offsets[i]);
+	}
+
+	Uint64 propertyOffset = (Uint64)SDL_RWtell(dst);
+
+	for (auto it = properties.begin(); ok && it != properties.end(); it++) {
+		ok = it->first.size() <= 0xFFFF && SDL_WriteLE16(dst, (Uint16)it->first.size()) == 1 &&
+		     (it->first.empty() || SDL_RWwrite(dst, it->first.data(), it->first.size(), 1) == 1) &&
+		     SDL_WriteLE32(dst, (Uint32)it->second.size()) == 1 &&
+		     (it->second.empty() || SDL_RWwrite(dst, it->second.data(), it->second.size(), 1) == 1);
+	}
+
+	ok = ok && SDL_RWseek(dst, 0, RW_SEEK_SET) == 0 &&
+	     SDL_WriteLE32(dst, MAP_MAGIC) == 1 &&
+	     SDL_WriteLE16(dst, VERSION) == 1 &&
+	     SDL_WriteLE16(dst, (Uint16)storage.getLayerCount()) == 1 &&
+	     SDL_WriteLE32(dst, (Uint32)storage.getWidth()) == 1 &&
+	     SDL_WriteLE32(dst, (Uint32)storage.getHeight()) == 1 &&
+	     SDL_WriteLE32(dst, HEADER_SIZE) == 1 &&
+	     SDL_WriteLE32(dst, (Uint32)properties.size()) == 1 &&
+	     SDL_WriteLE64(dst, propertyOffset) == 1;
+
+	for (int i = 0; ok && i < count; i++) {
+		ok = (SDL_WriteLE64(dst, offsets[i]) == 1 && SDL_WriteLE32(dst, sizes[i]) == 1);
+	}
+
+	if (!ok) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : Failed to write %s : %s", path, SDL_GetError());
+	}
+
+	SDL_RWclose(dst);
+	return ok;
+}
+
+/**
+ * @brief Parse the text layout of a map
+ *
+ * Blank lines and lines starting with # are ignored, otherwise:
+ *
+ *     size <width> <height> <layers>
+ *     property <key> <value, to the end of the line>
+ *     layer <index>
+ *     <height lines of width tile ids, separated by spaces>
+ *
+ * size must come before any layer, layers not given are left as 0.
+ *
+ * @return true on success, errors are logged with their line number
+ */
+bool MapFile::parseText(const std::string& text, TileStorage& storage, std::map<std::string, std::string>& properties)
+{
+	std::istringstream lines(text);
+	std::string line;
+	int number = 0;
+	int layer = -1, row = 0;
+	bool sized = false;
+
+	while (std::getline(lines, line)) {
+		number++;
+		std::istringstream tokens(line);
+		std::string keyword;
+
+		if (!(tokens >> keyword) || keyword[0] == '#') {
+			continue;
+		}
+
+		if (layer >= 0 && row < storage.getHeight()) {
+			// keyword is the first id of the row
+			tokens.seekg(0);
+
+			for (int x = 0; x < storage.getWidth(); x++) {
+				Uint32 id;
+
+				if (!(tokens >> id)) {
+					SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : line %i : Expected %i tile ids",
+					             number, storage.getWidth());
+					return false;
+				}
+
+				storage.set(layer, x, row, id);
+			}
+
+			row++;
+		} else if (keyword == "size") {
+			int width = -1, height = -1, layers = -1;
+			tokens >> width >> height >> layers;
+
+			if (sized || width < 0 || height < 0 || layers <= 0 || layers > 0xFFFF) {
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : line %i : Invalid size", number);
+				return false;
+			}
+
+			storage.resize(width, height, layers);
+			sized = true;
+		} else if (keyword == "property") {
+			std::string key, value;
+			tokens >> key;
+			std::getline(tokens >> std::ws, value);
+
+			if (key.empty()) {
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : line %i : Property without a key", number);
+				return false;
+			}
+
+			properties[key] = value;
+		} else if (keyword == "layer") {
+			layer = -1;
+			tokens >> layer;
+
+			if (!sized || layer < 0 || layer >= storage.getLayerCount()) {
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : line %i : Invalid layer", number);
+				return false;
+			}
+
+			row = 0;
+		} else {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : line %i : Unknown keyword %s",
+			             number, keyword.c_str());
+			return false;
+		}
+	}
+
+	if (!sized || (layer >= 0 && row < storage.getHeight())) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : Map text ended early");
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Convert a map from the text layout of parseText() into a map file
+ */
+bool MapFile::convert(const char* textPath, const char* mapPath)
+{
+	SDL_RWops* src = SDL_RWFromFile(textPath, "rb");
+
+	if (src == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "MapFile : Failed to open %s : %s", textPath, SDL_GetError());
+		return false;
+	}
+
+	Sint64 size = SDL_RWsize(src);
+	std::string text(size > 0 ? (size_t)size : 0, '\0');
+	bool ok = (text.empty() || SDL_RWread(src, &text[0], text.size(), 1) == 1);
+	SDL_RWclose(src);
+
+	TileStorage storage;
+	std::map<std::string, std::string> properties;
+
+	return ok && parseText(text, storage, properties) && save(mapPath, storage, properties);
+}
+
+/* ========= Getters =========*/
+
+/**
+ * @brief Get if the open file is memory mapped rather than read on demand
+ */
+bool MapFile::isMapped() const
+{
+	return this->mapped != nullptr;
+}
+
+/**
+ * @brief Get the version the open file was written with
+ */
+int MapFile::getVersion() const
+{
+	return this->version;
+}
+
+int MapFile::getWidth() const
+{
+	return this->width;
+}
+
+int MapFile::getHeight() const
+{
+	return this->height;
+}
+
+int MapFile::getLayerCount() const
+{
+	return this->layers;
+}
+
+int MapFile::getChunksWide() const
+{
+	return this->chunksWide;
+}
+
+int MapFile::getChunksHigh() const
+{
+	return this->chunksHigh;
+}
+
+/**
+ * @return the value of the property, empty if the map does not have it
+ */
+std::string MapFile::getProperty(const std::string& key) const
+{
+	auto it = this->properties.find(key);
+	return (it == this->properties.end()) ? std::string() : it->second;
+}
+
+const std::map<std::string, std::string>& MapFile::getProperties() const
+{
+	return this->properties;
+}
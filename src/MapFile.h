@@ -0,0 +1,86 @@
+#ifndef MAPFILE_H_
+#define MAPFILE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "ChunkSource.h"
+#include "TileStorage.h"
+#include "TileChunk.h"
+#include "Point.h"
+
+namespace tiledl
+{
+	/**
+	 * A binary map file that any chunk can be read from without reading the
+	 * rest of the file.
+	 *
+	 * The file is a fixed header, a table with the offset and size of every
+	 * chunk, the palette compressed chunks themselves and a table of string
+	 * properties. Opening a map only reads the header and the properties, the
+	 * file is memory mapped where the platform allows it so reading a chunk
+	 * touches only the pages it is stored in.
+	 *
+	 * All values are little endian, see MapFile.cpp for the exact layout.
+	 */
+	class MapFile : public ChunkSource
+	{
+	public:
+		static const Uint16 VERSION = 1;
+
+		MapFile();
+		~MapFile();
+
+		bool open(const char* path);
+		void close();
+		bool isOpen() const;
+
+		bool readChunk(int cx, int cy, std::vector<TileChunk>& layers);
+		bool load(TileStorage& storage);
+
+		bool read(const Point& chunk, std::vector<TileChunk>& layers);
+		bool write(const Point& chunk, const std::vector<TileChunk>& layers);
+		bool isReadOnly() const;
+
+		static bool save(const char* path, const TileStorage& storage,
+		                 const std::map<std::string, std::string>& properties);
+		static bool parseText(const std::string& text, TileStorage& storage,
+		                      std::map<std::string, std::string>& properties);
+		static bool convert(const char* textPath, const char* mapPath);
+
+		// Getters
+		bool isMapped() const;
+		int getVersion() const;
+		int getWidth() const;
+		int getHeight() const;
+		int getLayerCount() const;
+		int getChunksWide() const;
+		int getChunksHigh() const;
+		std::string getProperty(const std::string& key) const;
+		const std::map<std::string, std::string>& getProperties() const;
+
+	private:
+		MapFile(const MapFile&);
+		MapFile& operator=(const MapFile&);
+
+		bool readBytes(Uint64 offset, Uint32 size, void* dst);
+		const Uint8* getBytes(Uint64 offset, Uint32 size);
+		bool readProperties(Uint64 offset, Uint32 count);
+
+		std::string path;
+		const Uint8* mapped;
+		size_t fileSize;
+		SDL_RWops* file; // used instead of mapped when the file could not be mapped
+		std::vector<Uint8> buffer;
+
+		int version;
+		int width, height, layers;
+		int chunksWide, chunksHigh;
+		Uint64 indexOffset;
+		std::map<std::string, std::string> properties;
+	};
+} // namespace tiledl
+
+#endif // MAPFILE_H_
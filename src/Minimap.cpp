@@ -0,0 +1,313 @@
+#include "Minimap.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace tiledl;
+
+static Rectangle unite(const Rectangle& a, const Rectangle& b)
+{
+	if (a.w <= 0 || a.h <= 0) {
+		return b;
+	}
+
+	if (b.w <= 0 || b.h <= 0) {
+		return a;
+	}
+
+	const int x0 = std::min(a.x, b.x), y0 = std::min(a.y, b.y);
+	const int x1 = std::max(a.x + a.w, b.x + b.w), y1 = std::max(a.y + a.h, b.y + b.h);
+	return Rectangle(x0, y0, x1 - x0, y1 - y0);
+}
+
+/**
+ * @brief Average four pixels of 8 bits per channel, in any channel order
+ *
+ * Alternate bytes are summed together in 16-bit lanes, which cannot carry
+ * into each other, so every channel is averaged at once.
+ */
+static inline Uint32 average(Uint32 a, Uint32 b, Uint32 c, Uint32 d)
+{
+	const Uint32 even = (a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF) + 0x00020002;
+	const Uint32 odd = ((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF) + ((c >> 8) & 0x00FF00FF) +
+	                   ((d >> 8) & 0x00FF00FF) + 0x00020002;
+
+	return ((even >> 2) & 0x00FF00FF) | (((odd >> 2) & 0x00FF00FF) << 8);
+}
+
+/**
+ * @param tiles the tiles to show, must outlive the Minimap
+ * @param layer layer of the tiles to show
+ */
+Minimap::Minimap(const TileStorage& tiles, int layer) : defaultColor(0, 0, 0, 255)
+{
+	if ((unsigned)layer >= (unsigned)tiles.getLayerCount()) {
+		throw std::out_of_range("Minimap layer is outside of the TileStorage");
+	}
+
+	this->tiles = &tiles;
+	this->layer = layer;
+	rebuild();
+}
+
+Minimap::~Minimap()
+{
+
+}
+
+/**
+ * @brief Recolour every tile and every level
+ */
+void Minimap::rebuild()
+{
+	const int width = std::max(this->tiles->getWidth(), 1);
+	const int height = std::max(this->tiles->getHeight(), 1);
+
+	if (this->levels.empty() || this->levels[0]->getWidth() != width || this->levels[0]->getHeight() != height) {
+		this->levels.clear();
+
+		for (int w = width, h = height;; w = (w + 1) / 2, h = (h + 1) / 2) {
+			this->levels.emplace_back(new Surface(w, h));
+
+			if (w == 1 && h == 1) {
+				break;
+			}
+		}
+	}
+
+	this->uploadRects.assign(this->levels.size(), Rectangle(0, 0, 0, 0));
+	this->dirty = Rectangle(0, 0, 0, 0);
+
+	recolour(Rectangle(0, 0, this->tiles->getWidth(), this->tiles->getHeight()));
+
+	for (int level = 1; level < (int)this->levels.size(); level++) {
+		downsample(level, Rectangle(0, 0, this->levels[level]->getWidth(), this->levels[level]->getHeight()));
+	}
+}
+
+void Minimap::markDirty(int x, int y)
+{
+	markDirty(Rectangle(x, y, 1, 1));
+}
+
+/**
+ * @brief Recolour an area of tiles on the next update()
+ */
+void Minimap::markDirty(const Rectangle& area)
+{
+	this->dirty = unite(this->dirty, area);
+}
+
+/**
+ * @brief Recolour the dirty tiles and the pixels over them in every level
+ */
+void Minimap::update()
+{
+	if (this->levels[0]->getWidth() != std::max(this->tiles->getWidth(), 1) ||
+	    this->levels[0]->getHeight() != std::max(this->tiles->getHeight(), 1)) {
+		rebuild();
+		return;
+	}
+
+	// Clip to the tiles
+	const int x0 = std::max(this->dirty.x, 0), y0 = std::max(this->dirty.y, 0);
+	const int x1 = std::min(this->dirty.x + this->dirty.w, this->tiles->getWidth());
+	const int y1 = std::min(this->dirty.y + this->dirty.h, this->tiles->getHeight());
+	this->dirty = Rectangle(0, 0, 0, 0);
+
+	if (x1 <= x0 || y1 <= y0) {
+		return;
+	}
+
+	Rectangle area(x0, y0, x1 - x0, y1 - y0);
+	recolour(area);
+
+	for (int level = 1; level < (int)this->levels.size(); level++) {
+		const int left = area.x / 2, top = area.y / 2;
+		area = Rectangle(left, top, (area.x + area.w - 1) / 2 - left + 1, (area.y + area.h - 1) / 2 - top + 1);
+		downsample(level, area);
+	}
+}
+
+/**
+ * @brief Write the colour of every tile in an area into level 0
+ */
+void Minimap::recolour(const Rectangle& area)
+{
+	Surface& surface = *this->levels[0];
+	surface.lock();
+
+	Uint8* pixels = (Uint8*)surface.getPixels();
+	const int pitch = surface.getPitch();
+	Uint32 lastId = 0, lastPixel = toPixel(0);
+
+	for (int y = area.y; y < area.y + area.h; y++) {
+		Uint32* row = (Uint32*)(pixels + y * pitch);
+
+		for (int x = area.x; x < area.x + area.w; x++) {
+			const Uint32 id = this->tiles->get(this->layer, x, y);
+
+			// Tiles mostly come in runs of the same id
+			if (id != lastId) {
+				lastId = id;
+				lastPixel = toPixel(id);
+			}
+
+			row[x] = lastPixel;
+		}
+	}
+
+	surface.unlock();
+	this->uploadRects[0] = unite(this->uploadRects[0], area);
+}
+
+/**
+ * @brief Average an area of a level from the 2x2 blocks of the level before it
+ */
+void Minimap::downsample(int level, const Rectangle& area)
+{
+	Surface& src = *this->levels[level - 1];
+	Surface& dst = *this->levels[level];
+	src.lock();
+	dst.lock();
+
+	const Uint8* srcPixels = (const Uint8*)src.getPixels();
+	Uint8* dstPixels = (Uint8*)dst.getPixels();
+	const int srcPitch = src.getPitch(), dstPitch = dst.getPitch();
+	const int lastX = src.getWidth() - 1, lastY = src.getHeight() - 1;
+
+	for (int y = area.y; y < area.y + area.h; y++) {
+		// Odd sizes repeat their last row and column
+		const Uint32* top = (const Uint32*)(srcPixels + std::min(y * 2, lastY) * srcPitch);
+		const Uint32* bottom = (const Uint32*)(srcPixels + std::min(y * 2 + 1, lastY) * srcPitch);
+		Uint32* row = (Uint32*)(dstPixels + y * dstPitch);
+
+		for (int x = area.x; x < area.x + area.w; x++) {
+			const int left = std::min(x * 2, lastX), right = std::min(x * 2 + 1, lastX);
+			row[x] = average(top[left], top[right], bottom[left], bottom[right]);
+		}
+	}
+
+	dst.unlock();
+	src.unlock();
+	this->uploadRects[level] = unite(this->uploadRects[level], area);
+}
+
+Uint32 Minimap::toPixel(Uint32 id) const
+{
+	Color color = getColor(id);
+	return SDL_MapRGBA(this->levels[0]->getFormat(), color.r, color.g, color.b, color.a);
+}
+
+/**
+ * @brief Stream a level into a texture, only the area changed since the last upload
+ *
+ * @param renderer renderer to create the texture with when it is not the size of the level
+ * @param texture texture to upload into, drawn with a single Renderer::copy
+ * @param level level to upload, such as findLevel() of the area it is drawn in
+ * @return true on success
+ */
+bool Minimap::upload(Renderer& renderer, Texture& texture, int level)
+{
+	Surface& surface = *this->levels.at(level);
+	Rectangle area = this->uploadRects[level];
+
+	if (texture.isNull() || texture.getWidth() != surface.getWidth() || texture.getHeight() != surface.getHeight()) {
+		if (!texture.create(renderer.getHandle(), surface.getFormat()->format, SDL_TEXTUREACCESS_STREAMING,
+		                    surface.getWidth(), surface.getHeight())) {
+			return false;
+		}
+
+		area = Rectangle(0, 0, surface.getWidth(), surface.getHeight());
+	}
+
+	if (area.w <= 0 || area.h <= 0) {
+		return true;
+	}
+
+	surface.lock();
+	const Uint8* pixels = (const Uint8*)surface.getPixels() + area.y * surface.getPitch() + area.x * 4;
+	bool ok = texture.updateTexture(&area, pixels, surface.getPitch());
+	surface.unlock();
+
+	if (ok) {
+		this->uploadRects[level] = Rectangle(0, 0, 0, 0);
+	}
+
+	return ok;
+}
+
+/**
+ * @brief Find the largest level that fits in an area
+ *
+ * @return the level, the 1x1 level if none fit
+ */
+int Minimap::findLevel(int width, int height) const
+{
+	for (int level = 0; level < (int)this->levels.size(); level++) {
+		if (this->levels[level]->getWidth() <= width && this->levels[level]->getHeight() <= height) {
+			return level;
+		}
+	}
+
+	return (int)this->levels.size() - 1;
+}
+
+/* ========= Getters =========*/
+
+int Minimap::getLevelCount() const
+{
+	return (int)this->levels.size();
+}
+
+/**
+ * @brief Get a level, 0 is one pixel per tile and each level after it is half the size
+ */
+Surface& Minimap::getLevel(int level)
+{
+	return *this->levels.at(level);
+}
+
+/**
+ * @brief Get the tiles to recolour on the next update(), w is 0 if none
+ */
+Rectangle Minimap::getDirtyRect() const
+{
+	return this->dirty;
+}
+
+Color Minimap::getColor(Uint32 id) const
+{
+	auto it = this->colors.find(id);
+	return (it == this->colors.end()) ? this->defaultColor : it->second;
+}
+
+Color Minimap::getDefaultColor() const
+{
+	return this->defaultColor;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @note Call rebuild() after changing colours
+ */
+void Minimap::setColor(Uint32 id, Color color)
+{
+	auto it = this->colors.find(id);
+
+	if (it == this->colors.end()) {
+		this->colors.insert(std::make_pair(id, color));
+	} else {
+		it->second = color;
+	}
+}
+
+/**
+ * @brief Set the colour of every id without its own colour
+ *
+ * @note Call rebuild() after changing colours
+ */
+void Minimap::setDefaultColor(Color color)
+{
+	this->defaultColor = color;
+}
@@ -0,0 +1,68 @@
+#ifndef MINIMAP_H_
+#define MINIMAP_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "TileStorage.h"
+#include "Surface.h"
+#include "Texture.h"
+#include "Renderer.h"
+#include "Rectangle.h"
+#include "Color.h"
+
+namespace tiledl
+{
+	/**
+	 * An overview of a layer of tiles, one pixel per tile, with every
+	 * smaller size down to a single pixel.
+	 *
+	 * Level 0 is the full size Surface and each level after it halves the
+	 * one before by averaging 2x2 blocks of pixels. Tiles marked dirty only
+	 * recolour their own pixel and the pixels above it in each level, and
+	 * upload() only streams the changed area into the Texture.
+	 */
+	class Minimap
+	{
+	public:
+		Minimap(const TileStorage& tiles, int layer);
+		~Minimap();
+
+		void rebuild();
+		void markDirty(int x, int y);
+		void markDirty(const Rectangle& area);
+		void update();
+
+		bool upload(Renderer& renderer, Texture& texture, int level);
+		int findLevel(int width, int height) const;
+
+		// Getters
+		int getLevelCount() const;
+		Surface& getLevel(int level);
+		Rectangle getDirtyRect() const;
+		Color getColor(Uint32 id) const;
+		Color getDefaultColor() const;
+
+		// Setters
+		void setColor(Uint32 id, Color color);
+		void setDefaultColor(Color color);
+
+	private:
+		void recolour(const Rectangle& area);
+		void downsample(int level, const Rectangle& area);
+		Uint32 toPixel(Uint32 id) const;
+
+		const TileStorage* tiles;
+		int layer;
+		std::vector<std::unique_ptr<Surface>> levels;
+		std::vector<Rectangle> uploadRects; // per level, changed since the last upload
+
+		std::unordered_map<Uint32, Color> colors;
+		Color defaultColor;
+		Rectangle dirty; // tiles to recolour, w == 0 if none
+	};
+} // namespace tiledl
+
+#endif // MINIMAP_H_
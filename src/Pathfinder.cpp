@@ -0,0 +1,452 @@
+#include "Pathfinder.h"
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+
+using namespace tiledl;
+
+const Uint32 Pathfinder::STRAIGHT_COST;
+const Uint32 Pathfinder::DIAGONAL_COST;
+
+static const int DIRECTIONS[8][2] = {
+	{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+	{ 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 }
+};
+
+static inline int sign(int value)
+{
+	return (value > 0) - (value < 0);
+}
+
+/**
+ * @brief Orders the open list as a min-heap on f, preferring deeper nodes on ties
+ */
+static inline bool open_entry_less(const Uint32 af, const Uint32 ag, const Uint32 bf, const Uint32 bg)
+{
+	return af > bf || (af == bf && ag < bg);
+}
+
+/**
+ * @param grid the grid to search, must outlive the Pathfinder
+ */
+Pathfinder::Pathfinder(const TileGrid& grid)
+{
+	this->grid = &grid;
+	this->generation = 0;
+	this->width = this->height = 0;
+	this->goal = -1;
+	this->pathCost = 0;
+	this->expanded = 0;
+}
+
+Pathfinder::~Pathfinder()
+{
+
+}
+
+/**
+ * @brief Octile distance between two tiles, the exact cost of an unobstructed path
+ */
+Uint32 Pathfinder::distance(const Point& a, const Point& b)
+{
+	Uint32 dx = (Uint32)std::abs(a.x - b.x);
+	Uint32 dy = (Uint32)std::abs(a.y - b.y);
+
+	return STRAIGHT_COST * std::max(dx, dy) + (DIAGONAL_COST - STRAIGHT_COST) * std::min(dx, dy);
+}
+
+/**
+ * @brief Find a path using A*
+ *
+ * @see findPath(const Point&, const Point&, std::vector<Point>&, PathAlgorithm)
+ */
+bool Pathfinder::findPath(const Point& start, const Point& goal, std::vector<Point>& path)
+{
+	return findPath(start, goal, path, PATH_ASTAR);
+}
+
+/**
+ * @brief Find the shortest path between two tiles
+ *
+ * @param start tile to start from
+ * @param goal tile to reach
+ * @param path filled with every tile from start to goal, inclusive
+ * @param algorithm search to use, both produce paths of equal cost
+ * @return true if a path was found, otherwise false and path is empty
+ * @note the path is in tiles, use toPixels() before drawing it with Renderer::drawLines
+ */
+bool Pathfinder::findPath(const Point& start, const Point& goal, std::vector<Point>& path, PathAlgorithm algorithm)
+{
+	path.clear();
+	this->pathCost = 0;
+	this->expanded = 0;
+
+	if (!isPassable(start.x, start.y) || !isPassable(goal.x, goal.y)) {
+		return false;
+	}
+
+	prepare();
+
+	int startIndex = start.y * this->width + start.x;
+	int goalIndex = goal.y * this->width + goal.x;
+
+	if (!search(startIndex, goalIndex, algorithm)) {
+		return false;
+	}
+
+	buildPath(goalIndex, path);
+	return true;
+}
+
+/**
+ * @brief Convert a path of tiles into the pixel centres of those tiles
+ */
+void Pathfinder::toPixels(std::vector<Point>& path) const
+{
+	for (auto& pt : path) {
+		pt = this->grid->getTileCenter(pt);
+	}
+}
+
+/**
+ * @brief (Re)allocate node storage when the grid changed size
+ */
+void Pathfinder::prepare()
+{
+	if (this->width == this->grid->getWidth() && this->height == this->grid->getHeight()) {
+		return;
+	}
+
+	this->width = this->grid->getWidth();
+	this->height = this->grid->getHeight();
+
+	Node empty = { 0, 0, -1, false };
+	this->nodes.assign((size_t)this->width * this->height, empty);
+	this->generation = 0;
+}
+
+bool Pathfinder::search(int start, int goal, PathAlgorithm algorithm)
+{
+	this->generation++;
+
+	if (this->generation == 0) {
+		// Wrapped around, stale nodes could now look current
+		for (auto& node : this->nodes) {
+			node.generation = 0;
+		}
+
+		this->generation = 1;
+	}
+
+	this->goal = goal;
+	this->openList.clear();
+	open(start, -1, 0);
+
+	auto compare = [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.f, a.g, b.f, b.g);
+	};
+
+	while (!this->openList.empty()) {
+		std::pop_heap(this->openList.begin(), this->openList.end(), compare);
+		OpenEntry entry = this->openList.back();
+		this->openList.pop_back();
+
+		Node& node = this->nodes[entry.index];
+
+		// Entries are never removed from the heap, skip the outdated ones
+		if (node.closed || entry.g != node.g) {
+			continue;
+		}
+
+		node.closed = true;
+		this->expanded++;
+
+		if (entry.index == goal) {
+			this->pathCost = node.g;
+			return true;
+		}
+
+		if (algorithm == PATH_JUMP_POINT) {
+			expandJumpPoints(entry.index);
+		} else {
+			expandNeighbours(entry.index);
+		}
+	}
+
+	return false;
+}
+
+void Pathfinder::open(int index, int parent, Uint32 g)
+{
+	Node& node = this->nodes[index];
+
+	if (node.generation != this->generation) {
+		node.generation = this->generation;
+		node.g = std::numeric_limits<Uint32>::max();
+		node.parent = -1;
+		node.closed = false;
+	}
+
+	if (node.closed || g >= node.g) {
+		return;
+	}
+
+	node.g = g;
+	node.parent = parent;
+
+	Point pt(index % this->width, index / this->width);
+	Point target(this->goal % this->width, this->goal / this->width);
+	OpenEntry entry = { g + distance(pt, target), g, index };
+
+	this->openList.push_back(entry);
+	std::push_heap(this->openList.begin(), this->openList.end(), [](const OpenEntry & a, const OpenEntry & b) {
+		return open_entry_less(a.f, a.g, b.f, b.g);
+	});
+}
+
+void Pathfinder::expandNeighbours(int index)
+{
+	const int x = index % this->width;
+	const int y = index / this->width;
+	const Uint32 g = this->nodes[index].g;
+
+	for (int i = 0; i < 8; i++) {
+		int dx = DIRECTIONS[i][0];
+		int dy = DIRECTIONS[i][1];
+
+		if (!isPassable(x + dx, y + dy)) {
+			continue;
+		}
+
+		if (dx != 0 && dy != 0) {
+			if (!isPassable(x + dx, y) || !isPassable(x, y + dy)) {
+				continue;
+			}
+
+			open(index + dy * this->width + dx, index, g + DIAGONAL_COST);
+		} else {
+			open(index + dy * this->width + dx, index, g + STRAIGHT_COST);
+		}
+	}
+}
+
+/**
+ * @brief Expand a node with Jump Point Search
+ *
+ * Only the directions that can lead somewhere a shorter path through the
+ * parent could not are followed, and each is followed until the next jump
+ * point, so long open stretches are crossed without touching the open list.
+ */
+void Pathfinder::expandJumpPoints(int index)
+{
+	const Node& node = this->nodes[index];
+	const int x = index % this->width;
+	const int y = index / this->width;
+
+	int directions[8][2];
+	int count = 0;
+
+	auto add = [&](int dx, int dy) {
+		directions[count][0] = dx;
+		directions[count][1] = dy;
+		count++;
+	};
+
+	if (node.parent < 0) {
+		for (int i = 0; i < 8; i++) {
+			int dx = DIRECTIONS[i][0];
+			int dy = DIRECTIONS[i][1];
+
+			if (dx == 0 || dy == 0 || (isPassable(x + dx, y) && isPassable(x, y + dy))) {
+				add(dx, dy);
+			}
+		}
+	} else {
+		const int dx = sign(x - node.parent % this->width);
+		const int dy = sign(y - node.parent / this->width);
+
+		if (dx != 0 && dy != 0) {
+			bool vertical = isPassable(x, y + dy);
+			bool horizontal = isPassable(x + dx, y);
+
+			if (vertical) {
+				add(0, dy);
+			}
+
+			if (horizontal) {
+				add(dx, 0);
+			}
+
+			if (vertical && horizontal) {
+				add(dx, dy);
+			}
+		} else if (dx != 0) {
+			bool next = isPassable(x + dx, y);
+			bool below = isPassable(x, y + 1);
+			bool above = isPassable(x, y - 1);
+
+			if (next) {
+				add(dx, 0);
+
+				if (below) {
+					add(dx, 1);
+				}
+
+				if (above) {
+					add(dx, -1);
+				}
+			}
+
+			if (below) {
+				add(0, 1);
+			}
+
+			if (above) {
+				add(0, -1);
+			}
+		} else {
+			bool next = isPassable(x, y + dy);
+			bool right = isPassable(x + 1, y);
+			bool left = isPassable(x - 1, y);
+
+			if (next) {
+				add(0, dy);
+
+				if (right) {
+					add(1, dy);
+				}
+
+				if (left) {
+					add(-1, dy);
+				}
+			}
+
+			if (right) {
+				add(1, 0);
+			}
+
+			if (left) {
+				add(-1, 0);
+			}
+		}
+	}
+
+	const Point here(x, y);
+
+	for (int i = 0; i < count; i++) {
+		int dx = directions[i][0];
+		int dy = directions[i][1];
+		int jump = (dx != 0 && dy != 0) ? jumpDiagonal(x + dx, y + dy, dx, dy) : jumpStraight(x + dx, y + dy, dx, dy);
+
+		if (jump >= 0) {
+			Point target(jump % this->width, jump / this->width);
+			open(jump, index, node.g + distance(here, target));
+		}
+	}
+}
+
+/**
+ * @return index of the next jump point, or -1 if the line is blocked
+ */
+int Pathfinder::jumpStraight(int x, int y, int dx, int dy) const
+{
+	while (isPassable(x, y)) {
+		int index = y * this->width + x;
+
+		if (index == this->goal) {
+			return index;
+		}
+
+		// A forced neighbour can only be reached optimally through this tile
+		if (dx != 0) {
+			if ((isPassable(x, y - 1) && !isPassable(x - dx, y - 1)) ||
+			    (isPassable(x, y + 1) && !isPassable(x - dx, y + 1))) {
+				return index;
+			}
+		} else {
+			if ((isPassable(x - 1, y) && !isPassable(x - 1, y - dy)) ||
+			    (isPassable(x + 1, y) && !isPassable(x + 1, y - dy))) {
+				return index;
+			}
+		}
+
+		x += dx;
+		y += dy;
+	}
+
+	return -1;
+}
+
+/**
+ * @return index of the next jump point, or -1 if the line is blocked
+ */
+int Pathfinder::jumpDiagonal(int x, int y, int dx, int dy) const
+{
+	while (isPassable(x, y)) {
+		int index = y * this->width + x;
+
+		if (index == this->goal) {
+			return index;
+		}
+
+		if (jumpStraight(x + dx, y, dx, 0) >= 0 || jumpStraight(x, y + dy, 0, dy) >= 0) {
+			return index;
+		}
+
+		if (!isPassable(x + dx, y) || !isPassable(x, y + dy)) {
+			return -1;
+		}
+
+		x += dx;
+		y += dy;
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Walk the parents back from the goal, filling in the tiles between jump points
+ */
+void Pathfinder::buildPath(int goal, std::vector<Point>& path) const
+{
+	int index = goal;
+
+	while (index >= 0) {
+		Point pt(index % this->width, index / this->width);
+		int parent = this->nodes[index].parent;
+		path.push_back(pt);
+
+		if (parent >= 0) {
+			Point to(parent % this->width, parent / this->width);
+			Point step(sign(to.x - pt.x), sign(to.y - pt.y));
+
+			for (pt = pt + step; pt != to; pt = pt + step) {
+				path.push_back(pt);
+			}
+		}
+
+		index = parent;
+	}
+
+	std::reverse(path.begin(), path.end());
+}
+
+/* ========= Getters =========*/
+
+/**
+ * @brief Get the cost of the last path found
+ *
+ * @note STRAIGHT_COST per orthogonal step and DIAGONAL_COST per diagonal step
+ */
+Uint32 Pathfinder::getPathCost() const
+{
+	return this->pathCost;
+}
+
+/**
+ * @brief Get the number of nodes expanded by the last search
+ */
+int Pathfinder::getExpandedCount() const
+{
+	return this->expanded;
+}
@@ -0,0 +1,84 @@
+#ifndef PATHFINDER_H_
+#define PATHFINDER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "TileGrid.h"
+#include "Point.h"
+
+namespace tiledl
+{
+	enum PathAlgorithm {
+		PATH_ASTAR,
+		PATH_JUMP_POINT // Only valid for uniform cost grids, which TileGrid always is
+	};
+
+	/**
+	 * Finds 8-connected paths over the passable (non-solid) tiles of a TileGrid.
+	 * Diagonal moves may not cut the corner of a solid tile.
+	 *
+	 * Node storage is sized to the grid once and reused by every query, a
+	 * generation counter marks which nodes belong to the current query so
+	 * nothing is cleared between searches.
+	 */
+	class Pathfinder
+	{
+	public:
+		static const Uint32 STRAIGHT_COST = 10;
+		static const Uint32 DIAGONAL_COST = 14;
+
+		Pathfinder(const TileGrid& grid);
+		~Pathfinder();
+
+		bool findPath(const Point& start, const Point& goal, std::vector<Point>& path);
+		bool findPath(const Point& start, const Point& goal, std::vector<Point>& path, PathAlgorithm algorithm);
+
+		bool isPassable(int x, int y) const;
+		void toPixels(std::vector<Point>& path) const;
+
+		static Uint32 distance(const Point& a, const Point& b);
+
+		// Getters
+		Uint32 getPathCost() const;
+		int getExpandedCount() const;
+
+	private:
+		struct Node {
+			Uint32 generation;
+			Uint32 g;
+			Sint32 parent;
+			bool closed;
+		};
+
+		struct OpenEntry {
+			Uint32 f, g;
+			Sint32 index;
+		};
+
+		void prepare();
+		bool search(int start, int goal, PathAlgorithm algorithm);
+		void open(int index, int parent, Uint32 g);
+		void expandNeighbours(int index);
+		void expandJumpPoints(int index);
+		int jumpStraight(int x, int y, int dx, int dy) const;
+		int jumpDiagonal(int x, int y, int dx, int dy) const;
+		void buildPath(int goal, std::vector<Point>& path) const;
+
+		const TileGrid* grid;
+		std::vector<Node> nodes;
+		std::vector<OpenEntry> openList;
+		Uint32 generation;
+		int width, height;
+		int goal;
+		Uint32 pathCost;
+		int expanded;
+	};
+
+	inline bool Pathfinder::isPassable(int x, int y) const
+	{
+		return !this->grid->isSolid(x, y);
+	}
+} // namespace tiledl
+
+#endif // PATHFINDER_H_
@@ -1,15 +1,29 @@
 #include "Renderer.h"
 #include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
 
 using namespace tiledl;
 
+/**
+ * @return the calls that drew something, not counting presents and state changes
+ */
+Uint32 RenderStats::getDrawCalls() const
+{
+	return points + lines + rects + fills + copies + clears;
+}
+
 Renderer::Renderer()
 {
 	this->handle = nullptr;
+	resetStats();
 }
 
 Renderer::Renderer(SDL_Window* window, int index, Uint32 flags)
 {
+	this->handle = nullptr;
+	resetStats();
+
 	if (!init(window, index, flags)) {
 		throw std::runtime_error("Failed to init renderer");
 	}
@@ -17,6 +31,9 @@ Renderer::Renderer(SDL_Window* window, int index, Uint32 flags)
 
 Renderer::Renderer(Window window, int index, Uint32 flags)
 {
+	this->handle = nullptr;
+	resetStats();
+
 	if (!init(window, index, flags)) {
 		throw std::runtime_error("Failed to init renderer");
 	}
@@ -50,6 +67,39 @@ void Renderer::destroy()
 	}
 }
 
+/**
+ * @brief Zero the call counters, such as at the start of each frame
+ */
+void Renderer::resetStats()
+{
+	this->stats = RenderStats();
+	this->lastTexture = nullptr;
+}
+
+/**
+ * @brief Get the size of the texture being drawn into, or the output if none
+ */
+void Renderer::getTargetSize(int& w, int& h)
+{
+	// Asked from SDL each time, which forgets a target texture once it is destroyed
+	SDL_Texture* target = SDL_GetRenderTarget(this->handle);
+
+	if (target != nullptr) {
+		if (SDL_QueryTexture(target, nullptr, nullptr, &w, &h) != 0) {
+			w = h = 0;
+		}
+	} else if (SDL_GetRendererOutputSize(this->handle, &w, &h) != 0) {
+		w = h = 0;
+	}
+}
+
+Uint64 Renderer::getTargetArea()
+{
+	int w = 0, h = 0;
+	getTargetSize(w, h);
+	return (Uint64)std::max(w, 0) * std::max(h, 0);
+}
+
 inline void Renderer::null_check()
 {
 	if (this->isNull())
@@ -59,6 +109,7 @@ inline void Renderer::null_check()
 void Renderer::present()
 {
 	null_check();
+	this->stats.presents++;
 	SDL_RenderPresent(this->handle);
 }
 
@@ -66,6 +117,8 @@ void Renderer::present()
 void Renderer::clear()
 {
 	null_check();
+	this->stats.clears++;
+	this->stats.pixels += getTargetArea();
 	SDL_RenderClear(this->handle);
 }
 
@@ -99,14 +152,7 @@ bool Renderer::init(SDL_Window* window, int index, Uint32 flags)
 
 bool Renderer::initSW(SDL_Surface* surface)
 {
-	if (SDL_WasInit(SDL_INIT_VIDEO) == SDL_FALSE) {
-		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
-		             "Renderer (%p) : attempted to be created when SDL_INIT_VIDEO is not inited",
-		             this
-		            );
-		return false;
-	}
-
+	// A software renderer draws into the surface, so SDL_INIT_VIDEO is not needed
 	this->handle = SDL_CreateSoftwareRenderer(surface);
 
 	if (this->handle == NULL) {
@@ -125,6 +171,8 @@ bool Renderer::initSW(SDL_Surface* surface)
 void Renderer::drawPoint(int x, int y)
 {
 	null_check();
+	this->stats.points++;
+	this->stats.pixels++;
 
 	if (SDL_RenderDrawPoint(this->handle, x , y) != 0) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -136,17 +184,19 @@ void Renderer::drawPoint(int x, int y)
 
 void Renderer::drawPoint(SDL_Point pt)
 {
-	drawLine(pt.x, pt.y);
+	drawPoint(pt.x, pt.y);
 }
 
 void Renderer::drawPoint(const Vector& pt)
 {
-	drawLine((int)pt.x , (int)pt.y);
+	drawPoint((int)pt.x , (int)pt.y);
 }
 
 void Renderer::drawLine(int x1, int y1, int x2, int y2)
 {
 	null_check();
+	this->stats.lines++;
+	this->stats.pixels += std::max(std::abs(x2 - x1), std::abs(y2 - y1)) + 1;
 
 	if (SDL_RenderDrawLine(this->handle, x1 , y1, x2, y2) != 0) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -169,6 +219,13 @@ void Renderer::drawLine(const Vector& pt1, const Vector& pt2)
 void Renderer::drawLines(const SDL_Point* points, int count)
 {
 	null_check();
+	this->stats.lines++;
+
+	for (int i = 1; i < count; i++) {
+		this->stats.pixels += std::max(std::abs(points[i].x - points[i - 1].x), std::abs(points[i].y - points[i - 1].y));
+	}
+
+	this->stats.pixels += (count > 0) ? 1 : 0;
 
 	if (SDL_RenderDrawLines(this->handle, points, count) != 0) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -196,6 +253,20 @@ void Renderer::drawLines(const std::vector<Point>& points)
 void Renderer::drawRect(const SDL_Rect* rect)
 {
 	null_check();
+	this->stats.rects++;
+
+	int w = 0, h = 0;
+
+	if (rect == nullptr) {
+		getTargetSize(w, h);
+	} else {
+		w = rect->w;
+		h = rect->h;
+	}
+
+	if (w > 0 && h > 0) {
+		this->stats.pixels += std::min((Uint64)w * h, (Uint64)(2 * (w + h) - 4));
+	}
 
 	if (SDL_RenderDrawRect(this->handle, rect) != 0) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -220,6 +291,13 @@ void Renderer::drawRect(int x, int y, int w, int h)
 void Renderer::fillRect(const SDL_Rect* rect)
 {
 	null_check();
+	this->stats.fills++;
+
+	if (rect == nullptr) {
+		this->stats.pixels += getTargetArea();
+	} else if (rect->w > 0 && rect->h > 0) {
+		this->stats.pixels += (Uint64)rect->w * rect->h;
+	}
 
 	if (SDL_RenderFillRect(this->handle, rect) != 0) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -241,6 +319,35 @@ void Renderer::fillRect(int x, int y, int w, int h)
 	fillRect(&r);
 }
 
+void Renderer::copy(Texture& texture, const SDL_Rect* src, const SDL_Rect* dst)
+{
+	null_check();
+	this->stats.copies++;
+
+	if (texture.getHandle() != this->lastTexture) {
+		this->stats.textureSwitches++;
+		this->lastTexture = texture.getHandle();
+	}
+
+	if (dst == nullptr) {
+		this->stats.pixels += getTargetArea();
+	} else if (dst->w > 0 && dst->h > 0) {
+		this->stats.pixels += (Uint64)dst->w * dst->h;
+	}
+
+	if (SDL_RenderCopy(this->handle, texture.getHandle(), src, dst) != 0) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "Renderer (%p) : Error while copying Texture (%p) %s",
+		             this, &texture, SDL_GetError()
+		            );
+	}
+}
+
+void Renderer::copy(Texture& texture, const Rectangle& src, const Rectangle& dst)
+{
+	copy(texture, &src, &dst);
+}
+
 /* ========= Getters =========*/
 
 SDL_Renderer* Renderer::getHandle()
@@ -248,6 +355,67 @@ SDL_Renderer* Renderer::getHandle()
 	return this->handle;
 }
 
+/**
+ * @brief Get the calls made since the Renderer was created or resetStats() was called
+ */
+const RenderStats& Renderer::getStats() const
+{
+	return this->stats;
+}
+
+/**
+ * @return the texture being drawn into, null when drawing to the window
+ */
+SDL_Texture* Renderer::getTarget()
+{
+	null_check();
+	return SDL_GetRenderTarget(this->handle);
+}
+
+/**
+ * @return how draw calls other than copy() blend with the target
+ */
+SDL_BlendMode Renderer::getBlendMode()
+{
+	null_check();
+	SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+	SDL_GetRenderDrawBlendMode(this->handle, &blend);
+	return blend;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @brief Draw into a texture instead of the window
+ *
+ * @param texture a texture created with SDL_TEXTUREACCESS_TARGET
+ * @return true on success
+ */
+bool Renderer::setTarget(Texture& texture)
+{
+	return setTarget(texture.getHandle());
+}
+
+/**
+ * @param texture a texture created with SDL_TEXTUREACCESS_TARGET, null to draw to the window again
+ * @return true on success
+ */
+bool Renderer::setTarget(SDL_Texture* texture)
+{
+	null_check();
+	this->stats.targetChanges++;
+
+	if (SDL_SetRenderTarget(this->handle, texture) != 0) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "Renderer (%p) : Error while setting render target to Texture (%p) %s",
+		             this, texture, SDL_GetError()
+		            );
+		return false;
+	}
+
+	return true;
+}
+
 void Renderer::setDrawColor(SDL_Color color)
 {
 	setDrawColor(color.r, color.g, color.b, color.a);
@@ -261,6 +429,7 @@ void Renderer::setDrawColor(Color color)
 void Renderer::setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
 	null_check();
+	this->stats.colorChanges++;
 
 	if (SDL_SetRenderDrawColor(handle, r, g , b, a) != 0) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -270,3 +439,19 @@ void Renderer::setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 	}
 }
 
+/**
+ * @brief Set how draw calls other than copy() blend with the target, such as
+ * SDL_BLENDMODE_BLEND for translucent fills
+ */
+void Renderer::setBlendMode(SDL_BlendMode blend)
+{
+	null_check();
+
+	if (SDL_SetRenderDrawBlendMode(this->handle, blend) != 0) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "Renderer (%p) : Error while setting draw blend mode %i %s",
+		             this, (int)blend, SDL_GetError()
+		            );
+	}
+}
+
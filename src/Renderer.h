@@ -8,10 +8,30 @@
 #include "Point.h"
 #include "Rectangle.h"
 #include "Color.h"
+#include "Texture.h"
 #include <vector>
 
 namespace tiledl
 {
+	/**
+	 * Counts of the SDL_Render* calls made by a Renderer
+	 */
+	struct RenderStats {
+		Uint32 points; // SDL_RenderDrawPoint calls
+		Uint32 lines;  // SDL_RenderDrawLine and SDL_RenderDrawLines calls
+		Uint32 rects;
+		Uint32 fills;
+		Uint32 copies;
+		Uint32 clears;
+		Uint32 presents;
+		Uint32 colorChanges;
+		Uint32 targetChanges;
+		Uint32 textureSwitches; // copies from a different texture than the copy before
+		Uint64 pixels; // pixels covered before clipping and blending
+
+		Uint32 getDrawCalls() const;
+	};
+
 	class Renderer
 	{
 	public:
@@ -55,18 +75,34 @@ namespace tiledl
 		void fillRect(const Rectangle& rect);
 		void fillRect(int x, int y, int w, int h);
 
+		void copy(Texture& texture, const SDL_Rect* src, const SDL_Rect* dst);
+		void copy(Texture& texture, const Rectangle& src, const Rectangle& dst);
+
+		void resetStats();
+
 		// Getters
 		SDL_Renderer* getHandle();
+		const RenderStats& getStats() const;
+		SDL_Texture* getTarget();
+		SDL_BlendMode getBlendMode();
 
 
 		//Setters
+		bool setTarget(Texture& texture);
+		bool setTarget(SDL_Texture* texture);
 		void setDrawColor(SDL_Color color);
 		void setDrawColor(Color color);
 		void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+		void setBlendMode(SDL_BlendMode blend);
 
 	private:
 		inline void null_check();
+		void getTargetSize(int& w, int& h);
+		Uint64 getTargetArea();
+
 		SDL_Renderer* handle;
+		SDL_Texture* lastTexture; // of the last copy, to count switches
+		RenderStats stats;
 	};
 } // namespace frame2d
 #endif // RENDERER_H
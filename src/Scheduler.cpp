@@ -0,0 +1,179 @@
+#include "Scheduler.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace tiledl;
+
+/**
+ * @param world world given to every system, must outlive the Scheduler
+ * @param jobs runs the systems of a wave, such as Game::getJobs(), must outlive the Scheduler
+ */
+Scheduler::Scheduler(World& world, JobSystem& jobs)
+{
+	this->world = &world;
+	this->jobs = &jobs;
+	this->dirty = true;
+}
+
+Scheduler::~Scheduler()
+{
+
+}
+
+/**
+ * @brief Add a system, run after every conflicting system added before it
+ *
+ * @param reads components the system only reads, Components::mask<T...>()
+ * @param writes components the system writes, ALL_COMPONENTS for systems touching everything
+ * @return the index of the system
+ */
+int Scheduler::addSystem(const std::string& name, ComponentMask reads, ComponentMask writes,
+                         const SystemFunction& function)
+{
+	if (!function) {
+		throw std::invalid_argument("Scheduler system must have a function");
+	}
+
+	System system;
+	system.name = name;
+	system.reads = reads;
+	system.writes = writes;
+	system.function = function;
+	system.enabled = true;
+	system.wave = 0;
+
+	this->systems.push_back(std::move(system));
+	this->dirty = true;
+	return (int)this->systems.size() - 1;
+}
+
+/**
+ * @brief Check if two systems cannot run at the same time
+ */
+bool Scheduler::conflicts(ComponentMask readsA, ComponentMask writesA, ComponentMask readsB, ComponentMask writesB)
+{
+	return (writesA & (readsB | writesB)) != 0 || (writesB & readsA) != 0;
+}
+
+/**
+ * @brief Place every enabled system in the wave after the last system it depends on
+ */
+void Scheduler::build()
+{
+	this->waves.clear();
+
+	for (int i = 0; i < (int)this->systems.size(); i++) {
+		System& system = this->systems[i];
+		system.dependencies.clear();
+		system.wave = -1;
+
+		if (!system.enabled) {
+			continue;
+		}
+
+		system.wave = 0;
+
+		for (int j = 0; j < i; j++) {
+			const System& earlier = this->systems[j];
+
+			if (earlier.enabled && conflicts(earlier.reads, earlier.writes, system.reads, system.writes)) {
+				system.dependencies.push_back(j);
+				system.wave = std::max(system.wave, earlier.wave + 1);
+			}
+		}
+
+		if (system.wave >= (int)this->waves.size()) {
+			this->waves.resize(system.wave + 1);
+		}
+
+		this->waves[system.wave].push_back(i);
+	}
+
+	this->dirty = false;
+}
+
+/**
+ * @brief Run every enabled system once, then play back their commands
+ *
+ * @note A system throwing on a worker thread ends the program, catch
+ * inside systems that can fail
+ */
+void Scheduler::run()
+{
+	if (this->dirty) {
+		build();
+	}
+
+	for (const std::vector<int>& wave : this->waves) {
+		// A job per system, so a long system does not hold back the rest of its wave
+		this->jobs->parallelFor((int)wave.size(), [this, &wave](int index) {
+			System& system = this->systems[wave[index]];
+			system.function(*this->world, system.commands);
+		}, 1);
+	}
+
+	// In the order the systems were added, so results do not depend on timing
+	for (System& system : this->systems) {
+		system.commands.playback(*this->world);
+	}
+}
+
+/* ========= Getters =========*/
+
+int Scheduler::getSystemCount() const
+{
+	return (int)this->systems.size();
+}
+
+const std::string& Scheduler::getName(int system) const
+{
+	return this->systems.at(system).name;
+}
+
+bool Scheduler::isEnabled(int system) const
+{
+	return this->systems.at(system).enabled;
+}
+
+/**
+ * @return the wave the system runs in, -1 if it is disabled
+ */
+int Scheduler::getWave(int system)
+{
+	if (this->dirty) {
+		build();
+	}
+
+	return this->systems.at(system).wave;
+}
+
+int Scheduler::getWaveCount()
+{
+	if (this->dirty) {
+		build();
+	}
+
+	return (int)this->waves.size();
+}
+
+/**
+ * @return the earlier enabled systems the system waits for
+ */
+const std::vector<int>& Scheduler::getDependencies(int system)
+{
+	if (this->dirty) {
+		build();
+	}
+
+	return this->systems.at(system).dependencies;
+}
+
+/* ========= Setters =========*/
+
+void Scheduler::setEnabled(int system, bool enabled)
+{
+	if (this->systems.at(system).enabled != enabled) {
+		this->systems[system].enabled = enabled;
+		this->dirty = true;
+	}
+}
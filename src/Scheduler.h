@@ -0,0 +1,82 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <string>
+#include <functional>
+#include "Entity.h"
+#include "World.h"
+#include "CommandBuffer.h"
+#include "JobSystem.h"
+
+namespace tiledl
+{
+	/**
+	 * An update system, given the world and its own CommandBuffer for
+	 * structural changes
+	 */
+	typedef std::function<void(World&, CommandBuffer&)> SystemFunction;
+
+	/**
+	 * Runs the systems of a World every tick, running systems that touch
+	 * different components at the same time on a JobSystem.
+	 *
+	 * Every system declares the components it reads and writes. Two systems
+	 * conflict when either writes a component the other uses, a system then
+	 * runs after every earlier added system it conflicts with, in a later
+	 * wave. The systems of a wave run concurrently. Systems that change the
+	 * structure of the world record it in their CommandBuffer, which is
+	 * played back in the order the systems were added after the last wave.
+	 *
+	 * Systems may fan their own work out on the same JobSystem, waiting on
+	 * it runs queued jobs, other systems included, instead of blocking.
+	 */
+	class Scheduler
+	{
+	public:
+		static const ComponentMask ALL_COMPONENTS = ~(ComponentMask)0;
+
+		Scheduler(World& world, JobSystem& jobs);
+		~Scheduler();
+
+		int addSystem(const std::string& name, ComponentMask reads, ComponentMask writes, const SystemFunction& function);
+		void run();
+
+		static bool conflicts(ComponentMask readsA, ComponentMask writesA, ComponentMask readsB, ComponentMask writesB);
+
+		// Getters
+		int getSystemCount() const;
+		const std::string& getName(int system) const;
+		bool isEnabled(int system) const;
+		int getWave(int system);
+		int getWaveCount();
+		const std::vector<int>& getDependencies(int system);
+
+		// Setters
+		void setEnabled(int system, bool enabled);
+
+	private:
+		struct System {
+			std::string name;
+			ComponentMask reads, writes;
+			SystemFunction function;
+			bool enabled;
+
+			CommandBuffer commands;
+			std::vector<int> dependencies; // earlier enabled systems it conflicts with
+			int wave;
+		};
+
+		void build();
+
+		World* world;
+		JobSystem* jobs;
+		std::vector<System> systems;
+		std::vector<std::vector<int>> waves;
+		bool dirty;
+	};
+} // namespace tiledl
+
+#endif // SCHEDULER_H_
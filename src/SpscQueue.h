@@ -0,0 +1,126 @@
+#ifndef SPSCQUEUE_H_
+#define SPSCQUEUE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include "CacheLine.h"
+
+namespace tiledl
+{
+	/**
+	 * A fixed size lock-free ring buffer for passing values from exactly one
+	 * producer thread to exactly one consumer thread.
+	 *
+	 * push() and pop() never block or allocate, a full queue refuses the value
+	 * and an empty queue returns nothing.
+	 */
+	template<typename T>
+	class SpscQueue
+	{
+	public:
+		SpscQueue(size_t capacity);
+		~SpscQueue();
+
+		bool push(const T& value);
+		bool pop(T& value);
+
+		bool isEmpty() const;
+		size_t getCapacity() const;
+
+	private:
+		SpscQueue(const SpscQueue&);
+		SpscQueue& operator=(const SpscQueue&);
+
+		std::vector<T> slots;
+		size_t mask;
+
+		// Kept on separate cache lines so the two threads do not share one
+		std::atomic<size_t> head; // next slot to pop, owned by the consumer
+		char padding[CACHE_LINE - sizeof(std::atomic<size_t>)];
+		std::atomic<size_t> tail; // next slot to push, owned by the producer
+	};
+
+	/**
+	 * @param capacity most values held at once, rounded up to a power of two
+	 */
+	template<typename T>
+	SpscQueue<T>::SpscQueue(size_t capacity) : head(0), tail(0)
+	{
+		if (capacity == 0) {
+			throw std::invalid_argument("SpscQueue capacity must be greater than zero");
+		}
+
+		size_t size = 1;
+
+		while (size < capacity) {
+			size <<= 1;
+		}
+
+		this->slots.resize(size);
+		this->mask = size - 1;
+	}
+
+	template<typename T>
+	SpscQueue<T>::~SpscQueue()
+	{
+
+	}
+
+	/**
+	 * @brief Add a value, only call from the producer thread
+	 *
+	 * @return false if the queue is full
+	 */
+	template<typename T>
+	bool SpscQueue<T>::push(const T& value)
+	{
+		const size_t tail = this->tail.load(std::memory_order_relaxed);
+
+		if (tail - this->head.load(std::memory_order_acquire) > this->mask) {
+			return false;
+		}
+
+		this->slots[tail & this->mask] = value;
+		this->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Take the oldest value, only call from the consumer thread
+	 *
+	 * @return false if the queue is empty
+	 */
+	template<typename T>
+	bool SpscQueue<T>::pop(T& value)
+	{
+		const size_t head = this->head.load(std::memory_order_relaxed);
+
+		if (head == this->tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		value = this->slots[head & this->mask];
+		this->head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @note Only exact when called from the consumer thread
+	 */
+	template<typename T>
+	bool SpscQueue<T>::isEmpty() const
+	{
+		return this->head.load(std::memory_order_acquire) == this->tail.load(std::memory_order_acquire);
+	}
+
+	template<typename T>
+	size_t SpscQueue<T>::getCapacity() const
+	{
+		return this->slots.size();
+	}
+} // namespace tiledl
+
+#endif // SPSCQUEUE_H_
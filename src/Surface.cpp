@@ -29,12 +29,14 @@ Surface::Surface()
 {
 	this->handle = nullptr;
 	this->refcount = 0;
+	this->locked = false;
 }
 
 Surface::Surface(int width, int height)
 {
 	this->handle = CreateSurface(width, height);
 	this->refcount = 0;
+	this->locked = false;
 
 	null_check();
 }
@@ -49,6 +51,7 @@ Surface::Surface(SDL_Surface* handle)
 {
 	this->handle = handle;
 	this->refcount = 0;
+	this->locked = false;
 
 	null_check();
 	handle->refcount++;
@@ -65,6 +68,7 @@ Surface::Surface(SDL_RWops* src, bool freesrc)
 {
 	this->handle = IMG_Load_RW(src, freesrc);
 	this->refcount = 0;
+	this->locked = false;
 
 	if (this->handle == NULL) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -88,6 +92,7 @@ Surface::Surface(SDL_RWops* src, bool freesrc, char* type)
 {
 	this->handle = IMG_LoadTyped_RW(src, freesrc, type);
 	this->refcount = 0;
+	this->locked = false;
 
 	if (this->handle == NULL) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -106,6 +111,7 @@ Surface::Surface(const char* file)
 {
 	this->handle = IMG_Load(file);
 	this->refcount = 0;
+	this->locked = false;
 
 	if (this->handle == NULL) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -170,6 +176,7 @@ void Surface::unlock()
 	null_check();
 
 	SDL_UnlockSurface(this->handle);
+	this->locked = false;
 }
 
 /**
@@ -73,6 +73,35 @@ int Texture::getRefCount() {
 	return this->refcount;
 }
 
+/**
+ * @brief Create a texture, destroying the texture held before
+ *
+ * @param renderer renderer the texture is drawn with
+ * @param format SDL_PixelFormatEnum of the texels
+ * @param access SDL_TextureAccess, SDL_TEXTUREACCESS_STREAMING to lock() it
+ * @return true on success
+ */
+bool Texture::create(SDL_Renderer* renderer, Uint32 format, int access, int w, int h)
+{
+	if (!this->isNull()) {
+		this->destroy();
+	}
+
+	this->texture = SDL_CreateTexture(renderer, format, access, w, h);
+
+	if (this->texture == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "Texture (%p) : Failed to create %ix%i texture %s",
+		             this, w, h, SDL_GetError()
+		            );
+		return false;
+	}
+
+	this->owner = renderer;
+	this->query(nullptr, nullptr, nullptr, nullptr);
+	return true;
+}
+
 void Texture::destroy()
 {
 	if (!this->isNull()) {
@@ -126,8 +155,76 @@ void Texture::query(Uint32* format, int* access, int* w, int* h)
 	}
 }
 
+/**
+ * @brief Lock the whole of a streaming texture for writing
+ *
+ * @see lock(const SDL_Rect*, void**, int*)
+ */
+bool Texture::lock(void** pixels, int* pitch)
+{
+	return lock(nullptr, pixels, pitch);
+}
+
+/**
+ * @brief Lock an area of a streaming texture for writing
+ *
+ * @param area area to lock, NULL for the whole texture
+ * @param pixels filled with the first texel of the area
+ * @param pitch filled with the length of a row in bytes
+ * @return true on success, unlock() must be called after writing
+ * @note The previous contents of the area are undefined, every texel must be written
+ */
+bool Texture::lock(const SDL_Rect* area, void** pixels, int* pitch)
+{
+	null_check();
+
+	if (SDL_LockTexture(this->texture, area, pixels, pitch) != 0) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "Texture (%p) : Error while locking Texture (%p) %s",
+		             this, texture, SDL_GetError()
+		            );
+		return false;
+	}
+
+	return true;
+}
+
+void Texture::unlock()
+{
+	null_check();
+	SDL_UnlockTexture(this->texture);
+}
+
+/**
+ * @brief Replace an area of the texture with new pixels
+ *
+ * @param area area to update, NULL for the whole texture
+ * @param pixels pixels in the format of the texture
+ * @param pitch length of a row of pixels in bytes
+ * @return true on success
+ */
+bool Texture::updateTexture(const SDL_Rect* area, const void* pixels, int pitch)
+{
+	null_check();
+
+	if (SDL_UpdateTexture(this->texture, area, pixels, pitch) != 0) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "Texture (%p) : Error while updating Texture (%p) %s",
+		             this, texture, SDL_GetError()
+		            );
+		return false;
+	}
+
+	return true;
+}
+
 /* ========= Getters =========*/
 
+SDL_Texture* Texture::getHandle()
+{
+	return this->texture;
+}
+
 /**
  * @brief Get the texture access of the texture
  *
@@ -152,14 +249,34 @@ Uint8 Texture::getAlphaMod()
 	return mod;
 }
 
-Uint8 Texture::getBlendMod()
+SDL_BlendMode Texture::getBlendMode()
 {
-	return 0x0; // FIXME: Method stub
+	null_check();
+	SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+
+	if (SDL_GetTextureBlendMode(this->texture, &blend) != 0) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "Texture (%p) : Error while getting Blend Mode of (%p) %s",
+		             this, texture, SDL_GetError()
+		            );
+	}
+
+	return blend;
 }
 
-Uint8 Texture::getColorMod()
+Color Texture::getColorMod()
 {
-	return 0x0; // FIXME: Method stub
+	null_check();
+	Uint8 r = 0xFF, g = 0xFF, b = 0xFF;
+
+	if (SDL_GetTextureColorMod(this->texture, &r, &g, &b) != 0) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "Texture (%p) : Error while getting Color Mod of (%p) %s",
+		             this, texture, SDL_GetError()
+		            );
+	}
+
+	return Color(r, g, b);
 }
 
 Uint32 Texture::getFormat()
@@ -184,15 +301,40 @@ int Texture::getHeight()
 
 void Texture::setAlphaMod(Uint8 mod)
 {
-	// FIXME: Method stub
+	null_check();
+
+	if (SDL_SetTextureAlphaMod(this->texture, mod) != 0) {
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+		            "Texture (%p): Failed to set alpha mod to %i : %s",
+		            this, mod, SDL_GetError()
+		           );
+	}
 }
 
-void Texture::setBlendMod(Uint8 mod)
+/**
+ * @note SDL_BLENDMODE_MOD multiplies what is already drawn by the texture,
+ * which is how a light map is applied over a scene
+ */
+void Texture::setBlendMode(SDL_BlendMode blend)
 {
-	// FIXME: Method stub
+	null_check();
+
+	if (SDL_SetTextureBlendMode(this->texture, blend) != 0) {
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+		            "Texture (%p): Failed to set blend mode to %X : %s",
+		            this, blend, SDL_GetError()
+		           );
+	}
 }
 
-void Texture::setColorMod(Uint8 mod)
+void Texture::setColorMod(Color color)
 {
-	// FIXME: Method stub
+	null_check();
+
+	if (SDL_SetTextureColorMod(this->texture, color.r, color.g, color.b) != 0) {
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+		            "Texture (%p): Failed to set color mod to {%i,%i,%i} : %s",
+		            this, color.r, color.g, color.b, SDL_GetError()
+		           );
+	}
 }
@@ -2,6 +2,7 @@
 #define TEXTURE_H
 
 #include <SDL2/SDL.h>
+#include "Color.h"
 
 namespace tiledl
 {
@@ -12,36 +13,37 @@ namespace tiledl
 		~Texture();
 		bool operator== (const Texture& other) const;
 
+		bool create(SDL_Renderer* renderer, Uint32 format, int access, int w, int h);
 		void destroy();
 		bool isNull();
 
 		void ref();
 		void deref();
 
-		void lock();
-		void lock(void** pixels, int* pitch);
-		void lock(const SDL_Rect* area, void** pixels, int* pitch);
+		bool lock(void** pixels, int* pitch);
+		bool lock(const SDL_Rect* area, void** pixels, int* pitch);
 		void unlock();
 		void query(Uint32* format, int* access, int* w, int* h);
 
 		bool updateTexture(const SDL_Rect*, const void* pixels, int pitch);
 
 		// Getters
+		SDL_Texture* getHandle();
 		int getWidth();
 		int getHeight();
 		int getRefCount();
 		SDL_TextureAccess getAccess();
 		Uint32 getFormat();
 		Uint8 getAlphaMod();
-		Uint8 getBlendMod();
-		Uint8 getColorMod();
+		SDL_BlendMode getBlendMode();
+		Color getColorMod();
 
 		SDL_Renderer* getOwner();
 
 		//Setters
 		void setAlphaMod(Uint8 mod);
-		void setBlendMod(Uint8 mod);
-		void setColorMod(Uint8 mod);
+		void setBlendMode(SDL_BlendMode blend);
+		void setColorMod(Color color);
 
 	private:
 		inline void null_check();
@@ -0,0 +1,399 @@
+#include "TileChunk.h"
+#include <stdexcept>
+#include <algorithm>
+
+using namespace tiledl;
+
+const int TileChunk::SIZE;
+const int TileChunk::AREA;
+
+// Palettes larger than this are searched through a hash map
+static const int LINEAR_PALETTE = 16;
+
+TileChunk::TileChunk() : TileChunk(0)
+{
+
+}
+
+/**
+ * @brief Create a chunk with every tile set to one id
+ */
+TileChunk::TileChunk(Uint32 id)
+{
+	fill(id);
+}
+
+TileChunk::TileChunk(const TileChunk& other)
+{
+	*this = other;
+}
+
+TileChunk::~TileChunk()
+{
+
+}
+
+TileChunk& TileChunk::operator=(const TileChunk& other)
+{
+	if (this != &other) {
+		this->bits = other.bits;
+		this->palette = other.palette;
+		this->counts = other.counts;
+		this->data = other.data;
+		rebuildLookup();
+	}
+
+	return *this;
+}
+
+/**
+ * @brief Set every tile to one id, releasing the packed indices
+ */
+void TileChunk::fill(Uint32 id)
+{
+	this->bits = 0;
+	this->palette.assign(1, id);
+	this->counts.assign(1, AREA);
+	this->data.clear();
+	this->data.shrink_to_fit();
+	this->lookup.reset();
+}
+
+bool TileChunk::isUniform() const
+{
+	return this->bits == 0;
+}
+
+void TileChunk::setIndex(int index, Uint32 value)
+{
+	const int bit = index * this->bits;
+	const Uint64 mask = ((1ULL << this->bits) - 1) << (bit & 63);
+	Uint64& word = this->data[bit >> 6];
+
+	word = (word & ~mask) | ((Uint64)value << (bit & 63));
+}
+
+/**
+ * @brief Set a tile, growing the palette and repacking the indices if needed
+ *
+ * @note Does no bounds checking
+ */
+void TileChunk::set(int x, int y, Uint32 id)
+{
+	const int index = y * SIZE + x;
+	const Uint32 old = getIndex(index);
+
+	if (this->palette[old] == id) {
+		return;
+	}
+
+	this->counts[old]--;
+
+	// Find after releasing the old entry so the last tile of an id can be replaced in place
+	int entry = findOrAdd(id);
+
+	if (this->bits == 0 && this->palette.size() > 1) {
+		repack(1);
+	}
+
+	this->counts[entry]++;
+
+	if (this->bits != 0) {
+		setIndex(index, (Uint32)entry);
+	}
+}
+
+/**
+ * @brief Find the palette entry of an id, reusing a free entry or growing the palette if it has none
+ */
+int TileChunk::findOrAdd(Uint32 id)
+{
+	int free = -1;
+
+	if (this->palette.size() > (size_t)LINEAR_PALETTE) {
+		auto it = this->lookup->find(id);
+
+		if (it != this->lookup->end()) {
+			return it->second;
+		}
+	} else {
+		for (size_t i = 0; i < this->palette.size(); i++) {
+			if (this->palette[i] == id) {
+				return (int)i;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < this->counts.size(); i++) {
+		if (this->counts[i] == 0) {
+			free = (int)i;
+			break;
+		}
+	}
+
+	if (free >= 0) {
+		if (this->palette.size() > (size_t)LINEAR_PALETTE) {
+			this->lookup->erase(this->palette[free]);
+			(*this->lookup)[id] = (Uint16)free;
+		}
+
+		this->palette[free] = id;
+		return free;
+	}
+
+	this->palette.push_back(id);
+	this->counts.push_back(0);
+
+	const int entry = (int)this->palette.size() - 1;
+
+	if (this->bits != 0 && this->palette.size() > (1ULL << this->bits)) {
+		repack(this->bits * 2);
+	}
+
+	if (this->palette.size() == (size_t)LINEAR_PALETTE + 1) {
+		rebuildLookup();
+	} else if (this->palette.size() > (size_t)LINEAR_PALETTE) {
+		(*this->lookup)[id] = (Uint16)entry;
+	}
+
+	return entry;
+}
+
+void TileChunk::rebuildLookup()
+{
+	if (this->palette.size() <= (size_t)LINEAR_PALETTE) {
+		this->lookup.reset();
+		return;
+	}
+
+	this->lookup.reset(new std::unordered_map<Uint32, Uint16>());
+
+	for (size_t i = 0; i < this->palette.size(); i++) {
+		if (this->counts[i] != 0 || this->lookup->count(this->palette[i]) == 0) {
+			(*this->lookup)[this->palette[i]] = (Uint16)i;
+		}
+	}
+}
+
+/**
+ * @brief Repack every index at a new width
+ */
+void TileChunk::repack(int bits)
+{
+	std::vector<Uint64> packed((size_t)AREA * bits / 64, 0);
+
+	for (int i = 0; i < AREA; i++) {
+		Uint64 value = getIndex(i);
+		int bit = i * bits;
+		packed[bit >> 6] |= value << (bit & 63);
+	}
+
+	this->bits = bits;
+	this->data.swap(packed);
+}
+
+/**
+ * @brief Drop unused palette entries and pack at the smallest width that fits
+ */
+void TileChunk::compact()
+{
+	std::vector<Uint32> remap(this->palette.size(), 0);
+	std::vector<Uint32> used;
+	std::vector<Uint16> usedCounts;
+
+	for (size_t i = 0; i < this->palette.size(); i++) {
+		if (this->counts[i] != 0) {
+			remap[i] = (Uint32)used.size();
+			used.push_back(this->palette[i]);
+			usedCounts.push_back(this->counts[i]);
+		}
+	}
+
+	if (used.size() == 1) {
+		fill(used[0]);
+		return;
+	}
+
+	int bits = 1;
+
+	while ((1ULL << bits) < used.size()) {
+		bits *= 2;
+	}
+
+	std::vector<Uint64> packed((size_t)AREA * bits / 64, 0);
+
+	for (int i = 0; i < AREA; i++) {
+		Uint64 value = remap[getIndex(i)];
+		int bit = i * bits;
+		packed[bit >> 6] |= value << (bit & 63);
+	}
+
+	this->bits = bits;
+	this->data.swap(packed);
+	this->data.shrink_to_fit();
+	this->palette.swap(used);
+	this->counts.swap(usedCounts);
+	rebuildLookup();
+}
+
+/**
+ * @brief Read a chunk written by write()
+ *
+ * @return true on success, otherwise the chunk is left unchanged
+ */
+bool TileChunk::read(SDL_RWops* src)
+{
+	Uint8 bits = 0;
+	Uint16 size = 0;
+
+	if (SDL_RWread(src, &bits, 1, 1) != 1 || SDL_RWread(src, &size, 2, 1) != 1) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "TileChunk (%p) : Truncated chunk header", this);
+		return false;
+	}
+
+	size = SDL_SwapLE16(size);
+
+	if (bits > 16 || size == 0 || size > AREA) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "TileChunk (%p) : Invalid index width %i or palette size %i",
+		             this, bits, size);
+		return false;
+	}
+
+	std::vector<Uint32> palette(size);
+	std::vector<Uint64> data((size_t)AREA * bits / 64);
+
+	if (SDL_RWread(src, &palette[0], sizeof(Uint32), palette.size()) != palette.size() ||
+	    (!data.empty() && SDL_RWread(src, &data[0], sizeof(Uint64), data.size()) != data.size())) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "TileChunk (%p) : Truncated chunk data", this);
+		return false;
+	}
+
+	for (auto& id : palette) {
+		id = SDL_SwapLE32(id);
+	}
+
+	for (auto& word : data) {
+		word = SDL_SwapLE64(word);
+	}
+
+	// Validated on a copy, setData() changes the chunk it fails on
+	TileChunk chunk;
+
+	try {
+		chunk.setData(bits, palette, data);
+	} catch (std::invalid_argument& e) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "TileChunk (%p) : %s", this, e.what());
+		return false;
+	}
+
+	*this = chunk;
+	return true;
+}
+
+/**
+ * @brief Write the palette and packed indices of the chunk
+ *
+ * @return true on success
+ */
+bool TileChunk::write(SDL_RWops* dst) const
+{
+	Uint8 bits = (Uint8)this->bits;
+	bool ok = (SDL_RWwrite(dst, &bits, 1, 1) == 1);
+
+	ok = ok && SDL_WriteLE16(dst, (Uint16)this->palette.size()) == 1;
+
+	for (size_t i = 0; ok && i < this->palette.size(); i++) {
+		ok = (SDL_WriteLE32(dst, this->palette[i]) == 1);
+	}
+
+	for (size_t i = 0; ok && i < this->data.size(); i++) {
+		ok = (SDL_WriteLE64(dst, this->data[i]) == 1);
+	}
+
+	return ok;
+}
+
+/* ========= Getters =========*/
+
+/**
+ * @brief Get the width of a packed index in bits, 0 for a uniform chunk
+ */
+int TileChunk::getBits() const
+{
+	return this->bits;
+}
+
+int TileChunk::getPaletteSize() const
+{
+	return (int)this->palette.size();
+}
+
+const std::vector<Uint32>& TileChunk::getPalette() const
+{
+	return this->palette;
+}
+
+/**
+ * @brief Get the packed indices, tile i is at bit i * getBits()
+ */
+const std::vector<Uint64>& TileChunk::getData() const
+{
+	return this->data;
+}
+
+/**
+ * @brief Get the approximate number of bytes used by the chunk
+ */
+size_t TileChunk::getMemoryUsage() const
+{
+	size_t bytes = sizeof(TileChunk);
+
+	bytes += this->palette.capacity() * sizeof(Uint32);
+	bytes += this->counts.capacity() * sizeof(Uint16);
+	bytes += this->data.capacity() * sizeof(Uint64);
+
+	if (this->lookup) {
+		bytes += this->lookup->size() * (sizeof(Uint32) + sizeof(Uint16) + 2 * sizeof(void*));
+	}
+
+	return bytes;
+}
+
+/* ========= Setters =========*/
+
+/**
+ * @brief Replace the contents of the chunk with packed indices, such as from a file
+ *
+ * @param bits width of an index, 0, 1, 2, 4, 8 or 16
+ * @param palette ids of the indices, 2^bits entries at most
+ * @param data AREA * bits / 64 words of indices
+ */
+void TileChunk::setData(int bits, const std::vector<Uint32>& palette, const std::vector<Uint64>& data)
+{
+	if (bits != 0 && bits != 1 && bits != 2 && bits != 4 && bits != 8 && bits != 16) {
+		throw std::invalid_argument("TileChunk index width must be 0, 1, 2, 4, 8 or 16 bits");
+	}
+
+	if (palette.empty() || (bits == 0 && palette.size() != 1) || (bits != 0 && palette.size() > (1ULL << bits)) ||
+	    data.size() != (size_t)AREA * bits / 64) {
+		throw std::invalid_argument("TileChunk palette or data does not match the index width");
+	}
+
+	this->bits = bits;
+	this->palette = palette;
+	this->data = data;
+	this->counts.assign(palette.size(), 0);
+
+	for (int i = 0; i < AREA; i++) {
+		Uint32 index = getIndex(i);
+
+		if (index >= palette.size()) {
+			fill(palette[0]);
+			throw std::invalid_argument("TileChunk data indexes past the end of the palette");
+		}
+
+		this->counts[index]++;
+	}
+
+	rebuildLookup();
+}
@@ -0,0 +1,86 @@
+#ifndef TILECHUNK_H_
+#define TILECHUNK_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+namespace tiledl
+{
+	/**
+	 * A square block of 32-bit tile ids stored as indices into a local palette.
+	 *
+	 * Indices are packed at the smallest of 1, 2, 4, 8 or 16 bits that fits
+	 * the palette, and a chunk of a single id stores no indices at all.
+	 * Palette entries no tile uses any more are reused before the palette
+	 * grows, compact() shrinks a chunk back to the smallest width.
+	 */
+	class TileChunk
+	{
+	public:
+		static const int SIZE = 32;
+		static const int AREA = SIZE * SIZE;
+
+		TileChunk();
+		TileChunk(Uint32 id);
+		TileChunk(const TileChunk& other);
+		~TileChunk();
+
+		TileChunk& operator=(const TileChunk& other);
+
+		Uint32 get(int x, int y) const;
+		void set(int x, int y, Uint32 id);
+		void fill(Uint32 id);
+		void compact();
+
+		bool read(SDL_RWops* src);
+		bool write(SDL_RWops* dst) const;
+
+		bool isUniform() const;
+
+		// Getters
+		int getBits() const;
+		int getPaletteSize() const;
+		const std::vector<Uint32>& getPalette() const;
+		const std::vector<Uint64>& getData() const;
+		size_t getMemoryUsage() const;
+
+		// Setters
+		void setData(int bits, const std::vector<Uint32>& palette, const std::vector<Uint64>& data);
+
+	private:
+		Uint32 getIndex(int index) const;
+		void setIndex(int index, Uint32 value);
+		int findOrAdd(Uint32 id);
+		void repack(int bits);
+		void rebuildLookup();
+
+		int bits;
+		std::vector<Uint32> palette;
+		std::vector<Uint16> counts; // tiles using each palette entry
+		std::vector<Uint64> data;
+		std::unique_ptr<std::unordered_map<Uint32, Uint16>> lookup; // only for large palettes
+	};
+
+	inline Uint32 TileChunk::getIndex(int index) const
+	{
+		if (this->bits == 0) {
+			return 0;
+		}
+
+		const int bit = index * this->bits;
+		return (Uint32)((this->data[bit >> 6] >> (bit & 63)) & ((1ULL << this->bits) - 1));
+	}
+
+	/**
+	 * @note Does no bounds checking
+	 */
+	inline Uint32 TileChunk::get(int x, int y) const
+	{
+		return this->palette[getIndex(y * SIZE + x)];
+	}
+} // namespace tiledl
+
+#endif // TILECHUNK_H_
@@ -0,0 +1,183 @@
+#include "TileCollision.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+using namespace tiledl;
+
+// Tolerance in tile units, keeps a box resting exactly on a tile edge from
+// being counted as overlapping the tile on the other side
+static const double EPSILON = 1e-9;
+
+/**
+ * @brief Sweep a box through the grid and find the first solid tile it enters
+ *
+ * The leading corner of the box is walked through the grid with a DDA, and
+ * every time it crosses a tile boundary the row or column of tiles under the
+ * leading face is tested.
+ *
+ * @param grid grid to test against
+ * @param position top left of the box in pixels
+ * @param size width and height of the box in pixels, must be positive
+ * @param delta movement of the box in pixels
+ * @return SweepResult with the fraction of delta that can be travelled
+ * @note A box that already overlaps a solid tile is only stopped by the
+ * tiles it enters, so it can move out of a tile it is stuck in.
+ */
+SweepResult TileCollision::sweep(const TileGrid& grid, const Vector& position, const Vector& size, const Vector& delta)
+{
+	SweepResult result;
+
+	const double tileSize[2] = { (double)grid.getTileWidth(), (double)grid.getTileHeight() };
+	const double lo[2] = { position.x / tileSize[0], position.y / tileSize[1] };
+	const double hi[2] = { (position.x + size.x) / tileSize[0], (position.y + size.y) / tileSize[1] };
+	const double d[2] = { delta.x / tileSize[0], delta.y / tileSize[1] };
+
+	int step[2], cell[2];
+	double tNext[2], tDelta[2];
+
+	for (int axis = 0; axis < 2; axis++) {
+		if (d[axis] > 0) {
+			double boundary = std::ceil(hi[axis] - EPSILON);
+			step[axis] = 1;
+			cell[axis] = (int)boundary;
+			tNext[axis] = (boundary - hi[axis]) / d[axis];
+			tDelta[axis] = 1.0 / d[axis];
+		} else if (d[axis] < 0) {
+			double boundary = std::floor(lo[axis] + EPSILON);
+			step[axis] = -1;
+			cell[axis] = (int)boundary - 1;
+			tNext[axis] = (lo[axis] - boundary) / -d[axis];
+			tDelta[axis] = 1.0 / -d[axis];
+		} else {
+			step[axis] = 0;
+			cell[axis] = 0;
+			tNext[axis] = tDelta[axis] = std::numeric_limits<double>::infinity();
+		}
+	}
+
+	while (true) {
+		double t = std::min(tNext[0], tNext[1]);
+
+		if (t > 1.0) {
+			break;
+		}
+
+		bool crossing[2] = { tNext[0] <= t + EPSILON, tNext[1] <= t + EPSILON };
+		t = std::max(t, 0.0);
+
+		for (int axis = 0; axis < 2; axis++) {
+			if (!crossing[axis]) {
+				continue;
+			}
+
+			// Tiles under the leading face, on the other axis at time t
+			int other = 1 - axis;
+			int from = (int)std::floor(lo[other] + d[other] * t + EPSILON);
+			int to = (int)std::ceil(hi[other] + d[other] * t - EPSILON) - 1;
+
+			for (int c = from; c <= to; c++) {
+				int x = (axis == 0) ? cell[0] : c;
+				int y = (axis == 0) ? c : cell[1];
+
+				if (grid.isSolid(x, y)) {
+					result.hit = true;
+					result.time = t;
+					result.normal = (axis == 0) ? Point(-step[0], 0) : Point(0, -step[1]);
+					result.tile = Point(x, y);
+					return result;
+				}
+			}
+		}
+
+		// Crossing both axes at once enters the diagonal tile, which is under neither face
+		if (crossing[0] && crossing[1] && grid.isSolid(cell[0], cell[1])) {
+			int axis = (std::fabs(d[0]) >= std::fabs(d[1])) ? 0 : 1;
+			result.hit = true;
+			result.time = t;
+			result.normal = (axis == 0) ? Point(-step[0], 0) : Point(0, -step[1]);
+			result.tile = Point(cell[0], cell[1]);
+			return result;
+		}
+
+		for (int axis = 0; axis < 2; axis++) {
+			if (crossing[axis]) {
+				cell[axis] += step[axis];
+				tNext[axis] += tDelta[axis];
+			}
+		}
+	}
+
+	return result;
+}
+
+/**
+ * @brief Sweep a box through the grid and find the first solid tile it enters
+ *
+ * @see sweep(const TileGrid&, const Vector&, const Vector&, const Vector&)
+ */
+SweepResult TileCollision::sweep(const TileGrid& grid, const Rectangle& box, const Vector& delta)
+{
+	return sweep(grid, Vector(box.x, box.y), Vector(box.w, box.h), delta);
+}
+
+/**
+ * @brief Move a box through the grid, sliding along any tiles it hits
+ *
+ * @return the position of the box after moving
+ */
+Vector TileCollision::move(const TileGrid& grid, const Vector& position, const Vector& size, const Vector& delta)
+{
+	return move(grid, position, size, delta, nullptr);
+}
+
+/**
+ * @brief Move a box through the grid, sliding along any tiles it hits
+ *
+ * @param contact if not null, filled with the first tile that was hit
+ * @return the position of the box after moving
+ */
+Vector TileCollision::move(const TileGrid& grid, const Vector& position, const Vector& size, const Vector& delta, SweepResult* contact)
+{
+	Vector current = position;
+	Vector remaining = delta;
+	bool touched = false;
+
+	if (contact != nullptr) {
+		*contact = SweepResult();
+	}
+
+	// Each hit removes one axis of the movement, so two sweeps are enough in 2D
+	for (int i = 0; i < 2; i++) {
+		if (remaining.x == 0 && remaining.y == 0) {
+			break;
+		}
+
+		SweepResult result = sweep(grid, current, size, remaining);
+
+		if (!result.hit) {
+			current = current + remaining;
+			break;
+		}
+
+		current = current + remaining * result.time;
+
+		// Snap onto the face that was hit so rounding never leaves the box inside the tile
+		if (result.normal.x != 0) {
+			double tileWidth = grid.getTileWidth();
+			current.x = (result.normal.x < 0) ? result.tile.x * tileWidth - size.x : (result.tile.x + 1) * tileWidth;
+			remaining = Vector(0.0, remaining.y * (1.0 - result.time));
+		} else {
+			double tileHeight = grid.getTileHeight();
+			current.y = (result.normal.y < 0) ? result.tile.y * tileHeight - size.y : (result.tile.y + 1) * tileHeight;
+			remaining = Vector(remaining.x * (1.0 - result.time), 0.0);
+		}
+
+		if (contact != nullptr && !touched) {
+			*contact = result;
+			touched = true;
+		}
+	}
+
+	return current;
+}
@@ -0,0 +1,38 @@
+#ifndef TILECOLLISION_H_
+#define TILECOLLISION_H_
+#pragma once
+
+#include "TileGrid.h"
+#include "Vector.h"
+#include "Point.h"
+#include "Rectangle.h"
+
+namespace tiledl
+{
+	/**
+	 * Result of sweeping a box against a TileGrid
+	 */
+	struct SweepResult {
+		bool hit = false;
+		double time = 1.0; // fraction of the movement completed before impact
+		Point normal;      // surface normal of the face that was hit
+		Point tile;        // the solid tile that was hit
+	};
+
+	/**
+	 * Swept AABB collision against the solid tiles of a TileGrid.
+	 * Only the cells crossed by the leading faces of the box are visited,
+	 * so the cost depends on the distance moved and not on the grid size.
+	 */
+	class TileCollision
+	{
+	public:
+		static SweepResult sweep(const TileGrid& grid, const Vector& position, const Vector& size, const Vector& delta);
+		static SweepResult sweep(const TileGrid& grid, const Rectangle& box, const Vector& delta);
+
+		static Vector move(const TileGrid& grid, const Vector& position, const Vector& size, const Vector& delta);
+		static Vector move(const TileGrid& grid, const Vector& position, const Vector& size, const Vector& delta, SweepResult* contact);
+	};
+} // namespace tiledl
+
+#endif // TILECOLLISION_H_
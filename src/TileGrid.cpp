@@ -0,0 +1,165 @@
+#include "TileGrid.h"
+#include <stdexcept>
+#include <algorithm>
+
+using namespace tiledl;
+
+static inline int floor_div(int a, int b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * @brief Create an empty grid with no tiles and 1x1 pixel tiles
+ */
+TileGrid::TileGrid()
+{
+	this->width = this->height = 0;
+	this->tileWidth = this->tileHeight = 1;
+	this->version = 0;
+}
+
+/**
+ * @brief Create a grid of empty tiles
+ *
+ * @param width number of tiles across
+ * @param height number of tiles down
+ * @param tileWidth width of a tile in pixels
+ * @param tileHeight height of a tile in pixels
+ */
+TileGrid::TileGrid(int width, int height, int tileWidth, int tileHeight)
+{
+	this->width = this->height = 0;
+	this->version = 0;
+
+	setTileSize(tileWidth, tileHeight);
+	resize(width, height);
+}
+
+TileGrid::~TileGrid()
+{
+
+}
+
+/**
+ * @brief Resize the grid, tiles that remain inside keep their flags
+ */
+void TileGrid::resize(int width, int height)
+{
+	if (width < 0 || height < 0) {
+		throw std::invalid_argument("A TileGrid cannot have a negative size");
+	}
+
+	std::vector<Uint8> resized((size_t)width * height, TILE_EMPTY);
+
+	for (int y = 0; y < std::min(height, this->height); y++) {
+		for (int x = 0; x < std::min(width, this->width); x++) {
+			resized[y * width + x] = this->tiles[y * this->width + x];
+		}
+	}
+
+	this->tiles.swap(resized);
+	this->width = width;
+	this->height = height;
+	this->version++;
+}
+
+void TileGrid::fill(Uint8 flags)
+{
+	std::fill(this->tiles.begin(), this->tiles.end(), flags);
+	this->version++;
+}
+
+/**
+ * @brief Get the tile which contains a pixel
+ */
+Point TileGrid::toTile(const Point& pixel) const
+{
+	return Point(floor_div(pixel.x, this->tileWidth), floor_div(pixel.y, this->tileHeight));
+}
+
+/**
+ * @brief Get the top left pixel of a tile
+ */
+Point TileGrid::toPixel(const Point& tile) const
+{
+	return Point(tile.x * this->tileWidth, tile.y * this->tileHeight);
+}
+
+Point TileGrid::getTileCenter(const Point& tile) const
+{
+	return Point(tile.x * this->tileWidth + this->tileWidth / 2,
+	             tile.y * this->tileHeight + this->tileHeight / 2);
+}
+
+Rectangle TileGrid::getTileRect(const Point& tile) const
+{
+	return Rectangle(tile.x * this->tileWidth, tile.y * this->tileHeight,
+	                 this->tileWidth, this->tileHeight);
+}
+
+/* ========= Getters =========*/
+
+int TileGrid::getWidth() const
+{
+	return this->width;
+}
+
+int TileGrid::getHeight() const
+{
+	return this->height;
+}
+
+int TileGrid::getTileWidth() const
+{
+	return this->tileWidth;
+}
+
+int TileGrid::getTileHeight() const
+{
+	return this->tileHeight;
+}
+
+/**
+ * @brief Get the number of modifications made to the grid
+ *
+ * @note Can be compared against a stored value to detect that the grid changed
+ */
+Uint32 TileGrid::getVersion() const
+{
+	return this->version;
+}
+
+/* ========= Setters =========*/
+
+void TileGrid::setFlags(int x, int y, Uint8 flags)
+{
+	if (!isInside(x, y)) {
+		throw std::out_of_range("Tile is outside of the TileGrid");
+	}
+
+	this->tiles[y * this->width + x] = flags;
+	this->version++;
+}
+
+void TileGrid::setSolid(int x, int y, bool solid)
+{
+	Uint8 flags = getFlags(x, y);
+	setFlags(x, y, solid ? (flags | TILE_SOLID) : (flags & ~TILE_SOLID));
+}
+
+void TileGrid::setOpaque(int x, int y, bool opaque)
+{
+	Uint8 flags = getFlags(x, y);
+	setFlags(x, y, opaque ? (flags | TILE_OPAQUE) : (flags & ~TILE_OPAQUE));
+}
+
+void TileGrid::setTileSize(int tileWidth, int tileHeight)
+{
+	if (tileWidth <= 0 || tileHeight <= 0) {
+		throw std::invalid_argument("A TileGrid tile size must be greater than zero");
+	}
+
+	this->tileWidth = tileWidth;
+	this->tileHeight = tileHeight;
+}
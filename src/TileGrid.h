@@ -0,0 +1,87 @@
+#ifndef TILEGRID_H_
+#define TILEGRID_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Point.h"
+#include "Rectangle.h"
+
+namespace tiledl
+{
+	enum TileFlags : Uint8 {
+		TILE_EMPTY = 0,
+		TILE_SOLID = 1 << 0, // blocks movement
+		TILE_OPAQUE = 1 << 1 // blocks sight
+	};
+
+	/**
+	 * A grid of per-tile flags, sized in tiles with a tile size in pixels.
+	 * Tiles outside of the grid are reported as solid and opaque.
+	 */
+	class TileGrid
+	{
+	public:
+		TileGrid();
+		TileGrid(int width, int height, int tileWidth, int tileHeight);
+		~TileGrid();
+
+		void resize(int width, int height);
+		void fill(Uint8 flags);
+
+		bool isInside(int x, int y) const;
+		bool isSolid(int x, int y) const;
+		bool isOpaque(int x, int y) const;
+
+		Point toTile(const Point& pixel) const;
+		Point toPixel(const Point& tile) const;
+		Point getTileCenter(const Point& tile) const;
+		Rectangle getTileRect(const Point& tile) const;
+
+		// Getters
+		Uint8 getFlags(int x, int y) const;
+		int getWidth() const;
+		int getHeight() const;
+		int getTileWidth() const;
+		int getTileHeight() const;
+		Uint32 getVersion() const;
+
+		// Setters
+		void setFlags(int x, int y, Uint8 flags);
+		void setSolid(int x, int y, bool solid);
+		void setOpaque(int x, int y, bool opaque);
+		void setTileSize(int tileWidth, int tileHeight);
+
+	private:
+		std::vector<Uint8> tiles;
+		int width, height;
+		int tileWidth, tileHeight;
+		Uint32 version;
+	};
+
+	inline bool TileGrid::isInside(int x, int y) const
+	{
+		return ((unsigned)x < (unsigned)this->width && (unsigned)y < (unsigned)this->height);
+	}
+
+	inline Uint8 TileGrid::getFlags(int x, int y) const
+	{
+		if (!isInside(x, y)) {
+			return TILE_SOLID | TILE_OPAQUE;
+		}
+
+		return this->tiles[y * this->width + x];
+	}
+
+	inline bool TileGrid::isSolid(int x, int y) const
+	{
+		return (getFlags(x, y) & TILE_SOLID) != 0;
+	}
+
+	inline bool TileGrid::isOpaque(int x, int y) const
+	{
+		return (getFlags(x, y) & TILE_OPAQUE) != 0;
+	}
+} // namespace tiledl
+
+#endif // TILEGRID_H_
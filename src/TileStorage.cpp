@@ -0,0 +1,153 @@
+#include "TileStorage.h"
+#include <stdexcept>
+#include <algorithm>
+
+using namespace tiledl;
+
+TileStorage::TileStorage()
+{
+	this->width = this->height = this->layers = 0;
+	this->chunksWide = this->chunksHigh = 0;
+}
+
+TileStorage::TileStorage(int width, int height, int layers) : TileStorage()
+{
+	resize(width, height, layers);
+}
+
+TileStorage::~TileStorage()
+{
+
+}
+
+/**
+ * @brief Resize the storage in tiles, every tile of every layer is reset to 0
+ */
+void TileStorage::resize(int width, int height, int layers)
+{
+	if (width < 0 || height < 0 || layers < 0) {
+		throw std::invalid_argument("A TileStorage cannot have a negative size");
+	}
+
+	this->width = width;
+	this->height = height;
+	this->layers = layers;
+	this->chunksWide = (width + TileChunk::SIZE - 1) / TileChunk::SIZE;
+	this->chunksHigh = (height + TileChunk::SIZE - 1) / TileChunk::SIZE;
+
+	this->chunks.assign((size_t)this->chunksWide * this->chunksHigh * layers, TileChunk());
+}
+
+/**
+ * @brief Set every tile of a layer to one id
+ *
+ * @note The tiles of edge chunks past the size of the storage are left 0
+ */
+void TileStorage::fill(int layer, Uint32 id)
+{
+	if ((unsigned)layer >= (unsigned)this->layers) {
+		throw std::out_of_range("Layer is outside of the TileStorage");
+	}
+
+	for (int cy = 0; cy < this->chunksHigh; cy++) {
+		for (int cx = 0; cx < this->chunksWide; cx++) {
+			TileChunk& chunk = this->chunks[chunkIndex(layer, cx, cy)];
+			const int w = std::min(TileChunk::SIZE, this->width - cx * TileChunk::SIZE);
+			const int h = std::min(TileChunk::SIZE, this->height - cy * TileChunk::SIZE);
+
+			if (w == TileChunk::SIZE && h == TileChunk::SIZE) {
+				chunk.fill(id);
+				continue;
+			}
+
+			chunk.fill(0);
+
+			for (int y = 0; y < h; y++) {
+				for (int x = 0; x < w; x++) {
+					chunk.set(x, y, id);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief Shrink every chunk to the smallest palette and index width it needs
+ */
+void TileStorage::compact()
+{
+	for (auto& chunk : this->chunks) {
+		chunk.compact();
+	}
+}
+
+void TileStorage::set(int layer, int x, int y, Uint32 id)
+{
+	if (!isInside(x, y) || (unsigned)layer >= (unsigned)this->layers) {
+		throw std::out_of_range("Tile is outside of the TileStorage");
+	}
+
+	TileChunk& chunk = this->chunks[chunkIndex(layer, x / TileChunk::SIZE, y / TileChunk::SIZE)];
+	chunk.set(x % TileChunk::SIZE, y % TileChunk::SIZE, id);
+}
+
+/**
+ * @brief Get a chunk by its position in chunks
+ *
+ * @note Tiles of edge chunks that are past the size of the storage are kept but never read
+ */
+TileChunk& TileStorage::getChunk(int layer, int cx, int cy)
+{
+	if ((unsigned)layer >= (unsigned)this->layers || (unsigned)cx >= (unsigned)this->chunksWide ||
+	    (unsigned)cy >= (unsigned)this->chunksHigh) {
+		throw std::out_of_range("Chunk is outside of the TileStorage");
+	}
+
+	return this->chunks[chunkIndex(layer, cx, cy)];
+}
+
+const TileChunk& TileStorage::getChunk(int layer, int cx, int cy) const
+{
+	return const_cast<TileStorage*>(this)->getChunk(layer, cx, cy);
+}
+
+/* ========= Getters =========*/
+
+int TileStorage::getWidth() const
+{
+	return this->width;
+}
+
+int TileStorage::getHeight() const
+{
+	return this->height;
+}
+
+int TileStorage::getLayerCount() const
+{
+	return this->layers;
+}
+
+int TileStorage::getChunksWide() const
+{
+	return this->chunksWide;
+}
+
+int TileStorage::getChunksHigh() const
+{
+	return this->chunksHigh;
+}
+
+/**
+ * @brief Get the approximate number of bytes used by every chunk
+ */
+size_t TileStorage::getMemoryUsage() const
+{
+	size_t bytes = 0;
+
+	for (auto& chunk : this->chunks) {
+		bytes += chunk.getMemoryUsage();
+	}
+
+	return bytes;
+}
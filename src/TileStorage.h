@@ -0,0 +1,76 @@
+#ifndef TILESTORAGE_H_
+#define TILESTORAGE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "TileChunk.h"
+#include "Point.h"
+
+namespace tiledl
+{
+	/**
+	 * Layers of 32-bit tile ids stored in palette compressed TileChunks.
+	 *
+	 * A map mostly made of large areas of the same few tiles costs a small
+	 * fraction of a plain array, and get() is a shift, a mask and two loads.
+	 */
+	class TileStorage
+	{
+	public:
+		TileStorage();
+		TileStorage(int width, int height, int layers);
+		~TileStorage();
+
+		void resize(int width, int height, int layers);
+		void fill(int layer, Uint32 id);
+		void compact();
+
+		bool isInside(int x, int y) const;
+		Uint32 get(int layer, int x, int y) const;
+		void set(int layer, int x, int y, Uint32 id);
+
+		TileChunk& getChunk(int layer, int cx, int cy);
+		const TileChunk& getChunk(int layer, int cx, int cy) const;
+
+		// Getters
+		int getWidth() const;
+		int getHeight() const;
+		int getLayerCount() const;
+		int getChunksWide() const;
+		int getChunksHigh() const;
+		size_t getMemoryUsage() const;
+
+	private:
+		int chunkIndex(int layer, int cx, int cy) const;
+
+		std::vector<TileChunk> chunks;
+		int width, height, layers;
+		int chunksWide, chunksHigh;
+	};
+
+	inline bool TileStorage::isInside(int x, int y) const
+	{
+		return ((unsigned)x < (unsigned)this->width && (unsigned)y < (unsigned)this->height);
+	}
+
+	inline int TileStorage::chunkIndex(int layer, int cx, int cy) const
+	{
+		return (layer * this->chunksHigh + cy) * this->chunksWide + cx;
+	}
+
+	/**
+	 * @return the tile id, 0 outside of the storage
+	 */
+	inline Uint32 TileStorage::get(int layer, int x, int y) const
+	{
+		if (!isInside(x, y) || (unsigned)layer >= (unsigned)this->layers) {
+			return 0;
+		}
+
+		const TileChunk& chunk = this->chunks[chunkIndex(layer, x / TileChunk::SIZE, y / TileChunk::SIZE)];
+		return chunk.get(x % TileChunk::SIZE, y % TileChunk::SIZE);
+	}
+} // namespace tiledl
+
+#endif // TILESTORAGE_H_
@@ -0,0 +1,688 @@
+#include "TilemapRenderer.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+using namespace tiledl;
+
+static inline int floor_div(int a, int b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * @param tiles the tiles to draw, must outlive the TilemapRenderer
+ * @param tileWidth width of a tile in pixels, on screen and in the tilesets
+ * @param tileHeight height of a tile in pixels, on screen and in the tilesets
+ */
+TilemapRenderer::TilemapRenderer(const TileStorage& tiles, int tileWidth, int tileHeight)
+{
+	if (tileWidth <= 0 || tileHeight <= 0) {
+		throw std::invalid_argument("TilemapRenderer tiles must have a positive size");
+	}
+
+	this->tiles = &tiles;
+	this->tileWidth = tileWidth;
+	this->tileHeight = tileHeight;
+	this->chunksWide = tiles.getChunksWide();
+	this->chunksHigh = tiles.getChunksHigh();
+	this->passesDirty = true;
+	this->flatten = true;
+	this->owner = nullptr;
+	this->capacity = 256;
+	this->clock = 0;
+	this->drawn = this->skipped = this->baked = this->animatedDrawn = 0;
+}
+
+TilemapRenderer::~TilemapRenderer()
+{
+
+}
+
+/**
+ * @brief Add a layer drawn over every layer added before it
+ *
+ * @param layer layer of the TileStorage to draw
+ * @param tileset texture of the tiles, must outlive the TilemapRenderer
+ * @param parallax scrolling relative to the camera, {1, 1} moves with it and {0, 0} stays fixed
+ * @param dynamic true for layers that change most frames, they are never cached
+ * @return index of the new layer
+ */
+int TilemapRenderer::addLayer(int layer, Texture& tileset, const Vector& parallax, bool dynamic)
+{
+	if ((unsigned)layer >= (unsigned)this->tiles->getLayerCount()) {
+		throw std::out_of_range("Layer is outside of the TileStorage");
+	}
+
+	TilemapLayer added = { layer, &tileset, parallax, dynamic, true };
+	this->layers.push_back(added);
+	this->occupancy.push_back(std::vector<Uint64>());
+	this->animatedCells.push_back(std::unordered_map<int, std::vector<Uint16>>());
+
+	int index = (int)this->layers.size() - 1;
+	this->occupancy[index].assign(((size_t)this->chunksWide * this->chunksHigh + 63) / 64, 0);
+
+	for (int cy = 0; cy < this->chunksHigh; cy++) {
+		for (int cx = 0; cx < this->chunksWide; cx++) {
+			updateOccupancy(index, cx, cy);
+		}
+	}
+
+	this->passesDirty = true;
+	return index;
+}
+
+/**
+ * @brief Animate every tile of an id
+ *
+ * @param id tile id placed in the map
+ * @param frames tile ids drawn in its place in turn, from the same tileset
+ * @param frameTime milliseconds each frame is shown for
+ * @return index of the animation
+ * @note Redraws every cached chunk, add animations before drawing
+ */
+int TilemapRenderer::addAnimation(Uint32 id, const std::vector<Uint32>& frames, Uint32 frameTime)
+{
+	if (frames.empty() || frameTime == 0) {
+		throw std::invalid_argument("A tile animation needs at least one frame and a frame time");
+	}
+
+	Animation animation = { frames, frameTime, frames[0] };
+	this->animations.push_back(animation);
+	this->animated[id] = (int)this->animations.size() - 1;
+
+	invalidate();
+	return (int)this->animations.size() - 1;
+}
+
+/**
+ * @brief Advance every animation to the frame it shows at a time
+ *
+ * @param ticks time in milliseconds, such as SDL_GetTicks()
+ * @note Every animation shares the clock so tiles of the same id never drift apart
+ */
+void TilemapRenderer::animate(Uint32 ticks)
+{
+	for (auto& animation : this->animations) {
+		animation.current = animation.frames[(ticks / animation.frameTime) % animation.frames.size()];
+	}
+}
+
+/**
+ * @brief Draw every visible layer
+ *
+ * @param renderer renderer to draw with, cached chunks are dropped when it changes
+ * @param camera position of the top left of the view in the map, in pixels
+ * @param viewport area of the renderer the map is drawn in
+ * @note Chunks on the edge of the viewport are drawn whole, set a clip rectangle to cut them
+ */
+void TilemapRenderer::draw(Renderer& renderer, const Vector& camera, const Rectangle& viewport)
+{
+	prepare();
+
+	if (this->passesDirty) {
+		buildPasses();
+	}
+
+	if (renderer.getHandle() != this->owner) {
+		this->cache.clear();
+		this->owner = renderer.getHandle();
+	}
+
+	this->drawn = this->skipped = this->baked = this->animatedDrawn = 0;
+	this->clock++;
+
+	const int chunkWidth = TileChunk::SIZE * this->tileWidth;
+	const int chunkHeight = TileChunk::SIZE * this->tileHeight;
+
+	for (int p = 0; p < (int)this->passes.size(); p++) {
+		const Pass& pass = this->passes[p];
+		const int offsetX = (int)std::floor(camera.x * pass.parallax.x);
+		const int offsetY = (int)std::floor(camera.y * pass.parallax.y);
+
+		const int firstX = std::max(floor_div(offsetX, chunkWidth), 0);
+		const int firstY = std::max(floor_div(offsetY, chunkHeight), 0);
+		const int lastX = std::min(floor_div(offsetX + viewport.w - 1, chunkWidth), this->chunksWide - 1);
+		const int lastY = std::min(floor_div(offsetY + viewport.h - 1, chunkHeight), this->chunksHigh - 1);
+
+		for (int cy = firstY; cy <= lastY; cy++) {
+			for (int cx = firstX; cx <= lastX; cx++) {
+				if (!isPassOccupied(pass, cx, cy)) {
+					this->skipped++;
+					continue;
+				}
+
+				const int x = viewport.x - offsetX + cx * chunkWidth;
+				const int y = viewport.y - offsetY + cy * chunkHeight;
+				CachedChunk* cached = pass.dynamic ? nullptr : getCached(renderer, p, cx, cy);
+
+				if (cached != nullptr) {
+					renderer.copy(cached->texture, Rectangle(0, 0, chunkWidth, chunkHeight),
+					              Rectangle(x, y, chunkWidth, chunkHeight));
+
+					// Animated tiles are drawn over the rest of their pass
+					for (int index : pass.layers) {
+						drawAnimated(renderer, index, cx, cy, x, y);
+					}
+				} else {
+					// Only the tiles inside the viewport and the map
+					const Rectangle cells = getCells(cx, cy);
+					const int left = std::max(floor_div(offsetX - cx * chunkWidth, this->tileWidth), 0);
+					const int top = std::max(floor_div(offsetY - cy * chunkHeight, this->tileHeight), 0);
+					const int right = std::min(floor_div(offsetX + viewport.w - 1 - cx * chunkWidth, this->tileWidth),
+					                           cells.w - 1);
+					const int bottom = std::min(floor_div(offsetY + viewport.h - 1 - cy * chunkHeight, this->tileHeight),
+					                            cells.h - 1);
+					Rectangle area(left, top, right - left + 1, bottom - top + 1);
+
+					for (int index : pass.layers) {
+						if (isOccupied(index, cx, cy)) {
+							drawTiles(renderer, this->layers[index], cx, cy, area, x, y, nullptr);
+						}
+					}
+				}
+
+				this->drawn++;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Drop every cached chunk and recompute which chunks are occupied
+ *
+ * @note Call after changing many tiles at once, such as loading a map
+ */
+void TilemapRenderer::invalidate()
+{
+	this->chunksWide = -1;
+	prepare();
+}
+
+/**
+ * @brief Redraw a chunk of a TileStorage layer the next time it is drawn
+ *
+ * @param layer layer of the TileStorage that changed
+ * @param cx column of the chunk
+ * @param cy row of the chunk
+ * @note Call after changing tiles of static layers, such as for every Autotiler dirty chunk
+ */
+void TilemapRenderer::invalidate(int layer, int cx, int cy)
+{
+	prepare();
+
+	if ((unsigned)cx >= (unsigned)this->chunksWide || (unsigned)cy >= (unsigned)this->chunksHigh) {
+		return;
+	}
+
+	for (int i = 0; i < (int)this->layers.size(); i++) {
+		if (this->layers[i].layer == layer) {
+			updateOccupancy(i, cx, cy);
+		}
+	}
+
+	if (this->passesDirty) {
+		return;
+	}
+
+	for (int p = 0; p < (int)this->passes.size(); p++) {
+		for (int index : this->passes[p].layers) {
+			if (this->layers[index].layer != layer) {
+				continue;
+			}
+
+			auto it = this->cache.find(((Uint64)p << 32) | (Uint32)(cy * this->chunksWide + cx));
+
+			if (it != this->cache.end()) {
+				it->second->dirty = true;
+			}
+
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Get if a layer has any tile in a chunk
+ */
+bool TilemapRenderer::isOccupied(int index, int cx, int cy) const
+{
+	const size_t bit = (size_t)cy * this->chunksWide + cx;
+	return (this->occupancy[index][bit >> 6] >> (bit & 63)) & 1;
+}
+
+/**
+ * @brief Start over when the TileStorage changed size
+ */
+void TilemapRenderer::prepare()
+{
+	if (this->chunksWide == this->tiles->getChunksWide() && this->chunksHigh == this->tiles->getChunksHigh()) {
+		return;
+	}
+
+	this->chunksWide = this->tiles->getChunksWide();
+	this->chunksHigh = this->tiles->getChunksHigh();
+	this->cache.clear();
+
+	for (int i = 0; i < (int)this->layers.size(); i++) {
+		this->animatedCells[i].clear();
+		this->occupancy[i].assign(((size_t)this->chunksWide * this->chunksHigh + 63) / 64, 0);
+
+		for (int cy = 0; cy < this->chunksHigh; cy++) {
+			for (int cx = 0; cx < this->chunksWide; cx++) {
+				updateOccupancy(i, cx, cy);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Group the visible layers into the passes drawn each frame
+ */
+void TilemapRenderer::buildPasses()
+{
+	this->passes.clear();
+	this->cache.clear();
+
+	for (int i = 0; i < (int)this->layers.size(); i++) {
+		const TilemapLayer& layer = this->layers[i];
+
+		if (!layer.visible) {
+			continue;
+		}
+
+		// A pass ends at a layer with animated tiles, they are drawn over the whole pass
+		if (this->flatten && !layer.dynamic && !this->passes.empty() &&
+		    !this->passes.back().dynamic && this->passes.back().parallax == layer.parallax &&
+		    this->animatedCells[this->passes.back().layers.back()].empty()) {
+			this->passes.back().layers.push_back(i);
+			continue;
+		}
+
+		Pass pass;
+		pass.layers.push_back(i);
+		pass.parallax = layer.parallax;
+		pass.dynamic = layer.dynamic;
+		this->passes.push_back(pass);
+	}
+
+	this->passesDirty = false;
+}
+
+/**
+ * @brief Get the cells of a chunk inside the map, edge chunks are cut short
+ */
+Rectangle TilemapRenderer::getCells(int cx, int cy) const
+{
+	return Rectangle(0, 0,
+	                 std::max(std::min(TileChunk::SIZE, this->tiles->getWidth() - cx * TileChunk::SIZE), 0),
+	                 std::max(std::min(TileChunk::SIZE, this->tiles->getHeight() - cy * TileChunk::SIZE), 0));
+}
+
+void TilemapRenderer::updateOccupancy(int index, int cx, int cy)
+{
+	const TileChunk& chunk = this->tiles->getChunk(this->layers[index].layer, cx, cy);
+	const Rectangle cells = getCells(cx, cy);
+	bool occupied = false;
+
+	// Cells past the edge of the map are never drawn, whatever they hold
+	if (chunk.isUniform()) {
+		occupied = chunk.get(0, 0) != 0 && cells.w > 0 && cells.h > 0;
+	} else {
+		for (int ty = 0; !occupied && ty < cells.h; ty++) {
+			for (int tx = 0; !occupied && tx < cells.w; tx++) {
+				occupied = chunk.get(tx, ty) != 0;
+			}
+		}
+	}
+
+	const size_t bit = (size_t)cy * this->chunksWide + cx;
+	Uint64& word = this->occupancy[index][bit >> 6];
+	word = occupied ? (word | (1ULL << (bit & 63))) : (word & ~(1ULL << (bit & 63)));
+
+	// Dynamic layers are never cached so they need no list of animated cells
+	const int key = cy * this->chunksWide + cx;
+	const bool wasAnimated = !this->animatedCells[index].empty();
+	this->animatedCells[index].erase(key);
+
+	bool any = false;
+
+	if (occupied && !this->animated.empty() && !this->layers[index].dynamic) {
+		for (Uint32 id : chunk.getPalette()) {
+			any = any || this->animated.count(id) != 0;
+		}
+	}
+
+	if (any) {
+		std::vector<Uint16> found;
+
+		for (int ty = 0; ty < cells.h; ty++) {
+			for (int tx = 0; tx < cells.w; tx++) {
+				if (this->animated.count(chunk.get(tx, ty)) != 0) {
+					found.push_back((Uint16)(ty * TileChunk::SIZE + tx));
+				}
+			}
+		}
+
+		if (!found.empty()) {
+			found.shrink_to_fit();
+			this->animatedCells[index][key].swap(found);
+		}
+	}
+
+	// Flattened passes end at layers with animated tiles
+	if (wasAnimated != !this->animatedCells[index].empty()) {
+		this->passesDirty = true;
+	}
+}
+
+bool TilemapRenderer::isPassOccupied(const Pass& pass, int cx, int cy) const
+{
+	for (int index : pass.layers) {
+		if (isOccupied(index, cx, cy)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Get the cached texture of a chunk of a pass, drawing it if needed
+ *
+ * @return null if caching is off or the renderer cannot draw to textures
+ */
+TilemapRenderer::CachedChunk* TilemapRenderer::getCached(Renderer& renderer, int pass, int cx, int cy)
+{
+	if (this->capacity <= 0) {
+		return nullptr;
+	}
+
+	const Uint64 key = ((Uint64)pass << 32) | (Uint32)(cy * this->chunksWide + cx);
+	auto it = this->cache.find(key);
+
+	if (it == this->cache.end()) {
+		if ((int)this->cache.size() >= this->capacity) {
+			evict();
+		}
+
+		std::unique_ptr<CachedChunk> cached(new CachedChunk());
+
+		if (!cached->texture.create(renderer.getHandle(), SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_TARGET,
+		                            TileChunk::SIZE * this->tileWidth, TileChunk::SIZE * this->tileHeight)) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+			             "TilemapRenderer (%p) : Cannot cache chunks, drawing every tile instead", this);
+			this->capacity = 0;
+			return nullptr;
+		}
+
+		cached->texture.setBlendMode(SDL_BLENDMODE_BLEND);
+		cached->dirty = true;
+		it = this->cache.emplace(key, std::move(cached)).first;
+	}
+
+	CachedChunk* cached = it->second.get();
+	cached->lastUsed = this->clock;
+
+	if (cached->dirty) {
+		bake(renderer, this->passes[pass], cx, cy, cached->texture);
+		cached->dirty = false;
+	}
+
+	return cached;
+}
+
+/**
+ * @brief Draw every layer of a pass in a chunk into a texture
+ */
+void TilemapRenderer::bake(Renderer& renderer, const Pass& pass, int cx, int cy, Texture& texture)
+{
+	SDL_Texture* previous = renderer.getTarget();
+	Uint8 r, g, b, a;
+	SDL_GetRenderDrawColor(renderer.getHandle(), &r, &g, &b, &a);
+
+	renderer.setTarget(texture);
+	renderer.setDrawColor(0, 0, 0, 0);
+	renderer.clear();
+
+	for (int index : pass.layers) {
+		if (!isOccupied(index, cx, cy)) {
+			continue;
+		}
+
+		// Leave out the animated cells, they are drawn every frame
+		Uint64 skip[TileChunk::AREA / 64] = { 0 };
+		auto it = this->animatedCells[index].find(cy * this->chunksWide + cx);
+
+		if (it != this->animatedCells[index].end()) {
+			for (Uint16 cell : it->second) {
+				skip[cell >> 6] |= 1ULL << (cell & 63);
+			}
+		}
+
+		drawTiles(renderer, this->layers[index], cx, cy, getCells(cx, cy), 0, 0, skip);
+	}
+
+	renderer.setTarget(previous);
+	renderer.setDrawColor(r, g, b, a);
+	this->baked++;
+}
+
+/**
+ * @param tiles area of the chunk to draw, in tiles
+ * @param x where the top left of the chunk is drawn
+ * @param y where the top left of the chunk is drawn
+ * @param skip bits of the cells not to draw, can be null
+ */
+void TilemapRenderer::drawTiles(Renderer& renderer, const TilemapLayer& layer, int cx, int cy,
+                                const Rectangle& tiles, int x, int y, const Uint64* skip)
+{
+	const TileChunk& chunk = this->tiles->getChunk(layer.layer, cx, cy);
+
+	for (int ty = tiles.y; ty < tiles.y + tiles.h; ty++) {
+		for (int tx = tiles.x; tx < tiles.x + tiles.w; tx++) {
+			const int cell = ty * TileChunk::SIZE + tx;
+
+			if (skip != nullptr && ((skip[cell >> 6] >> (cell & 63)) & 1)) {
+				continue;
+			}
+
+			drawTile(renderer, layer, getFrame(chunk.get(tx, ty)), x + tx * this->tileWidth, y + ty * this->tileHeight);
+		}
+	}
+}
+
+void TilemapRenderer::drawTile(Renderer& renderer, const TilemapLayer& layer, Uint32 id, int x, int y)
+{
+	const int columns = layer.tileset->getWidth() / this->tileWidth;
+
+	if (id == 0 || columns <= 0) {
+		return;
+	}
+
+	Rectangle src((int)((id - 1) % columns) * this->tileWidth, (int)((id - 1) / columns) * this->tileHeight,
+	              this->tileWidth, this->tileHeight);
+	renderer.copy(*layer.tileset, src, Rectangle(x, y, this->tileWidth, this->tileHeight));
+}
+
+/**
+ * @brief Draw the current frame of every animated cell of a layer in a chunk
+ */
+void TilemapRenderer::drawAnimated(Renderer& renderer, int index, int cx, int cy, int x, int y)
+{
+	auto it = this->animatedCells[index].find(cy * this->chunksWide + cx);
+
+	if (it == this->animatedCells[index].end()) {
+		return;
+	}
+
+	const TilemapLayer& layer = this->layers[index];
+	const TileChunk& chunk = this->tiles->getChunk(layer.layer, cx, cy);
+
+	for (Uint16 cell : it->second) {
+		const int tx = cell % TileChunk::SIZE, ty = cell / TileChunk::SIZE;
+		drawTile(renderer, layer, getFrame(chunk.get(tx, ty)), x + tx * this->tileWidth, y + ty * this->tileHeight);
+	}
+
+	this->animatedDrawn += (int)it->second.size();
+}
+
+void TilemapRenderer::evict()
+{
+	auto oldest = this->cache.begin();
+
+	for (auto it = this->cache.begin(); it != this->cache.end(); it++) {
+		if (it->second->lastUsed < oldest->second->lastUsed) {
+			oldest = it;
+		}
+	}
+
+	if (oldest != this->cache.end()) {
+		this->cache.erase(oldest);
+	}
+}
+
+/**
+ * @brief Get the id drawn for a tile id, the current frame if it is animated
+ */
+Uint32 TilemapRenderer::getFrame(Uint32 id) const
+{
+	if (this->animated.empty()) {
+		return id;
+	}
+
+	auto it = this->animated.find(id);
+	return (it == this->animated.end()) ? id : this->animations[it->second].current;
+}
+
+/* ========= Getters =========*/
+
+int TilemapRenderer::getLayerCount() const
+{
+	return (int)this->layers.size();
+}
+
+const TilemapLayer& TilemapRenderer::getLayer(int index) const
+{
+	return this->layers.at(index);
+}
+
+int TilemapRenderer::getTileWidth() const
+{
+	return this->tileWidth;
+}
+
+int TilemapRenderer::getTileHeight() const
+{
+	return this->tileHeight;
+}
+
+bool TilemapRenderer::getFlatten() const
+{
+	return this->flatten;
+}
+
+int TilemapRenderer::getCacheCapacity() const
+{
+	return this->capacity;
+}
+
+/**
+ * @brief Get the number of chunk textures held
+ */
+int TilemapRenderer::getCachedCount() const
+{
+	return (int)this->cache.size();
+}
+
+/**
+ * @brief Get the number of passes over the viewport each frame
+ */
+int TilemapRenderer::getPassCount()
+{
+	prepare();
+
+	if (this->passesDirty) {
+		buildPasses();
+	}
+
+	return (int)this->passes.size();
+}
+
+/**
+ * @brief Get the number of chunks drawn by the last draw()
+ */
+int TilemapRenderer::getDrawnCount() const
+{
+	return this->drawn;
+}
+
+/**
+ * @brief Get the number of empty chunks skipped by the last draw()
+ */
+int TilemapRenderer::getSkippedCount() const
+{
+	return this->skipped;
+}
+
+/**
+ * @brief Get the number of chunks drawn into their cached texture by the last draw()
+ */
+int TilemapRenderer::getBakedCount() const
+{
+	return this->baked;
+}
+
+int TilemapRenderer::getAnimationCount() const
+{
+	return (int)this->animations.size();
+}
+
+/**
+ * @brief Get the number of animated cells drawn over cached chunks by the last draw()
+ */
+int TilemapRenderer::getAnimatedCount() const
+{
+	return this->animatedDrawn;
+}
+
+/**
+ * @brief Get the number of animated cells of a layer in a chunk
+ */
+int TilemapRenderer::getAnimatedCellCount(int index, int cx, int cy) const
+{
+	auto it = this->animatedCells.at(index).find(cy * this->chunksWide + cx);
+	return (it == this->animatedCells[index].end()) ? 0 : (int)it->second.size();
+}
+
+/* ========= Setters =========*/
+
+void TilemapRenderer::setLayerVisible(int index, bool visible)
+{
+	this->layers.at(index).visible = visible;
+	this->passesDirty = true;
+}
+
+/**
+ * @brief Set if neighbouring static layers of the same parallax are cached together
+ */
+void TilemapRenderer::setFlatten(bool flatten)
+{
+	if (flatten != this->flatten) {
+		this->flatten = flatten;
+		this->passesDirty = true;
+	}
+}
+
+/**
+ * @param capacity most chunk textures kept, 0 draws every layer tile by tile
+ * @note Should be more than the chunks visible at once times the number of static passes
+ */
+void TilemapRenderer::setCacheCapacity(int capacity)
+{
+	this->capacity = std::max(capacity, 0);
+
+	while ((int)this->cache.size() > this->capacity) {
+		evict();
+	}
+}
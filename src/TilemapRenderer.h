@@ -0,0 +1,139 @@
+#ifndef TILEMAPRENDERER_H_
+#define TILEMAPRENDERER_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "TileStorage.h"
+#include "Renderer.h"
+#include "Texture.h"
+#include "Rectangle.h"
+#include "Vector.h"
+#include "Point.h"
+
+namespace tiledl
+{
+	/**
+	 * A layer of a TileStorage drawn by a TilemapRenderer
+	 */
+	struct TilemapLayer {
+		int layer;        // layer of the TileStorage
+		Texture* tileset; // tiles in rows, id 1 is the top left tile and id 0 is never drawn
+		Vector parallax;  // how far the layer scrolls with the camera, 1 for the ground
+		bool dynamic;     // drawn tile by tile every frame instead of cached
+		bool visible;
+	};
+
+	/**
+	 * Draws the layers of a TileStorage in order, each scrolling with its own
+	 * parallax factor.
+	 *
+	 * Static layers are drawn once per chunk into a cached texture and copied
+	 * from then on, until invalidate() is called for the chunk. With
+	 * flattening on, neighbouring static layers of the same parallax share one
+	 * cached texture so they cost a single copy instead of one pass each.
+	 * Every layer keeps a bitmap of the chunks that have any tile in them,
+	 * empty chunks are skipped without touching the renderer.
+	 *
+	 * Animated tiles are left out of the cached textures. Each chunk keeps a
+	 * list of its animated cells, which are drawn over the cached texture
+	 * every frame, so animating never invalidates a chunk. Every tile of an
+	 * animation shows the same frame, advanced by animate(). A flattened pass
+	 * ends at a layer with animated tiles, so the layers above still cover them.
+	 */
+	class TilemapRenderer
+	{
+	public:
+		TilemapRenderer(const TileStorage& tiles, int tileWidth, int tileHeight);
+		~TilemapRenderer();
+
+		int addLayer(int layer, Texture& tileset, const Vector& parallax, bool dynamic);
+		int addAnimation(Uint32 id, const std::vector<Uint32>& frames, Uint32 frameTime);
+		void animate(Uint32 ticks);
+		void draw(Renderer& renderer, const Vector& camera, const Rectangle& viewport);
+
+		void invalidate();
+		void invalidate(int layer, int cx, int cy);
+
+		bool isOccupied(int index, int cx, int cy) const;
+		Uint32 getFrame(Uint32 id) const;
+
+		// Getters
+		int getLayerCount() const;
+		const TilemapLayer& getLayer(int index) const;
+		int getTileWidth() const;
+		int getTileHeight() const;
+		bool getFlatten() const;
+		int getCacheCapacity() const;
+		int getCachedCount() const;
+		int getPassCount();
+		int getDrawnCount() const;
+		int getSkippedCount() const;
+		int getBakedCount() const;
+		int getAnimationCount() const;
+		int getAnimatedCount() const;
+		int getAnimatedCellCount(int index, int cx, int cy) const;
+
+		// Setters
+		void setLayerVisible(int index, bool visible);
+		void setFlatten(bool flatten);
+		void setCacheCapacity(int capacity);
+
+	private:
+		struct Pass {
+			std::vector<int> layers; // indices into layers
+			Vector parallax;
+			bool dynamic;
+		};
+
+		struct Animation {
+			std::vector<Uint32> frames;
+			Uint32 frameTime;
+			Uint32 current; // id of the frame shown
+		};
+
+		struct CachedChunk {
+			Texture texture;
+			Uint64 lastUsed;
+			bool dirty;
+		};
+
+		void prepare();
+		void buildPasses();
+		void updateOccupancy(int index, int cx, int cy);
+		Rectangle getCells(int cx, int cy) const;
+		bool isPassOccupied(const Pass& pass, int cx, int cy) const;
+		CachedChunk* getCached(Renderer& renderer, int pass, int cx, int cy);
+		void bake(Renderer& renderer, const Pass& pass, int cx, int cy, Texture& texture);
+		void drawTiles(Renderer& renderer, const TilemapLayer& layer, int cx, int cy, const Rectangle& tiles, int x, int y,
+		               const Uint64* skip);
+		void drawTile(Renderer& renderer, const TilemapLayer& layer, Uint32 id, int x, int y);
+		void drawAnimated(Renderer& renderer, int index, int cx, int cy, int x, int y);
+		void evict();
+
+		const TileStorage* tiles;
+		int tileWidth, tileHeight;
+		int chunksWide, chunksHigh;
+		std::vector<TilemapLayer> layers;
+		std::vector<std::vector<Uint64>> occupancy; // per layer, one bit per chunk
+
+		std::vector<Animation> animations;
+		std::unordered_map<Uint32, int> animated; // tile id to animation
+		std::vector<std::unordered_map<int, std::vector<Uint16>>> animatedCells; // per layer, chunk to cells
+
+		std::vector<Pass> passes;
+		bool passesDirty;
+		bool flatten;
+
+		std::unordered_map<Uint64, std::unique_ptr<CachedChunk>> cache;
+		SDL_Renderer* owner;
+		int capacity;
+		Uint64 clock;
+
+		int drawn, skipped, baked, animatedDrawn;
+	};
+} // namespace tiledl
+
+#endif // TILEMAPRENDERER_H_
@@ -0,0 +1,225 @@
+#include "VisibilityMap.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace tiledl;
+
+static inline int lowest_bit(Uint64 word)
+{
+	int bit = 0;
+
+	while (((word >> bit) & 1) == 0) {
+		bit++;
+	}
+
+	return bit;
+}
+
+static inline int highest_bit(Uint64 word)
+{
+	int bit = 63;
+
+	while (((word >> bit) & 1) == 0) {
+		bit--;
+	}
+
+	return bit;
+}
+
+VisibilityMap::VisibilityMap()
+{
+	this->width = this->height = this->stride = 0;
+}
+
+VisibilityMap::VisibilityMap(int width, int height) : VisibilityMap()
+{
+	resize(width, height);
+}
+
+VisibilityMap::~VisibilityMap()
+{
+
+}
+
+/**
+ * @brief Resize the map in tiles, clearing every tile
+ */
+void VisibilityMap::resize(int width, int height)
+{
+	if (width < 0 || height < 0) {
+		throw std::invalid_argument("A VisibilityMap cannot have a negative size");
+	}
+
+	this->width = width;
+	this->height = height;
+	this->stride = (width + 63) / 64;
+	this->words.assign((size_t)this->stride * height, 0);
+}
+
+void VisibilityMap::clear()
+{
+	std::fill(this->words.begin(), this->words.end(), 0);
+}
+
+/**
+ * @brief Clip an area in tiles to the map
+ *
+ * @return false if nothing of the area is inside the map
+ */
+bool VisibilityMap::clip(const Rectangle& area, int& x0, int& y0, int& x1, int& y1) const
+{
+	x0 = std::max(area.x, 0);
+	y0 = std::max(area.y, 0);
+	x1 = std::min(area.x + area.w, this->width);
+	y1 = std::min(area.y + area.h, this->height);
+
+	return (x0 < x1 && y0 < y1);
+}
+
+/**
+ * @brief Clear the words covering an area
+ *
+ * @note Whole words are cleared, so tiles up to 63 either side of the area may be cleared too
+ */
+void VisibilityMap::clear(const Rectangle& area)
+{
+	int x0, y0, x1, y1;
+
+	if (!clip(area, x0, y0, x1, y1)) {
+		return;
+	}
+
+	for (int y = y0; y < y1; y++) {
+		Uint64* row = &this->words[y * this->stride];
+		std::fill(row + (x0 >> 6), row + ((x1 - 1) >> 6) + 1, 0);
+	}
+}
+
+/**
+ * @brief Mark every tile visible in another map of the same size as visible in this one
+ *
+ * @param area only the words covering this area are merged
+ */
+void VisibilityMap::merge(const VisibilityMap& other, const Rectangle& area)
+{
+	if (other.width != this->width || other.height != this->height) {
+		throw std::invalid_argument("Cannot merge VisibilityMaps of different sizes");
+	}
+
+	int x0, y0, x1, y1;
+
+	if (!clip(area, x0, y0, x1, y1)) {
+		return;
+	}
+
+	for (int y = y0; y < y1; y++) {
+		for (int w = (x0 >> 6); w <= ((x1 - 1) >> 6); w++) {
+			this->words[y * this->stride + w] |= other.words[y * this->stride + w];
+		}
+	}
+}
+
+/**
+ * @brief Find the tiles that differ from another map of the same size
+ *
+ * @return the smallest area containing every tile that differs, empty if the maps are equal
+ */
+Rectangle VisibilityMap::diff(const VisibilityMap& other) const
+{
+	if (other.width != this->width || other.height != this->height) {
+		throw std::invalid_argument("Cannot diff VisibilityMaps of different sizes");
+	}
+
+	int x0 = this->width, y0 = this->height, x1 = -1, y1 = -1;
+
+	for (int y = 0; y < this->height; y++) {
+		for (int w = 0; w < this->stride; w++) {
+			Uint64 changed = this->words[y * this->stride + w] ^ other.words[y * this->stride + w];
+
+			if (changed == 0) {
+				continue;
+			}
+
+			int first = w * 64 + lowest_bit(changed);
+			int last = w * 64 + highest_bit(changed);
+
+			x0 = std::min(x0, first);
+			x1 = std::max(x1, last);
+			y0 = std::min(y0, y);
+			y1 = std::max(y1, y);
+		}
+	}
+
+	if (x1 < 0) {
+		return Rectangle(0, 0, 0, 0);
+	}
+
+	return Rectangle(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+/**
+ * @brief Count the visible tiles
+ */
+int VisibilityMap::count() const
+{
+	int total = 0;
+
+	for (Uint64 word : this->words) {
+		while (word != 0) {
+			word &= word - 1;
+			total++;
+		}
+	}
+
+	return total;
+}
+
+/**
+ * @brief Write an area of the map into a streaming texture, one texel per tile
+ *
+ * @param texture a 32 bit streaming texture at least as large as the map
+ * @param area area of tiles to write, such as the result of diff()
+ * @param visible texel for visible tiles
+ * @param hidden texel for hidden tiles
+ * @return true on success, an empty area is always a success
+ */
+bool VisibilityMap::upload(Texture& texture, const Rectangle& area, Uint32 visible, Uint32 hidden) const
+{
+	int x0, y0, x1, y1;
+
+	if (!clip(area, x0, y0, x1, y1)) {
+		return true;
+	}
+
+	SDL_Rect rect = { x0, y0, x1 - x0, y1 - y0 };
+	void* pixels;
+	int pitch;
+
+	if (!texture.lock(&rect, &pixels, &pitch)) {
+		return false;
+	}
+
+	for (int y = y0; y < y1; y++) {
+		Uint32* row = (Uint32*)((Uint8*)pixels + (y - y0) * pitch);
+		const Uint64* bits = &this->words[y * this->stride];
+
+		for (int x = x0; x < x1; x++) {
+			row[x - x0] = ((bits[x >> 6] >> (x & 63)) & 1) ? visible : hidden;
+		}
+	}
+
+	texture.unlock();
+	return true;
+}
+
+/* ========= Getters =========*/
+
+int VisibilityMap::getWidth() const
+{
+	return this->width;
+}
+
+int VisibilityMap::getHeight() const
+{
+	return this->height;
+}
@@ -0,0 +1,64 @@
+#ifndef VISIBILITYMAP_H_
+#define VISIBILITYMAP_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Rectangle.h"
+#include "Texture.h"
+
+namespace tiledl
+{
+	/**
+	 * One visibility bit per tile, packed 64 tiles to a word along each row.
+	 */
+	class VisibilityMap
+	{
+	public:
+		VisibilityMap();
+		VisibilityMap(int width, int height);
+		~VisibilityMap();
+
+		void resize(int width, int height);
+		void clear();
+		void clear(const Rectangle& area);
+		void merge(const VisibilityMap& other, const Rectangle& area);
+		Rectangle diff(const VisibilityMap& other) const;
+		int count() const;
+
+		bool upload(Texture& texture, const Rectangle& area, Uint32 visible, Uint32 hidden) const;
+
+		bool isVisible(int x, int y) const;
+		void set(int x, int y);
+
+		// Getters
+		int getWidth() const;
+		int getHeight() const;
+
+	private:
+		bool clip(const Rectangle& area, int& x0, int& y0, int& x1, int& y1) const;
+
+		std::vector<Uint64> words;
+		int width, height;
+		int stride; // words per row
+	};
+
+	inline bool VisibilityMap::isVisible(int x, int y) const
+	{
+		if ((unsigned)x >= (unsigned)this->width || (unsigned)y >= (unsigned)this->height) {
+			return false;
+		}
+
+		return (this->words[y * this->stride + (x >> 6)] >> (x & 63)) & 1;
+	}
+
+	/**
+	 * @note Does no bounds checking
+	 */
+	inline void VisibilityMap::set(int x, int y)
+	{
+		this->words[y * this->stride + (x >> 6)] |= (Uint64)1 << (x & 63);
+	}
+} // namespace tiledl
+
+#endif // VISIBILITYMAP_H_
@@ -0,0 +1,169 @@
+#ifndef WORKSTEALINGDEQUE_H_
+#define WORKSTEALINGDEQUE_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include "CacheLine.h"
+
+namespace tiledl
+{
+	/**
+	 * A fixed size Chase-Lev deque of pointers, owned by one thread and
+	 * stolen from by any other.
+	 *
+	 * The owner pushes and pops at the bottom, last in first out so it
+	 * works on what is still in its cache. Thieves take from the top, the
+	 * oldest and usually largest piece of work. Only the last item is ever
+	 * contended, the owner and a thief race for it with one compare and swap.
+	 */
+	template<typename T>
+	class WorkStealingDeque
+	{
+	public:
+		WorkStealingDeque(size_t capacity);
+		~WorkStealingDeque();
+
+		bool push(T* item);
+		T* pop();
+		T* steal();
+
+		bool isEmpty() const;
+		size_t getCapacity() const;
+
+	private:
+		WorkStealingDeque(const WorkStealingDeque&);
+		WorkStealingDeque& operator=(const WorkStealingDeque&);
+
+		std::unique_ptr<std::atomic<T*>[]> slots;
+		Sint64 mask;
+
+		// Kept on separate cache lines so stealers do not slow the owner
+		std::atomic<Sint64> top; // next item to steal
+		char padding[CACHE_LINE - sizeof(std::atomic<Sint64>)];
+		std::atomic<Sint64> bottom; // next slot to push, owned by the owner
+	};
+
+	/**
+	 * @param capacity most items held at once, rounded up to a power of two
+	 */
+	template<typename T>
+	WorkStealingDeque<T>::WorkStealingDeque(size_t capacity) : top(0), bottom(0)
+	{
+		if (capacity == 0) {
+			throw std::invalid_argument("WorkStealingDeque capacity must be greater than zero");
+		}
+
+		size_t size = 1;
+
+		while (size < capacity) {
+			size <<= 1;
+		}
+
+		this->slots.reset(new std::atomic<T*>[size]);
+		this->mask = (Sint64)size - 1;
+	}
+
+	template<typename T>
+	WorkStealingDeque<T>::~WorkStealingDeque()
+	{
+
+	}
+
+	/**
+	 * @brief Add an item to the bottom, only call from the owner thread
+	 *
+	 * @return false if the deque is full
+	 */
+	template<typename T>
+	bool WorkStealingDeque<T>::push(T* item)
+	{
+		const Sint64 bottom = this->bottom.load(std::memory_order_relaxed);
+		const Sint64 top = this->top.load(std::memory_order_acquire);
+
+		if (bottom - top > this->mask) {
+			return false;
+		}
+
+		this->slots[bottom & this->mask].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		this->bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/**
+	 * @brief Take the newest item, only call from the owner thread
+	 *
+	 * @return the item, nullptr if empty or a thief took the last one
+	 */
+	template<typename T>
+	T* WorkStealingDeque<T>::pop()
+	{
+		const Sint64 bottom = this->bottom.load(std::memory_order_relaxed) - 1;
+		this->bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		Sint64 top = this->top.load(std::memory_order_relaxed);
+
+		if (top > bottom) {
+			this->bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T* item = this->slots[bottom & this->mask].load(std::memory_order_relaxed);
+
+		if (top == bottom) {
+			// The last item, race the thieves for it
+			if (!this->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				item = nullptr;
+			}
+
+			this->bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		return item;
+	}
+
+	/**
+	 * @brief Take the oldest item, from any thread
+	 *
+	 * @return the item, nullptr if empty or another thread got it first
+	 */
+	template<typename T>
+	T* WorkStealingDeque<T>::steal()
+	{
+		Sint64 top = this->top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const Sint64 bottom = this->bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom) {
+			return nullptr;
+		}
+
+		T* item = this->slots[top & this->mask].load(std::memory_order_relaxed);
+
+		if (!this->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return nullptr;
+		}
+
+		return item;
+	}
+
+	/**
+	 * @note Only exact when called from the owner thread
+	 */
+	template<typename T>
+	bool WorkStealingDeque<T>::isEmpty() const
+	{
+		return this->top.load(std::memory_order_acquire) >= this->bottom.load(std::memory_order_acquire);
+	}
+
+	template<typename T>
+	size_t WorkStealingDeque<T>::getCapacity() const
+	{
+		return (size_t)this->mask + 1;
+	}
+} // namespace tiledl
+
+#endif // WORKSTEALINGDEQUE_H_
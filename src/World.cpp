@@ -0,0 +1,197 @@
+#include "World.h"
+#include "CommandBuffer.h"
+#include <stdexcept>
+
+using namespace tiledl;
+
+World::World() : iterating(0), commands(new CommandBuffer())
+{
+	this->alive = 0;
+	getArchetype(0);
+}
+
+World::~World()
+{
+
+}
+
+/**
+ * @brief Create an entity without any components
+ *
+ * @throws std::logic_error when creating while iterating
+ */
+Entity World::create()
+{
+	if (this->iterating > 0) {
+		throw std::logic_error("World cannot create entities while iterating, use a CommandBuffer");
+	}
+
+	Uint32 index;
+
+	if (this->freeIndices.empty()) {
+		index = (Uint32)this->records.size();
+		this->records.push_back({ 1, nullptr, 0, 0 });
+	} else {
+		index = this->freeIndices.back();
+		this->freeIndices.pop_back();
+	}
+
+	Record& record = this->records[index];
+	Entity entity(index, record.generation);
+	record.archetype = this->archetypeList[0];
+	record.row = record.archetype->append(entity, record.chunk);
+	this->alive++;
+	return entity;
+}
+
+/**
+ * @brief Destroy an entity and its components, its handle is never alive again
+ *
+ * @return false if the entity was not alive
+ * @throws std::logic_error when destroying while iterating
+ */
+bool World::destroy(Entity entity)
+{
+	if (!isAlive(entity)) {
+		return false;
+	}
+
+	if (this->iterating > 0) {
+		throw std::logic_error("World cannot destroy entities while iterating, use a CommandBuffer");
+	}
+
+	Record& record = this->records[entity.index];
+	Entity moved;
+
+	if (record.archetype->remove(record.chunk, record.row, true, moved)) {
+		this->records[moved.index].chunk = record.chunk;
+		this->records[moved.index].row = record.row;
+	}
+
+	// Generation 0 is never alive
+	if (++record.generation == 0) {
+		record.generation = 1;
+	}
+
+	record.archetype = nullptr;
+	this->freeIndices.push_back(entity.index);
+	this->alive--;
+	return true;
+}
+
+/**
+ * @brief Move an entity to the archetype with a component added or removed
+ *
+ * @return the unconstructed component when adding, nullptr when removing
+ */
+void* World::toggle(Entity entity, int component)
+{
+	if (!isAlive(entity)) {
+		throw std::invalid_argument("World entity is not alive");
+	}
+
+	if (this->iterating > 0) {
+		throw std::logic_error("World cannot add or remove components while iterating, use a CommandBuffer");
+	}
+
+	Record& record = this->records[entity.index];
+	Archetype* from = record.archetype;
+	Archetype* to = from->getEdge(component);
+
+	if (to == nullptr) {
+		to = getArchetype(from->getMask() ^ ((ComponentMask)1 << component));
+		from->setEdge(component, to);
+		to->setEdge(component, from);
+	}
+
+	int chunk;
+	const int row = to->append(entity, chunk);
+
+	for (int moving : from->getComponents()) {
+		const ComponentInfo& info = Components::getInfo(moving);
+		void* src = from->get(record.chunk, record.row, moving);
+
+		if (to->has(moving)) {
+			info.move(to->get(chunk, row, moving), src);
+		} else {
+			info.destroy(src);
+		}
+	}
+
+	Entity moved;
+
+	if (from->remove(record.chunk, record.row, false, moved)) {
+		this->records[moved.index].chunk = record.chunk;
+		this->records[moved.index].row = record.row;
+	}
+
+	record.archetype = to;
+	record.chunk = chunk;
+	record.row = row;
+	return to->get(chunk, row, component);
+}
+
+void* World::getComponent(Entity entity, int component) const
+{
+	if (!isAlive(entity)) {
+		return nullptr;
+	}
+
+	const Record& record = this->records[entity.index];
+	return record.archetype->get(record.chunk, record.row, component);
+}
+
+Archetype* World::getArchetype(ComponentMask mask)
+{
+	auto it = this->archetypes.find(mask);
+
+	if (it != this->archetypes.end()) {
+		return it->second.get();
+	}
+
+	Archetype* archetype = new Archetype(mask);
+	this->archetypes.insert(std::make_pair(mask, std::unique_ptr<Archetype>(archetype)));
+	this->archetypeList.push_back(archetype);
+	return archetype;
+}
+
+/**
+ * @brief Get the commands to run on the next flush()
+ */
+CommandBuffer& World::getCommands()
+{
+	return *this->commands;
+}
+
+/**
+ * @brief Run the commands queued in getCommands()
+ */
+void World::flush()
+{
+	this->commands->playback(*this);
+}
+
+/* ========= Getters =========*/
+
+int World::getEntityCount() const
+{
+	return this->alive;
+}
+
+int World::getArchetypeCount() const
+{
+	return (int)this->archetypeList.size();
+}
+
+/**
+ * @return every archetype in the order they were made, the first has no components
+ */
+const std::vector<Archetype*>& World::getArchetypes() const
+{
+	return this->archetypeList;
+}
+
+bool World::isIterating() const
+{
+	return this->iterating > 0;
+}
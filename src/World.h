@@ -0,0 +1,190 @@
+#ifndef WORLD_H_
+#define WORLD_H_
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <atomic>
+#include "Entity.h"
+#include "Archetype.h"
+
+namespace tiledl
+{
+	class CommandBuffer;
+
+	/**
+	 * Entities made of plain data components, grouped by which components
+	 * they have into Archetypes.
+	 *
+	 * each() visits every entity with a set of components, one chunk at a
+	 * time, reading the component arrays in order. Adding or removing a
+	 * component moves the entity to another archetype, so it is not allowed
+	 * while iterating, queue it in getCommands() and flush() it afterwards.
+	 *
+	 * Component pointers and references are only valid until the next
+	 * change to the structure of the world.
+	 */
+	class World
+	{
+	public:
+		World();
+		~World();
+
+		Entity create();
+		bool destroy(Entity entity);
+		bool isAlive(Entity entity) const;
+
+		template<typename T>
+		T& add(Entity entity, const T& value = T());
+		template<typename T>
+		bool remove(Entity entity);
+		template<typename T>
+		bool has(Entity entity) const;
+		template<typename T>
+		T* get(Entity entity) const;
+
+		template<typename... T, typename F>
+		void each(F function);
+		template<typename... T, typename F>
+		void eachChunk(F function);
+
+		CommandBuffer& getCommands();
+		void flush();
+
+		// Getters
+		int getEntityCount() const;
+		int getArchetypeCount() const;
+		const std::vector<Archetype*>& getArchetypes() const;
+		bool isIterating() const;
+
+	private:
+		World(const World&);
+		World& operator=(const World&);
+
+		struct Record {
+			Uint32 generation;
+			Archetype* archetype; // nullptr once destroyed
+			int chunk;
+			int row;
+		};
+
+		struct IterationGuard {
+			std::atomic<int>& depth;
+			IterationGuard(std::atomic<int>& depth) : depth(depth) { depth++; }
+			~IterationGuard() { depth--; }
+		};
+
+		void* toggle(Entity entity, int component);
+		void* getComponent(Entity entity, int component) const;
+		Archetype* getArchetype(ComponentMask mask);
+
+		std::vector<Record> records; // by entity index
+		std::vector<Uint32> freeIndices;
+		std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> archetypes;
+		std::vector<Archetype*> archetypeList;
+		int alive;
+		std::atomic<int> iterating; // queries run concurrently from a Scheduler
+
+		std::unique_ptr<CommandBuffer> commands;
+	};
+
+	inline bool World::isAlive(Entity entity) const
+	{
+		return entity.index < this->records.size() && entity.generation != 0 &&
+		       this->records[entity.index].generation == entity.generation;
+	}
+
+	/**
+	 * @brief Give an entity a component, or overwrite the one it has
+	 *
+	 * @return the component, valid until the structure changes
+	 * @throws std::invalid_argument if the entity is not alive
+	 * @throws std::logic_error when adding while iterating
+	 */
+	template<typename T>
+	T& World::add(Entity entity, const T& value)
+	{
+		if (T* existing = get<T>(entity)) {
+			*existing = value;
+			return *existing;
+		}
+
+		T copy(value);
+		void* slot = toggle(entity, Components::id<T>());
+		return *new (slot) T(std::move(copy));
+	}
+
+	/**
+	 * @return false if the entity did not have the component
+	 * @throws std::logic_error when removing while iterating
+	 */
+	template<typename T>
+	bool World::remove(Entity entity)
+	{
+		if (!has<T>(entity)) {
+			return false;
+		}
+
+		toggle(entity, Components::id<T>());
+		return true;
+	}
+
+	template<typename T>
+	bool World::has(Entity entity) const
+	{
+		return isAlive(entity) && this->records[entity.index].archetype->has(Components::id<T>());
+	}
+
+	/**
+	 * @return the component, nullptr if the entity is not alive or does not have it
+	 */
+	template<typename T>
+	T* World::get(Entity entity) const
+	{
+		return (T*)getComponent(entity, Components::id<T>());
+	}
+
+	/**
+	 * @brief Call a function on every entity with all of the components
+	 *
+	 * The function is called as function(Entity, T&...).
+	 */
+	template<typename... T, typename F>
+	void World::each(F function)
+	{
+		eachChunk<T...>([&function](int count, const Entity* entities, T*... arrays) {
+			for (int i = 0; i < count; i++) {
+				function(entities[i], arrays[i]...);
+			}
+		});
+	}
+
+	/**
+	 * @brief Call a function on every chunk of entities with all of the components
+	 *
+	 * The function is called as function(int count, const Entity*, T*...)
+	 * with the arrays of the chunk, for loops over them that want to be
+	 * vectorised.
+	 */
+	template<typename... T, typename F>
+	void World::eachChunk(F function)
+	{
+		const ComponentMask mask = Components::mask<T...>();
+		IterationGuard guard(this->iterating);
+
+		for (Archetype* archetype : this->archetypeList) {
+			if ((archetype->getMask() & mask) != mask) {
+				continue;
+			}
+
+			for (int chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+				function(archetype->getChunkSize(chunk), archetype->getEntities(chunk),
+				         (T*)archetype->getArray(chunk, Components::id<T>())...);
+			}
+		}
+	}
+} // namespace tiledl
+
+#endif // WORLD_H_
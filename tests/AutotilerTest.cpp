@@ -0,0 +1,104 @@
+#include <unittest++/UnitTest++.h>
+
+#include "Autotiler.h"
+#include <cstdlib>
+#include <set>
+#include <stdexcept>
+
+using namespace tiledl;
+
+SUITE(AutotilerTests)
+{
+	TEST(BlobVariants) {
+		std::set<int> variants;
+
+		for (int mask = 0; mask < 256; mask++) {
+			variants.insert(Autotiler::toVariant((Uint8)mask, AUTOTILE_8));
+		}
+
+		CHECK_EQUAL(47, (int)variants.size());
+		CHECK_EQUAL(47, Autotiler::getVariantCount(AUTOTILE_8));
+		CHECK_EQUAL(0, (int)Autotiler::toVariant(0, AUTOTILE_8));
+		CHECK_EQUAL(46, (int)Autotiler::toVariant(0xFF, AUTOTILE_8));
+
+		// A corner without both of its edges does not change the variant
+		CHECK_EQUAL((int)Autotiler::toVariant(AUTOTILE_NORTH, AUTOTILE_8),
+		            (int)Autotiler::toVariant(AUTOTILE_NORTH | AUTOTILE_NORTH_EAST, AUTOTILE_8));
+		CHECK((int)Autotiler::toVariant(AUTOTILE_NORTH | AUTOTILE_EAST, AUTOTILE_8) !=
+		      (int)Autotiler::toVariant(AUTOTILE_NORTH | AUTOTILE_EAST | AUTOTILE_NORTH_EAST, AUTOTILE_8));
+	}
+
+	TEST(EdgeMasks) {
+		TileStorage tiles(5, 5, 1);
+		Autotiler autotiler(tiles, 0, AUTOTILE_4);
+		autotiler.setEdgeConnects(false);
+		autotiler.rebuild();
+
+		CHECK_EQUAL(16, Autotiler::getVariantCount(AUTOTILE_4));
+		CHECK_EQUAL(15, (int)autotiler.getVariant(2, 2));
+		CHECK_EQUAL(2 | 4, (int)autotiler.getVariant(0, 0));
+		CHECK_EQUAL(AUTOTILE_EAST | AUTOTILE_SOUTH, (int)autotiler.getMask(0, 0));
+
+		tiles.set(0, 2, 2, 1);
+		autotiler.update(2, 2);
+		CHECK_EQUAL(0, (int)autotiler.getVariant(2, 2));
+		CHECK_EQUAL(2 | 4 | 8, (int)autotiler.getVariant(2, 3));
+		CHECK_EQUAL(1 | 2 | 4, (int)autotiler.getVariant(3, 2));
+
+		autotiler.setGroup(1, 0);
+		autotiler.rebuild();
+		CHECK_EQUAL(15, (int)autotiler.getVariant(2, 2));
+		CHECK_THROW(Autotiler(tiles, 1, AUTOTILE_4), std::out_of_range);
+	}
+
+	TEST(DirtyChunks) {
+		TileStorage tiles(100, 100, 2);
+		Autotiler autotiler(tiles, 1, AUTOTILE_8);
+
+		CHECK_EQUAL(16, (int)autotiler.getDirtyChunks().size());
+		autotiler.clearDirty();
+		CHECK_EQUAL(0, (int)autotiler.getDirtyChunks().size());
+		CHECK_EQUAL(false, autotiler.isDirty(0, 0));
+
+		// Other layers are not autotiled
+		tiles.set(0, 10, 10, 5);
+		autotiler.update(10, 10);
+		CHECK_EQUAL(1, (int)autotiler.getDirtyChunks().size());
+		autotiler.clearDirty();
+
+		// The neighbours across the chunk corner change too
+		tiles.set(1, 31, 31, 5);
+		autotiler.update(31, 31);
+		CHECK_EQUAL(4, (int)autotiler.getDirtyChunks().size());
+		CHECK_EQUAL(true, autotiler.isDirty(1, 1));
+		CHECK_EQUAL(false, autotiler.isDirty(2, 0));
+		CHECK_EQUAL(false, autotiler.isDirty(-1, 0));
+	}
+
+	TEST(UpdateMatchesRebuild) {
+		TileStorage tiles(70, 50, 1);
+		Autotiler incremental(tiles, 0, AUTOTILE_8);
+		srand(99);
+
+		for (int i = 0; i < 2000; i++) {
+			int x = rand() % 70, y = rand() % 50;
+			tiles.set(0, x, y, rand() % 3);
+			incremental.update(x, y);
+		}
+
+		tiles.set(0, 10, 10, 2);
+		tiles.set(0, 11, 10, 2);
+		incremental.update(Rectangle(10, 10, 2, 1));
+
+		Autotiler rebuilt(tiles, 0, AUTOTILE_8);
+		bool same = true;
+
+		for (int y = 0; y < 50; y++) {
+			for (int x = 0; x < 70; x++) {
+				same = same && incremental.getVariant(x, y) == rebuilt.getVariant(x, y);
+			}
+		}
+
+		CHECK_EQUAL(true, same);
+	}
+}
@@ -0,0 +1,109 @@
+#include <unittest++/UnitTest++.h>
+
+#include "Broadphase.h"
+#include <stdexcept>
+#include <cstdlib>
+
+using namespace tiledl;
+
+SUITE(BroadphaseTests)
+{
+	TEST(Empty) {
+		Broadphase bp;
+		CHECK_EQUAL(0, bp.getProxyCount());
+		CHECK_EQUAL(0, (int)bp.update().size());
+		CHECK_EQUAL(0, bp.getPairCount());
+	}
+
+	TEST(BeginContact) {
+		Broadphase bp;
+		int a = bp.add(Rectangle(0, 0, 10, 10));
+		int b = bp.add(Rectangle(5, 5, 10, 10));
+
+		auto& events = bp.update();
+		CHECK_EQUAL(1, (int)events.size());
+		CHECK_EQUAL(CONTACT_BEGIN, events[0].type);
+		CHECK_EQUAL(a, events[0].a);
+		CHECK_EQUAL(b, events[0].b);
+		CHECK_EQUAL(true, bp.isOverlapping(a, b));
+		CHECK_EQUAL(true, bp.isOverlapping(b, a));
+
+		// Nothing moved, nothing to report
+		CHECK_EQUAL(0, (int)bp.update().size());
+		CHECK_EQUAL(1, bp.getPairCount());
+	}
+
+	TEST(EndContact) {
+		Broadphase bp;
+		int a = bp.add(Rectangle(0, 0, 10, 10));
+		int b = bp.add(Rectangle(5, 5, 10, 10));
+		bp.update();
+
+		bp.move(b, Rectangle(20, 5, 10, 10));
+		auto& events = bp.update();
+		CHECK_EQUAL(1, (int)events.size());
+		CHECK_EQUAL(CONTACT_END, events[0].type);
+		CHECK_EQUAL(false, bp.isOverlapping(a, b));
+	}
+
+	TEST(TouchingEdges) {
+		Broadphase bp;
+		int a = bp.add(Rectangle(0, 0, 10, 10));
+		int b = bp.add(Rectangle(10, 0, 10, 10));
+		bp.update();
+
+		CHECK_EQUAL(false, bp.isOverlapping(a, b));
+		CHECK_EQUAL(Rectangle(0, 0, 10, 10).intersects(Rectangle(10, 0, 10, 10)), bp.isOverlapping(a, b));
+	}
+
+	TEST(Remove) {
+		Broadphase bp;
+		int a = bp.add(Rectangle(0, 0, 10, 10));
+		int b = bp.add(Rectangle(5, 5, 10, 10));
+		bp.update();
+
+		bp.remove(a);
+		CHECK_EQUAL(1, bp.getProxyCount());
+		auto& events = bp.update();
+		CHECK_EQUAL(1, (int)events.size());
+		CHECK_EQUAL(CONTACT_END, events[0].type);
+		CHECK_EQUAL(0, bp.getPairCount());
+
+		CHECK_THROW(bp.move(a, Rectangle::Empty), std::out_of_range);
+		CHECK_THROW(bp.getBounds(a), std::out_of_range);
+		CHECK_EQUAL(Rectangle(5, 5, 10, 10), bp.getBounds(b));
+	}
+
+	TEST(MatchesBruteForce) {
+		Broadphase bp;
+		std::vector<Rectangle> rects;
+		srand(42);
+
+		for (int i = 0; i < 64; i++) {
+			rects.push_back(Rectangle(rand() % 200, rand() % 200, 1 + rand() % 30, 1 + rand() % 30));
+			bp.add(rects.back());
+		}
+
+		for (int frame = 0; frame < 50; frame++) {
+			for (int i = 0; i < (int)rects.size(); i++) {
+				rects[i].x += rand() % 11 - 5;
+				rects[i].y += rand() % 11 - 5;
+				bp.move(i, rects[i]);
+			}
+
+			bp.update();
+
+			int pairs = 0;
+
+			for (int i = 0; i < (int)rects.size(); i++) {
+				for (int j = i + 1; j < (int)rects.size(); j++) {
+					bool expected = rects[i].intersects(rects[j]);
+					pairs += expected ? 1 : 0;
+					CHECK_EQUAL(expected, bp.isOverlapping(i, j));
+				}
+			}
+
+			CHECK_EQUAL(pairs, bp.getPairCount());
+		}
+	}
+}
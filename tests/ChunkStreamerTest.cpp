@@ -0,0 +1,244 @@
+#include <unittest++/UnitTest++.h>
+
+#include "ChunkStreamer.h"
+#include "DirectoryChunkSource.h"
+#include <map>
+#include <cstdio>
+
+using namespace tiledl;
+
+/*
+ * Keeps chunks in memory, counting reads and writes
+ */
+class MemoryChunkSource : public ChunkSource
+{
+public:
+	MemoryChunkSource() : reads(0), writes(0)
+	{
+		this->lock = SDL_CreateMutex();
+	}
+
+	~MemoryChunkSource()
+	{
+		SDL_DestroyMutex(this->lock);
+	}
+
+	bool read(const Point& chunk, std::vector<TileChunk>& layers)
+	{
+		SDL_LockMutex(this->lock);
+		auto it = this->chunks.find(std::make_pair(chunk.x, chunk.y));
+		bool found = it != this->chunks.end();
+		this->reads++;
+
+		if (found) {
+			layers = it->second;
+		}
+
+		SDL_UnlockMutex(this->lock);
+		return found;
+	}
+
+	bool write(const Point& chunk, const std::vector<TileChunk>& layers)
+	{
+		SDL_LockMutex(this->lock);
+		this->chunks[std::make_pair(chunk.x, chunk.y)] = layers;
+		this->writes++;
+		SDL_UnlockMutex(this->lock);
+		return true;
+	}
+
+	std::map<std::pair<int, int>, std::vector<TileChunk>> chunks;
+	int reads, writes;
+	SDL_mutex* lock;
+};
+
+/*
+ * Reads like MemoryChunkSource but refuses every write
+ */
+class ReadOnlyChunkSource : public MemoryChunkSource
+{
+public:
+	bool write(const Point&, const std::vector<TileChunk>&)
+	{
+		SDL_LockMutex(this->lock);
+		this->writes++;
+		SDL_UnlockMutex(this->lock);
+		return false;
+	}
+};
+
+/*
+ * Updates until nothing is pending, giving up after a second
+ */
+static bool settle(ChunkStreamer& streamer, const Point& centre)
+{
+	Uint32 start = SDL_GetTicks();
+
+	do {
+		streamer.update(centre);
+
+		if (streamer.getPendingCount() == 0) {
+			return true;
+		}
+
+		SDL_Delay(1);
+	} while (SDL_GetTicks() - start < 1000);
+
+	return false;
+}
+
+SUITE(ChunkStreamerTests)
+{
+	TEST(ToChunk) {
+		CHECK_EQUAL(Point(0, 0), ChunkStreamer::toChunk(0, 31));
+		CHECK_EQUAL(Point(1, 0), ChunkStreamer::toChunk(32, 0));
+		CHECK_EQUAL(Point(-1, -1), ChunkStreamer::toChunk(-1, -32));
+		CHECK_EQUAL(Point(-2, 0), ChunkStreamer::toChunk(-33, 0));
+	}
+
+	TEST(Radii) {
+		MemoryChunkSource source;
+		ChunkStreamer streamer(source, 1);
+
+		streamer.setRadii(1, 2);
+		CHECK_EQUAL(1, streamer.getLoadRadius());
+		CHECK_EQUAL(2, streamer.getKeepRadius());
+		CHECK_THROW(streamer.setRadii(2, 1), std::invalid_argument);
+		CHECK_THROW(ChunkStreamer(source, 0), std::invalid_argument);
+	}
+
+	TEST(LoadAndUnload) {
+		MemoryChunkSource source;
+		ChunkStreamer streamer(source, 2);
+		streamer.setRadii(1, 2);
+
+		CHECK_EQUAL(true, settle(streamer, Point(0, 0)));
+		CHECK_EQUAL(9, streamer.getLoadedCount());
+		CHECK_EQUAL(true, streamer.isLoaded(Point(-1, 1)));
+		CHECK_EQUAL(false, streamer.isLoaded(Point(2, 0)));
+		CHECK(streamer.getChunk(Point(1, 1)) != nullptr);
+		CHECK_EQUAL(2, (int)streamer.getChunk(Point(1, 1))->size());
+
+		// Still within the keep radius, nothing dropped
+		CHECK_EQUAL(true, settle(streamer, Point(1, 0)));
+		CHECK_EQUAL(12, streamer.getLoadedCount());
+
+		CHECK_EQUAL(true, settle(streamer, Point(4, 0)));
+		CHECK_EQUAL(false, streamer.isLoaded(Point(-1, 0)));
+		CHECK_EQUAL(true, streamer.isLoaded(Point(2, 0)));
+		CHECK_EQUAL(true, streamer.isLoaded(Point(5, 1)));
+		CHECK_EQUAL(0, source.writes);
+	}
+
+	TEST(WriteBack) {
+		MemoryChunkSource source;
+
+		{
+			ChunkStreamer streamer(source, 2);
+			streamer.setRadii(0, 0);
+
+			CHECK_EQUAL(true, settle(streamer, Point(0, 0)));
+			CHECK_EQUAL(false, streamer.set(0, 40, 0, 3));
+			CHECK_EQUAL(true, streamer.set(1, 5, 6, 7));
+			CHECK_EQUAL(7u, streamer.get(1, 5, 6));
+			CHECK_EQUAL(0u, streamer.get(0, 5, 6));
+			CHECK_THROW(streamer.set(2, 0, 0, 1), std::out_of_range);
+
+			// Moving away writes the chunk, moving back reads the change
+			CHECK_EQUAL(true, settle(streamer, Point(3, 0)));
+			CHECK_EQUAL(false, streamer.isLoaded(Point(0, 0)));
+			CHECK_EQUAL(true, settle(streamer, Point(0, 0)));
+			CHECK_EQUAL(1, source.writes);
+			CHECK_EQUAL(7u, streamer.get(1, 5, 6));
+
+			streamer.set(0, -1, -1, 9);
+			CHECK_EQUAL(false, streamer.isLoaded(Point(-1, -1)));
+			streamer.set(0, 31, 31, 9);
+			streamer.flush();
+			CHECK_EQUAL(2, source.writes);
+			CHECK_EQUAL(9u, source.chunks[std::make_pair(0, 0)][0].get(31, 31));
+
+			streamer.set(0, 30, 31, 8);
+		}
+
+		// The destructor writes what is left
+		CHECK_EQUAL(3, source.writes);
+		CHECK_EQUAL(8u, source.chunks[std::make_pair(0, 0)][0].get(30, 31));
+	}
+
+	TEST(Backlog) {
+		MemoryChunkSource source;
+		ChunkStreamer streamer(source, 1);
+
+		// More chunks than fit in the request queue at once
+		streamer.setRadii(10, 10);
+		CHECK_EQUAL(true, settle(streamer, Point(0, 0)));
+		CHECK_EQUAL(21 * 21, streamer.getLoadedCount());
+	}
+
+	TEST(FlushWithFullResults) {
+		MemoryChunkSource source;
+
+		{
+			// More loads finish than fit in the results before anything is received
+			ChunkStreamer streamer(source, 1);
+			streamer.setRadii(9, 9);
+			streamer.update(Point(0, 0));
+			SDL_Delay(200);
+
+			streamer.flush();
+			CHECK_EQUAL(19 * 19, streamer.getLoadedCount());
+			CHECK_EQUAL(0, streamer.getPendingCount());
+		}
+
+		{
+			ChunkStreamer streamer(source, 1);
+			streamer.setRadii(9, 9);
+			streamer.update(Point(0, 0));
+			SDL_Delay(200);
+		}
+
+		CHECK_EQUAL(0, source.writes);
+	}
+
+	TEST(FailedWriteKeepsChanges) {
+		ReadOnlyChunkSource source;
+		ChunkStreamer streamer(source, 1);
+		streamer.setRadii(0, 1);
+
+		CHECK_EQUAL(true, settle(streamer, Point(0, 0)));
+		streamer.set(0, 2, 3, 5);
+		streamer.flush();
+		CHECK_EQUAL(1, source.writes);
+
+		// Still modified, so flushing tries again
+		streamer.flush();
+		CHECK_EQUAL(2, source.writes);
+
+		// Refused chunks stay loaded after moving away, until a flush writes them
+		CHECK_EQUAL(true, settle(streamer, Point(3, 0)));
+		CHECK_EQUAL(true, streamer.isLoaded(Point(0, 0)));
+		CHECK_EQUAL(5u, streamer.get(0, 2, 3));
+		CHECK_EQUAL(2, source.writes);
+	}
+
+	TEST(DirectorySource) {
+		char* path = SDL_GetPrefPath("tiledl", "tests");
+		DirectoryChunkSource source(path);
+		SDL_free(path);
+
+		std::vector<TileChunk> layers(2), loaded;
+		layers[0].fill(4);
+		layers[1].set(3, 4, 70000);
+
+		CHECK_EQUAL(true, source.write(Point(-2, 5), layers));
+		CHECK_EQUAL(true, source.read(Point(-2, 5), loaded));
+		CHECK_EQUAL(2, (int)loaded.size());
+		CHECK_EQUAL(4u, loaded[0].get(31, 31));
+		CHECK_EQUAL(70000u, loaded[1].get(3, 4));
+		CHECK_EQUAL(0u, loaded[1].get(4, 4));
+		CHECK_EQUAL(false, source.read(Point(1000, 1000), loaded));
+
+		std::remove(source.getPath(Point(-2, 5)).c_str());
+	}
+}
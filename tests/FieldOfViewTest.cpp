@@ -0,0 +1,138 @@
+#include <unittest++/UnitTest++.h>
+
+#include "FieldOfView.h"
+#include <cstdlib>
+
+using namespace tiledl;
+
+SUITE(FieldOfViewTests)
+{
+	TEST(OpenRoom) {
+		TileGrid grid(21, 21, 16, 16);
+		FieldOfView fov(grid);
+		VisibilityMap visible(21, 21);
+
+		fov.compute(Point(10, 10), 3, visible);
+
+		CHECK_EQUAL(true, visible.isVisible(10, 10));
+		CHECK_EQUAL(true, visible.isVisible(13, 10));
+		CHECK_EQUAL(true, visible.isVisible(12, 12));
+		CHECK_EQUAL(false, visible.isVisible(14, 10));
+		CHECK_EQUAL(false, visible.isVisible(13, 13));
+
+		// Every tile within the circle and nothing else
+		int count = 0;
+
+		for (int y = -3; y <= 3; y++) {
+			for (int x = -3; x <= 3; x++) {
+				count += (x * x + y * y <= 12) ? 1 : 0;
+			}
+		}
+
+		CHECK_EQUAL(count, visible.count());
+	}
+
+	TEST(WallHides) {
+		TileGrid grid(11, 11, 16, 16);
+		FieldOfView fov(grid);
+		VisibilityMap visible(11, 11);
+
+		for (int y = 0; y < 11; y++) {
+			grid.setOpaque(6, y, true);
+		}
+
+		fov.compute(Point(3, 5), 10, visible);
+
+		CHECK_EQUAL(true, visible.isVisible(6, 5));
+		CHECK_EQUAL(false, visible.isVisible(7, 5));
+		CHECK_EQUAL(true, visible.isVisible(0, 0));
+	}
+
+	TEST(Pillar) {
+		TileGrid grid(11, 11, 16, 16);
+		FieldOfView fov(grid);
+		VisibilityMap visible(11, 11);
+
+		grid.setOpaque(5, 3, true);
+		fov.compute(Point(5, 5), 10, visible);
+
+		CHECK_EQUAL(true, visible.isVisible(5, 3));
+		CHECK_EQUAL(false, visible.isVisible(5, 2));
+		CHECK_EQUAL(false, visible.isVisible(5, 0));
+		CHECK_EQUAL(true, visible.isVisible(4, 2));
+	}
+
+	TEST(Symmetric) {
+		TileGrid grid(40, 40, 16, 16);
+		FieldOfView fov(grid);
+		VisibilityMap a(40, 40), b(40, 40);
+		srand(97531);
+
+		for (int i = 0; i < 300; i++) {
+			grid.setOpaque(rand() % 40, rand() % 40, true);
+		}
+
+		for (int i = 0; i < 300; i++) {
+			Point p(rand() % 40, rand() % 40);
+			Point q(rand() % 40, rand() % 40);
+
+			if (grid.isOpaque(p.x, p.y) || grid.isOpaque(q.x, q.y)) {
+				continue;
+			}
+
+			a.clear();
+			b.clear();
+			fov.compute(p, 12, a);
+			fov.compute(q, 12, b);
+
+			CHECK_EQUAL(a.isVisible(q.x, q.y), b.isVisible(p.x, p.y));
+		}
+	}
+
+	TEST(Team) {
+		TileGrid grid(100, 70, 16, 16);
+		srand(8642);
+
+		for (int i = 0; i < 600; i++) {
+			grid.setOpaque(rand() % 100, rand() % 70, true);
+		}
+
+		std::vector<Observer> observers;
+
+		for (int i = 0; i < 20; i++) {
+			Observer observer = { Point(rand() % 100, rand() % 70), 4 + rand() % 8 };
+			observers.push_back(observer);
+		}
+
+		JobSystem jobs;
+		jobs.start(3);
+		FieldOfView fov(grid);
+		VisibilityMap team, expected(100, 70);
+
+		fov.setJobSystem(&jobs);
+		CHECK_EQUAL(Rectangle(0, 0, 100, 70), fov.compute(observers, team));
+
+		for (auto& observer : observers) {
+			fov.compute(observer.position, observer.radius, expected);
+		}
+
+		CHECK_EQUAL(0, team.diff(expected).w);
+		CHECK_EQUAL(0, fov.compute(observers, team).w);
+
+		// Only the area around a moved observer changes
+		observers[0].position = Point(50, 35);
+		observers[0].radius = 2;
+		grid.setOpaque(50, 35, false);
+
+		Rectangle dirty = fov.compute(observers, team);
+		CHECK(dirty.w > 0);
+
+		expected.clear();
+
+		for (auto& observer : observers) {
+			fov.compute(observer.position, observer.radius, expected);
+		}
+
+		CHECK_EQUAL(0, team.diff(expected).w);
+	}
+}
@@ -0,0 +1,55 @@
+#include <unittest++/UnitTest++.h>
+
+#include "FlowFieldCache.h"
+#include <stdexcept>
+
+using namespace tiledl;
+
+SUITE(FlowFieldCacheTests)
+{
+	TEST(Reuse) {
+		TileGrid grid(16, 16, 16, 16);
+		FlowFieldCache cache(grid, 4);
+
+		const FlowField& field = cache.get(Point(1, 1));
+		CHECK_EQUAL(10u, field.getCost(2, 1));
+		cache.get(Point(1, 1));
+
+		CHECK_EQUAL(1, cache.getSize());
+		CHECK_EQUAL(1, cache.getComputeCount());
+	}
+
+	TEST(InvalidatedByGrid) {
+		TileGrid grid(16, 16, 16, 16);
+		FlowFieldCache cache(grid, 4);
+
+		cache.get(Point(0, 0));
+		grid.setSolid(1, 0, true);
+		const FlowField& field = cache.get(Point(0, 0));
+
+		CHECK_EQUAL(2, cache.getComputeCount());
+		CHECK_EQUAL(FlowField::INFINITE_COST, field.getCost(1, 0));
+	}
+
+	TEST(LeastRecentlyUsed) {
+		TileGrid grid(16, 16, 16, 16);
+		FlowFieldCache cache(grid, 2);
+
+		cache.get(Point(0, 0));
+		cache.get(Point(1, 0));
+		cache.get(Point(0, 0));
+		cache.get(Point(2, 0)); // drops (1, 0)
+
+		CHECK_EQUAL(2, cache.getSize());
+		CHECK_EQUAL(3, cache.getComputeCount());
+
+		cache.get(Point(0, 0));
+		CHECK_EQUAL(3, cache.getComputeCount());
+		cache.get(Point(1, 0));
+		CHECK_EQUAL(4, cache.getComputeCount());
+
+		cache.invalidate();
+		CHECK_EQUAL(0, cache.getSize());
+		CHECK_THROW(FlowFieldCache(grid, 0), std::invalid_argument);
+	}
+}
@@ -0,0 +1,141 @@
+#include <unittest++/UnitTest++.h>
+
+#include "FlowField.h"
+#include "Pathfinder.h"
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace tiledl;
+
+/*
+ * Follows the directions from a tile and returns the cost of the walk,
+ * or INFINITE_COST if it does not end at a goal
+ */
+static Uint32 follow(const FlowField& field, Point tile)
+{
+	Uint32 cost = 0;
+
+	for (int i = 0; i < 100000; i++) {
+		Point step = field.getDirection(tile.x, tile.y);
+
+		if (step == Point(0, 0)) {
+			return (field.getCost(tile.x, tile.y) == 0) ? cost : FlowField::INFINITE_COST;
+		}
+
+		cost += Pathfinder::distance(tile, tile + step);
+		tile = tile + step;
+	}
+
+	return FlowField::INFINITE_COST;
+}
+
+SUITE(FlowFieldTests)
+{
+	TEST(OpenGrid) {
+		TileGrid grid(10, 10, 16, 16);
+		FlowField field(grid, 4);
+
+		CHECK_EQUAL(false, field.isCurrent());
+		field.compute(Point(0, 0));
+		CHECK_EQUAL(true, field.isCurrent());
+
+		CHECK_EQUAL(0u, field.getCost(0, 0));
+		CHECK_EQUAL(90u, field.getCost(9, 0));
+		CHECK_EQUAL(126u, field.getCost(9, 9));
+		CHECK_EQUAL(Point(-1, -1), field.getDirection(9, 9));
+		CHECK_EQUAL(Point(0, 0), field.getDirection(0, 0));
+		CHECK_EQUAL(FlowField::INFINITE_COST, field.getCost(-1, 0));
+
+		grid.setSolid(5, 5, true);
+		CHECK_EQUAL(false, field.isCurrent());
+	}
+
+	TEST(Unreachable) {
+		TileGrid grid(10, 10, 16, 16);
+		FlowField field(grid, 4);
+
+		for (int y = 0; y < 10; y++) {
+			grid.setSolid(5, y, true);
+		}
+
+		field.compute(Point(0, 0));
+		CHECK_EQUAL(FlowField::INFINITE_COST, field.getCost(9, 9));
+		CHECK_EQUAL(FlowField::INFINITE_COST, field.getCost(5, 5));
+		CHECK_EQUAL(Point(0, 0), field.getDirection(9, 9));
+	}
+
+	TEST(NearestGoal) {
+		TileGrid grid(20, 1, 16, 16);
+		FlowField field(grid, 8);
+		std::vector<Point> goals;
+
+		goals.push_back(Point(0, 0));
+		goals.push_back(Point(19, 0));
+		field.compute(goals);
+
+		CHECK_EQUAL(40u, field.getCost(4, 0));
+		CHECK_EQUAL(Point(-1, 0), field.getDirection(4, 0));
+		CHECK_EQUAL(40u, field.getCost(15, 0));
+		CHECK_EQUAL(Point(1, 0), field.getDirection(15, 0));
+	}
+
+	TEST(MatchesPathfinder) {
+		TileGrid grid(80, 60, 16, 16);
+		srand(2468);
+
+		for (int i = 0; i < 1200; i++) {
+			grid.setSolid(rand() % 80, rand() % 60, true);
+		}
+
+		Point goal(40, 30);
+		grid.setSolid(goal.x, goal.y, false);
+
+		JobSystem jobs;
+		jobs.start(3);
+		FlowField serial(grid, 8);
+		FlowField parallel(grid, 16);
+		parallel.setJobSystem(&jobs);
+
+		serial.compute(goal);
+		parallel.compute(goal);
+
+		Pathfinder finder(grid);
+		std::vector<Point> path;
+
+		for (int y = 0; y < 60; y++) {
+			for (int x = 0; x < 80; x++) {
+				CHECK_EQUAL(serial.getCost(x, y), parallel.getCost(x, y));
+			}
+		}
+
+		for (int i = 0; i < 150; i++) {
+			Point start(rand() % 80, rand() % 60);
+
+			if (finder.findPath(start, goal, path)) {
+				CHECK_EQUAL(finder.getPathCost(), serial.getCost(start.x, start.y));
+				CHECK_EQUAL(finder.getPathCost(), follow(parallel, start));
+			} else {
+				CHECK_EQUAL(FlowField::INFINITE_COST, serial.getCost(start.x, start.y));
+			}
+		}
+	}
+
+	TEST(PixelDirection) {
+		TileGrid grid(4, 4, 16, 16);
+		FlowField field(grid);
+
+		field.compute(Point(3, 0));
+		Vector direction = field.getDirection(Vector(8.0, 8.0));
+		CHECK_CLOSE(1.0, direction.x, 1e-9);
+		CHECK_CLOSE(0.0, direction.y, 1e-9);
+
+		direction = field.getDirection(Vector(8.0, 56.0));
+		CHECK_CLOSE(std::sqrt(0.5), direction.x, 1e-9);
+		CHECK_CLOSE(-std::sqrt(0.5), direction.y, 1e-9);
+	}
+
+	TEST(InvalidSectorSize) {
+		TileGrid grid(4, 4, 16, 16);
+		CHECK_THROW(FlowField(grid, 0), std::invalid_argument);
+	}
+}
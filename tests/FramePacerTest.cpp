@@ -0,0 +1,68 @@
+#include <unittest++/UnitTest++.h>
+#include <SDL2/SDL.h>
+#include "FramePacer.h"
+
+using namespace tiledl;
+
+SUITE(FramePacerTests)
+{
+	TEST(Uncapped)
+	{
+		FramePacer pacer;
+		CHECK_EQUAL(0, pacer.getTargetFps());
+
+		const Uint64 start = SDL_GetPerformanceCounter();
+
+		for (int i = 0; i < 100; i++) {
+			pacer.wait();
+		}
+
+		const double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+		CHECK(seconds < 0.1);
+		CHECK_EQUAL(99u, pacer.getFrameCount());
+		CHECK_EQUAL(0u, pacer.getMissedCount());
+	}
+
+	TEST(HoldsTarget)
+	{
+		FramePacer pacer;
+		pacer.setTargetFps(100);
+		CHECK_EQUAL(100, pacer.getTargetFps());
+
+		const Uint64 start = SDL_GetPerformanceCounter();
+		pacer.wait();
+
+		for (int i = 0; i < 20; i++) {
+			pacer.wait();
+		}
+
+		// 20 frames of at least 10ms, a busy machine may only make them longer
+		const double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+		CHECK(seconds >= 0.199);
+		CHECK(pacer.getFrameTimeMean() >= 9.9);
+		CHECK(pacer.getFrameTimeVariance() >= 0);
+		CHECK(pacer.getSpinMargin() > 0);
+	}
+
+	TEST(MissedFramesResync)
+	{
+		FramePacer pacer;
+		pacer.setTargetFps(100);
+		pacer.wait();
+
+		// A long frame is missed once, the frame after it still gets a full interval
+		SDL_Delay(35);
+		pacer.wait();
+		CHECK_EQUAL(1u, pacer.getMissedCount());
+
+		const Uint64 start = SDL_GetPerformanceCounter();
+		pacer.wait();
+		const double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+		CHECK(seconds >= 0.009);
+		CHECK_EQUAL(2u, pacer.getFrameCount());
+
+		pacer.resetStats();
+		CHECK_EQUAL(0u, pacer.getMissedCount());
+		CHECK_EQUAL(0.0, pacer.getFrameTimeMean());
+	}
+}
@@ -0,0 +1,112 @@
+#include <unittest++/UnitTest++.h>
+#include <SDL2/SDL.h>
+#include <stdexcept>
+#include "FrameStats.h"
+
+using namespace tiledl;
+
+namespace
+{
+	FrameSample makeSample(float frameTime, Uint32 drawCalls)
+	{
+		FrameSample sample = FrameSample();
+		sample.frameTime = frameTime;
+		sample.updateTime = frameTime / 2;
+		sample.renderTime = frameTime / 4;
+		sample.drawCalls = drawCalls;
+		return sample;
+	}
+}
+
+SUITE(FrameStatsTests)
+{
+	TEST(Empty) {
+		FrameStats stats(4);
+		CHECK_EQUAL(0, stats.getCount());
+		CHECK_EQUAL(4, stats.getCapacity());
+		CHECK_EQUAL(0.0f, stats.getAverage().frameTime);
+		CHECK_EQUAL(0.0f, stats.getMax().frameTime);
+		CHECK_THROW(stats.getSample(0), std::out_of_range);
+		CHECK_THROW(FrameStats(0), std::invalid_argument);
+	}
+
+	TEST(RingWraps) {
+		FrameStats stats(4);
+
+		for (int i = 1; i <= 6; i++) {
+			stats.record(makeSample((float)i, i));
+		}
+
+		// Only the last 4 are kept, newest first
+		CHECK_EQUAL(4, stats.getCount());
+		CHECK_EQUAL(6.0f, stats.getSample(0).frameTime);
+		CHECK_EQUAL(3.0f, stats.getSample(3).frameTime);
+		CHECK_THROW(stats.getSample(4), std::out_of_range);
+
+		CHECK_CLOSE(4.5f, stats.getAverage().frameTime, 0.001f);
+		CHECK_EQUAL(5u, stats.getAverage().drawCalls);
+		CHECK_EQUAL(6.0f, stats.getMax().frameTime);
+		CHECK_EQUAL(3.0f, stats.getMax().updateTime);
+		CHECK_EQUAL(6u, stats.getMax().drawCalls);
+
+		stats.clear();
+		CHECK_EQUAL(0, stats.getCount());
+	}
+
+	TEST(Spikes) {
+		FrameStats stats;
+
+		for (int i = 0; i < 100; i++) {
+			stats.record(makeSample((i % 25 == 0) ? 50.0f : 16.0f, 0));
+		}
+
+		CHECK_EQUAL(4, stats.getSpikeCount(20.0f));
+		CHECK_EQUAL(0, stats.getSpikeCount(50.0f));
+	}
+
+	TEST(Overlay) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 40, 20, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			Renderer renderer;
+			renderer.initSW(surf);
+
+			FrameStats stats;
+			stats.setGraphScale(20.0f);
+			CHECK_THROW(stats.setGraphScale(0), std::invalid_argument);
+
+			// Nothing recorded still draws the background
+			stats.draw(renderer, Rectangle(0, 0, 40, 20));
+			CHECK_EQUAL(SDL_MapRGBA(surf->format, 0, 0, 0, 160), ((Uint32*)surf->pixels)[0]);
+
+			for (int i = 0; i < 60; i++) {
+				stats.record(makeSample(10.0f, 0));
+			}
+
+			renderer.setDrawColor(0, 0, 0, 0);
+			renderer.clear();
+			stats.draw(renderer, Rectangle(0, 0, 40, 20));
+
+			// 10ms of 20ms over 19 pixels, a flat white line on row 10
+			const Uint32 white = SDL_MapRGBA(surf->format, 255, 255, 255, 255);
+			CHECK_EQUAL(white, ((Uint32*)surf->pixels)[10 * 40 + 20]);
+			CHECK_EQUAL(SDL_MapRGBA(surf->format, 0, 0, 0, 160), ((Uint32*)surf->pixels)[20]);
+
+			// The background is blended over the frame, without changing the blend mode
+			renderer.setDrawColor(255, 255, 255, 255);
+			renderer.clear();
+			stats.draw(renderer, Rectangle(0, 0, 40, 20));
+			CHECK_EQUAL(SDL_MapRGBA(surf->format, 95, 95, 95, 255), ((Uint32*)surf->pixels)[0]);
+			CHECK_EQUAL(SDL_BLENDMODE_NONE, renderer.getBlendMode());
+
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+}
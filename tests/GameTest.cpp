@@ -1,9 +1,64 @@
 #include <unittest++/UnitTest++.h>
 #include <SDL2/SDL.h>
 #include "Game.h"
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <atomic>
 
 using namespace tiledl;
 
+namespace
+{
+	class EventGame : public Game
+	{
+	public:
+		void event(SDL_Event& event)
+		{
+			types.push_back(event.type);
+			times.push_back(eventTime);
+		}
+
+		void update()
+		{
+			updates++;
+			keysHeld += input.getSnapshot().keysDown.count();
+		}
+
+		const InputSnapshot& getInput() const
+		{
+			return input.getSnapshot();
+		}
+
+		std::vector<Uint32> types;
+		std::vector<Uint64> times;
+		int updates = 0;
+		size_t keysHeld = 0;
+	};
+
+	class HeadlessGame : public Game
+	{
+	public:
+		void render()
+		{
+			renderer.setDrawColor(0, 0, 255, 255);
+			renderer.fillRect(0, 0, 4, 4);
+		}
+
+		void update()
+		{
+			updates++;
+		}
+
+		void event(SDL_Event&)
+		{
+
+		}
+
+		std::atomic<int> updates{ 0 };
+	};
+}
+
 SUITE(GameTests)
 {
 	TEST(InitNoSDL) {
@@ -20,4 +75,150 @@ SUITE(GameTests)
 			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
 		}
 	}
+
+	TEST(EventQueue) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			EventGame gm;
+			SDL_Event event;
+			SDL_zero(event);
+			event.type = SDL_USEREVENT;
+
+			// Overflow the queue, the rest waits in SDL's queue
+			const int count = Game::EVENT_QUEUE_CAPACITY + 10;
+
+			for (int i = 0; i < count; i++) {
+				SDL_PushEvent(&event);
+			}
+
+			gm.pumpEvents();
+			CHECK_EQUAL(1u, gm.getEventOverflowCount());
+
+			gm.handleEvents();
+			CHECK_EQUAL(Game::EVENT_QUEUE_CAPACITY, (int)gm.types.size());
+
+			gm.pumpEvents();
+			gm.handleEvents();
+			CHECK_EQUAL(count, (int)gm.types.size());
+			CHECK_EQUAL(1u, gm.getEventOverflowCount());
+			CHECK_EQUAL((Uint32)SDL_USEREVENT, gm.types.back());
+			CHECK(gm.times.back() >= gm.times.front());
+			CHECK(gm.times.front() != 0);
+
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(MotionEvents) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			EventGame gm;
+			SDL_Event event;
+			SDL_zero(event);
+			event.type = SDL_MOUSEMOTION;
+			event.motion.x = 5;
+			event.motion.xrel = 2;
+			SDL_PushEvent(&event);
+			SDL_PushEvent(&event);
+
+			// Folded into the input and still handed to event()
+			gm.pumpEvents();
+			gm.handleEvents();
+			CHECK_EQUAL(2, (int)gm.types.size());
+			CHECK_EQUAL((Uint32)SDL_MOUSEMOTION, gm.types.back());
+			CHECK_EQUAL(2, gm.getInput().motionEvents);
+			CHECK_EQUAL(4, gm.getInput().motionX);
+
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(RecordReplay) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			char* base = SDL_GetPrefPath("tiledl", "tests");
+			const std::string path = std::string(base ? base : "") + "game.input";
+			SDL_free(base);
+
+			EventGame recorded;
+			CHECK(recorded.startRecording(path.c_str()));
+
+			SDL_Event event;
+			SDL_zero(event);
+			event.type = SDL_KEYDOWN;
+			event.key.keysym.scancode = 7;
+			SDL_PushEvent(&event);
+
+			// Three ticks, the key is held from the first
+			for (int tick = 0; tick < 3; tick++) {
+				recorded.pumpEvents();
+				recorded.handleEvents();
+			}
+
+			recorded.stopRecording();
+
+			EventGame replayed;
+			CHECK_EQUAL(3, replayed.replay(path.c_str()));
+			CHECK_EQUAL(3, replayed.updates);
+			CHECK_EQUAL(3u, replayed.keysHeld);
+			CHECK_EQUAL(1, (int)replayed.types.size());
+			CHECK_EQUAL(-1, replayed.replay("does/not/exist.input"));
+
+			std::remove(path.c_str());
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(Headless) {
+		if (SDL_Init(SDL_INIT_EVENTS) == 0) {
+			char* base = SDL_GetPrefPath("tiledl", "tests");
+			const std::string prefix = std::string(base ? base : "") + "headless_";
+			SDL_free(base);
+
+			HeadlessGame gm;
+			CHECK_EQUAL(0, gm.initHeadless(32, 16));
+			CHECK(gm.isHeadless());
+			CHECK(gm.getFrame() != nullptr);
+			CHECK_EQUAL(32, gm.getFrame()->getWidth());
+			CHECK_EQUAL(-1, gm.initHeadless(32, 16));
+
+			gm.setFrameLimit(6);
+			gm.setFrameDump(prefix, 3);
+			gm.start();
+			CHECK_EQUAL(6u, gm.getFrameCount());
+			CHECK_EQUAL(6, gm.getStats().getCount());
+			CHECK_EQUAL(2u, gm.getStats().getSample(0).drawCalls); // clear and fill
+			CHECK_EQUAL(2u, gm.getStats().getSample(0).stateChanges);
+
+			// Rendered into the frame surface
+			Surface* frame = gm.getFrame();
+			frame->lock();
+			Uint8 r, g, b, a;
+			SDL_GetRGBA(*(Uint32*)frame->getPixels(), frame->getFormat(), &r, &g, &b, &a);
+			frame->unlock();
+			CHECK_EQUAL(255, (int)b);
+			CHECK_EQUAL(0, (int)r);
+
+			for (int dumped = 3; dumped <= 6; dumped += 3) {
+				char name[32];
+				snprintf(name, sizeof(name), "frame_%06i.png", dumped);
+				const std::string path = prefix + name;
+				SDL_RWops* file = SDL_RWFromFile(path.c_str(), "rb");
+				CHECK(file != nullptr);
+
+				if (file != nullptr) {
+					SDL_RWclose(file);
+				}
+
+				std::remove(path.c_str());
+			}
+
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_EVENTS : %s", SDL_GetError());
+		}
+	}
 }
@@ -0,0 +1,199 @@
+#include <unittest++/UnitTest++.h>
+
+#include "HierarchicalPathfinder.h"
+#include "Pathfinder.h"
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace tiledl;
+
+static bool valid_path(const TileGrid& grid, const std::vector<Point>& path)
+{
+	for (size_t i = 0; i < path.size(); i++) {
+		if (grid.isSolid(path[i].x, path[i].y)) {
+			return false;
+		}
+
+		if (i == 0) {
+			continue;
+		}
+
+		Point step = path[i] - path[i - 1];
+
+		if (std::abs(step.x) > 1 || std::abs(step.y) > 1 || step == Point(0, 0)) {
+			return false;
+		}
+
+		if (step.x != 0 && step.y != 0 &&
+		    (grid.isSolid(path[i - 1].x + step.x, path[i - 1].y) || grid.isSolid(path[i - 1].x, path[i - 1].y + step.y))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static Uint32 path_cost(const std::vector<Point>& path)
+{
+	Uint32 cost = 0;
+
+	for (size_t i = 1; i < path.size(); i++) {
+		cost += Pathfinder::distance(path[i - 1], path[i]);
+	}
+
+	return cost;
+}
+
+SUITE(HierarchicalPathfinderTests)
+{
+	TEST(Construct) {
+		TileGrid grid(20, 12, 16, 16);
+		HierarchicalPathfinder finder(grid, 8);
+
+		CHECK_EQUAL(8, finder.getClusterSize());
+		CHECK_EQUAL(6, finder.getClusterCount());
+		CHECK_EQUAL(6, finder.getUpdatedClusterCount());
+		CHECK(finder.getNodeCount() > 0);
+
+		CHECK_THROW(HierarchicalPathfinder(grid, 2), std::invalid_argument);
+		CHECK_THROW(HierarchicalPathfinder(grid, 65), std::invalid_argument);
+	}
+
+	TEST(SameCluster) {
+		TileGrid grid(16, 16, 16, 16);
+		HierarchicalPathfinder finder(grid, 8);
+		std::vector<Point> path;
+
+		CHECK_EQUAL(true, finder.findPath(Point(1, 1), Point(1, 1), path));
+		CHECK_EQUAL(1, (int)path.size());
+		CHECK_EQUAL(0u, finder.getPathCost());
+
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(5, 0), path));
+		CHECK_EQUAL(6, (int)path.size());
+		CHECK_EQUAL(50u, finder.getPathCost());
+	}
+
+	TEST(AcrossClusters) {
+		TileGrid grid(32, 32, 16, 16);
+		HierarchicalPathfinder finder(grid, 8);
+		std::vector<Point> path;
+
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(31, 31), path));
+		CHECK_EQUAL(true, valid_path(grid, path));
+		CHECK_EQUAL(Point(0, 0), path.front());
+		CHECK_EQUAL(Point(31, 31), path.back());
+		CHECK_EQUAL(finder.getPathCost(), path_cost(path));
+	}
+
+	TEST(Blocked) {
+		TileGrid grid(16, 16, 16, 16);
+		HierarchicalPathfinder finder(grid, 8);
+		std::vector<Point> path;
+
+		for (int y = 0; y < 16; y++) {
+			grid.setSolid(10, y, true);
+		}
+
+		finder.update(Rectangle(10, 0, 1, 16));
+
+		CHECK_EQUAL(false, finder.findPath(Point(0, 0), Point(15, 15), path));
+		CHECK_EQUAL(0, (int)path.size());
+		CHECK_EQUAL(false, finder.findPath(Point(0, 0), Point(10, 5), path));
+		CHECK_EQUAL(false, finder.findPath(Point(0, 0), Point(-1, 0), path));
+	}
+
+	TEST(MatchesAStar) {
+		TileGrid grid(64, 64, 16, 16);
+		srand(4321);
+
+		for (int i = 0; i < 900; i++) {
+			grid.setSolid(rand() % 64, rand() % 64, true);
+		}
+
+		Pathfinder exact(grid);
+		HierarchicalPathfinder finder(grid, 16);
+		std::vector<Point> expected, path;
+		Uint64 totalExact = 0, totalHierarchical = 0;
+
+		for (int i = 0; i < 200; i++) {
+			Point start(rand() % 64, rand() % 64);
+			Point goal(rand() % 64, rand() % 64);
+
+			bool found = exact.findPath(start, goal, expected);
+			CHECK_EQUAL(found, finder.findPath(start, goal, path));
+
+			if (found) {
+				CHECK_EQUAL(true, valid_path(grid, path));
+				CHECK_EQUAL(start, path.front());
+				CHECK_EQUAL(goal, path.back());
+				CHECK(finder.getPathCost() >= exact.getPathCost());
+				CHECK(path_cost(path) <= finder.getPathCost());
+
+				totalExact += exact.getPathCost();
+				totalHierarchical += path_cost(path);
+			}
+		}
+
+		// Paths through entrances are near optimal, not optimal
+		CHECK(totalHierarchical * 10 <= totalExact * 12);
+	}
+
+	TEST(InteriorUpdate) {
+		TileGrid grid(32, 32, 16, 16);
+		HierarchicalPathfinder finder(grid, 8);
+
+		grid.setSolid(3, 3, true);
+		finder.update(Point(3, 3));
+		CHECK_EQUAL(1, finder.getUpdatedClusterCount());
+	}
+
+	TEST(BorderUpdate) {
+		TileGrid grid(32, 32, 16, 16);
+		HierarchicalPathfinder finder(grid, 8);
+
+		grid.setSolid(7, 3, true);
+		finder.update(Point(7, 3));
+		CHECK_EQUAL(2, finder.getUpdatedClusterCount());
+
+		// Corner tiles border two neighbours
+		grid.setSolid(7, 7, true);
+		finder.update(Point(7, 7));
+		CHECK_EQUAL(3, finder.getUpdatedClusterCount());
+	}
+
+	TEST(DoorToggle) {
+		TileGrid grid(16, 8, 16, 16);
+		HierarchicalPathfinder finder(grid, 8);
+		std::vector<Point> path;
+
+		// Wall across the cluster border with a single door
+		for (int y = 0; y < 8; y++) {
+			grid.setSolid(8, y, true);
+		}
+
+		grid.setSolid(8, 4, false);
+		finder.update(Rectangle(8, 0, 1, 8));
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(15, 0), path));
+		CHECK_EQUAL(true, valid_path(grid, path));
+
+		grid.setSolid(8, 4, true);
+		finder.update(Point(8, 4));
+		CHECK_EQUAL(false, finder.findPath(Point(0, 0), Point(15, 0), path));
+
+		grid.setSolid(8, 4, false);
+		finder.update(Point(8, 4));
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(15, 0), path));
+	}
+
+	TEST(GridResized) {
+		TileGrid grid(8, 8, 16, 16);
+		HierarchicalPathfinder finder(grid, 8);
+		std::vector<Point> path;
+
+		grid.resize(24, 24);
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(23, 23), path));
+		CHECK_EQUAL(true, valid_path(grid, path));
+		CHECK_EQUAL(Point(23, 23), path.back());
+		CHECK_EQUAL(9, finder.getClusterCount());
+	}
+}
@@ -0,0 +1,92 @@
+#include <unittest++/UnitTest++.h>
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "InputRecorder.h"
+
+using namespace tiledl;
+
+static std::string testPath(const char* name)
+{
+	char* base = SDL_GetPrefPath("tiledl", "tests");
+	std::string path = std::string(base ? base : "") + name;
+	SDL_free(base);
+	return path;
+}
+
+SUITE(InputRecorderTests)
+{
+	TEST(RoundTrip)
+	{
+		const std::string path = testPath("recorder.input");
+		const Uint64 frequency = SDL_GetPerformanceFrequency();
+
+		InputRecorder recorder;
+		CHECK(recorder.open(path.c_str()));
+
+		QueuedEvent key;
+		SDL_zero(key.event);
+		key.event.type = SDL_KEYDOWN;
+		key.event.key.keysym.scancode = 42;
+		key.time = 1000 * frequency;
+		CHECK(recorder.record(key));
+
+		QueuedEvent motion;
+		SDL_zero(motion.event);
+		motion.event.type = SDL_MOUSEMOTION;
+		motion.event.motion.x = 320;
+		motion.event.motion.yrel = -5;
+		motion.time = key.time + frequency / 100;
+		CHECK(recorder.record(motion));
+		CHECK(recorder.tick(key.time + frequency / 60));
+
+		// An empty tick, then events never closed by a tick
+		CHECK(recorder.tick(key.time + frequency / 30));
+		CHECK(recorder.record(key));
+
+		CHECK_EQUAL(3u, recorder.getEventCount());
+		CHECK_EQUAL(2u, recorder.getTickCount());
+		recorder.close();
+		CHECK(!recorder.record(key));
+
+		InputReplay replay;
+		CHECK(replay.open(path.c_str()));
+
+		std::vector<QueuedEvent> events;
+		CHECK(replay.readTick(events));
+		CHECK_EQUAL(2, (int)events.size());
+		CHECK_EQUAL((Uint32)SDL_KEYDOWN, events[0].event.type);
+		CHECK_EQUAL(42, (int)events[0].event.key.keysym.scancode);
+		CHECK_EQUAL(320, events[1].event.motion.x);
+		CHECK_EQUAL(-5, events[1].event.motion.yrel);
+
+		// The gap between events is kept, to the microsecond
+		const Uint64 gap = events[1].time - events[0].time;
+		CHECK(gap + frequency / 1000000 + 1 >= frequency / 100 && gap <= frequency / 100 + 1);
+
+		CHECK(replay.readTick(events));
+		CHECK_EQUAL(0, (int)events.size());
+		CHECK(!replay.readTick(events));
+		CHECK_EQUAL(0, (int)events.size());
+		CHECK_EQUAL(2u, replay.getTickCount());
+
+		std::remove(path.c_str());
+	}
+
+	TEST(RejectsOtherFiles)
+	{
+		const std::string path = testPath("recorder.bad");
+		SDL_RWops* file = SDL_RWFromFile(path.c_str(), "wb");
+		SDL_WriteLE32(file, 0x12345678);
+		SDL_WriteLE32(file, 0);
+		SDL_RWclose(file);
+
+		InputReplay replay;
+		CHECK(!replay.open(path.c_str()));
+		CHECK(!replay.isOpen());
+		CHECK(!replay.open("does/not/exist.input"));
+
+		std::remove(path.c_str());
+	}
+}
@@ -0,0 +1,162 @@
+#include <unittest++/UnitTest++.h>
+#include <SDL2/SDL.h>
+#include "InputState.h"
+
+using namespace tiledl;
+
+namespace
+{
+	SDL_Event keyEvent(Uint32 type, SDL_Scancode key, bool repeat)
+	{
+		SDL_Event event;
+		SDL_zero(event);
+		event.type = type;
+		event.key.keysym.scancode = key;
+		event.key.repeat = repeat;
+		return event;
+	}
+
+	SDL_Event motionEvent(int x, int y, int xrel, int yrel)
+	{
+		SDL_Event event;
+		SDL_zero(event);
+		event.type = SDL_MOUSEMOTION;
+		event.motion.x = x;
+		event.motion.y = y;
+		event.motion.xrel = xrel;
+		event.motion.yrel = yrel;
+		return event;
+	}
+
+	SDL_Event buttonEvent(Uint32 type, int button)
+	{
+		SDL_Event event;
+		SDL_zero(event);
+		event.type = type;
+		event.button.button = button;
+		return event;
+	}
+}
+
+SUITE(InputStateTests)
+{
+	TEST(KeyEdges)
+	{
+		InputState input;
+		const SDL_Scancode key = 4;
+
+		CHECK(input.handle(keyEvent(SDL_KEYDOWN, key, false)));
+		const InputSnapshot& first = input.publish();
+		CHECK(first.isKeyDown(key));
+		CHECK(first.isKeyPressed(key));
+		CHECK(!first.isKeyReleased(key));
+
+		// Held, repeats are not presses
+		input.handle(keyEvent(SDL_KEYDOWN, key, true));
+		input.publish();
+		CHECK(input.getSnapshot().isKeyDown(key));
+		CHECK(!input.getSnapshot().isKeyPressed(key));
+
+		input.handle(keyEvent(SDL_KEYUP, key, false));
+		input.publish();
+		CHECK(!input.getSnapshot().isKeyDown(key));
+		CHECK(input.getSnapshot().isKeyReleased(key));
+
+		// A tap within one tick is both edges
+		input.handle(keyEvent(SDL_KEYDOWN, key, false));
+		input.handle(keyEvent(SDL_KEYUP, key, false));
+		input.publish();
+		CHECK(!input.getSnapshot().isKeyDown(key));
+		CHECK(input.getSnapshot().isKeyPressed(key));
+		CHECK(input.getSnapshot().isKeyReleased(key));
+
+		input.publish();
+		CHECK(!input.getSnapshot().isKeyPressed(key));
+		CHECK(!input.getSnapshot().isKeyReleased(key));
+		CHECK(!input.getSnapshot().isKeyDown(SDL_NUM_SCANCODES));
+	}
+
+	TEST(SnapshotIsStable)
+	{
+		InputState input;
+		input.publish();
+		const InputSnapshot& snapshot = input.getSnapshot();
+		const Uint64 tick = snapshot.tick;
+
+		// Events for the next tick do not show until it is published
+		input.handle(keyEvent(SDL_KEYDOWN, 10, false));
+		input.handle(motionEvent(5, 5, 5, 5));
+		CHECK(!input.getSnapshot().isKeyDown(10));
+		CHECK_EQUAL(0, input.getSnapshot().motionEvents);
+
+		input.publish();
+		CHECK(input.getSnapshot().isKeyDown(10));
+		CHECK_EQUAL(tick + 1, input.getSnapshot().tick);
+	}
+
+	TEST(MotionCoalesces)
+	{
+		InputState input;
+
+		for (int i = 1; i <= 1000; i++) {
+			input.handle(motionEvent(i, i * 2, 1, 2));
+		}
+
+		const InputSnapshot& snapshot = input.publish();
+		CHECK_EQUAL(1000, snapshot.mouseX);
+		CHECK_EQUAL(2000, snapshot.mouseY);
+		CHECK_EQUAL(1000, snapshot.motionX);
+		CHECK_EQUAL(2000, snapshot.motionY);
+		CHECK_EQUAL(1000, snapshot.motionEvents);
+
+		// Position carries over, totals do not
+		input.publish();
+		CHECK_EQUAL(1000, input.getSnapshot().mouseX);
+		CHECK_EQUAL(0, input.getSnapshot().motionX);
+		CHECK_EQUAL(0, input.getSnapshot().motionEvents);
+	}
+
+	TEST(Buttons)
+	{
+		InputState input;
+		input.handle(buttonEvent(SDL_MOUSEBUTTONDOWN, SDL_BUTTON_LEFT));
+		input.publish();
+		CHECK(input.getSnapshot().isButtonDown(SDL_BUTTON_LEFT));
+		CHECK(input.getSnapshot().isButtonPressed(SDL_BUTTON_LEFT));
+		CHECK(!input.getSnapshot().isButtonDown(SDL_BUTTON_RIGHT));
+
+		SDL_Event wheel;
+		SDL_zero(wheel);
+		wheel.type = SDL_MOUSEWHEEL;
+		wheel.wheel.y = 1;
+		input.handle(wheel);
+		input.handle(wheel);
+		input.handle(buttonEvent(SDL_MOUSEBUTTONUP, SDL_BUTTON_LEFT));
+		input.publish();
+		CHECK(!input.getSnapshot().isButtonDown(SDL_BUTTON_LEFT));
+		CHECK(input.getSnapshot().isButtonReleased(SDL_BUTTON_LEFT));
+		CHECK_EQUAL(2, input.getSnapshot().wheelY);
+		CHECK(!input.getSnapshot().isButtonDown(0));
+	}
+
+	TEST(FocusLostReleases)
+	{
+		InputState input;
+		input.handle(keyEvent(SDL_KEYDOWN, 20, false));
+		input.publish();
+
+		SDL_Event focus;
+		SDL_zero(focus);
+		focus.type = SDL_WINDOWEVENT;
+		focus.window.event = SDL_WINDOWEVENT_FOCUS_LOST;
+		CHECK(!input.handle(focus));
+		input.publish();
+		CHECK(!input.getSnapshot().isKeyDown(20));
+		CHECK(input.getSnapshot().isKeyReleased(20));
+
+		SDL_Event user;
+		SDL_zero(user);
+		user.type = SDL_USEREVENT;
+		CHECK(!input.handle(user));
+	}
+}
@@ -0,0 +1,156 @@
+#include <unittest++/UnitTest++.h>
+
+#include "JobSystem.h"
+#include <atomic>
+#include <vector>
+
+using namespace tiledl;
+
+SUITE(JobSystemTests)
+{
+	TEST(NotStarted) {
+		JobSystem jobs;
+		JobCounter counter;
+		int ran = 0;
+
+		// Runs immediately on the calling thread
+		jobs.run([&]() { ran++; }, counter);
+		CHECK_EQUAL(1, ran);
+		CHECK(counter.isDone());
+		jobs.wait(counter);
+
+		std::vector<int> values(100, 0);
+		jobs.parallelFor(100, [&](int i) { values[i] = i; });
+		CHECK_EQUAL(99, values[99]);
+		CHECK_EQUAL(false, jobs.isRunning());
+	}
+
+	TEST(StartStop) {
+		JobSystem jobs;
+		CHECK_EQUAL(true, jobs.start(2));
+		CHECK_EQUAL(false, jobs.start(2));
+		CHECK_EQUAL(true, jobs.isRunning());
+		CHECK_EQUAL(2, jobs.getThreadCount());
+
+		jobs.stop();
+		CHECK_EQUAL(false, jobs.isRunning());
+		CHECK_EQUAL(0, jobs.getThreadCount());
+
+		// Restarts with the same object
+		CHECK_EQUAL(true, jobs.start(1));
+	}
+
+	TEST(ParallelFor) {
+		JobSystem jobs;
+		jobs.start(3);
+
+		const int count = 100000;
+		std::vector<int> values(count, 0);
+		jobs.parallelFor(count, [&](int i) { values[i] += i % 7; });
+
+		bool correct = true;
+
+		for (int i = 0; i < count; i++) {
+			correct = correct && values[i] == i % 7;
+		}
+
+		CHECK_EQUAL(true, correct);
+		CHECK(jobs.getExecutedCount() > 0);
+
+		// A grain of one index splits all the way down
+		std::atomic<int> sum(0);
+		jobs.parallelFor(64, [&](int i) { sum += i; }, 1);
+		CHECK_EQUAL(64 * 63 / 2, sum.load());
+	}
+
+	TEST(ChildJobs) {
+		JobSystem jobs;
+		jobs.start(2);
+
+		JobCounter counter;
+		std::atomic<int> leaves(0);
+
+		// Children share the parent's counter, so waiting on it waits for all of them
+		for (int i = 0; i < 8; i++) {
+			jobs.run([&]() {
+				for (int j = 0; j < 8; j++) {
+					jobs.run([&]() { leaves++; }, counter);
+				}
+			}, counter);
+		}
+
+		jobs.wait(counter);
+		CHECK_EQUAL(64, leaves.load());
+		CHECK(counter.isDone());
+	}
+
+	TEST(NestedWait) {
+		JobSystem jobs;
+		jobs.start(2);
+
+		std::atomic<int> total(0);
+
+		// Jobs waiting on their own jobs help instead of blocking a worker
+		jobs.parallelFor(16, [&](int) {
+			JobCounter inner;
+
+			for (int j = 0; j < 4; j++) {
+				jobs.run([&]() { total++; }, inner);
+			}
+
+			jobs.wait(inner);
+		}, 1);
+
+		CHECK_EQUAL(64, total.load());
+	}
+
+	TEST(ExitedThreadsReleaseDeques) {
+		struct Submitters {
+			JobSystem jobs;
+			std::atomic<int> arrived;
+			std::atomic<int> queued;
+		} submitters;
+
+		submitters.arrived = 0;
+		submitters.queued = 0;
+		submitters.jobs.start(0);
+
+		// As many threads as deques, alive at once so each claims its own
+		std::vector<SDL_Thread*> threads;
+
+		for (int i = 0; i < JobSystem::EXTERNAL_THREADS; i++) {
+			threads.push_back(SDL_CreateThread((SDL_ThreadFunction)([](void* ptr) -> int {
+				Submitters* submitters = (Submitters*)ptr;
+				JobCounter counter;
+				bool ran = false;
+
+				// Without workers a queued job only runs once it is waited on
+				submitters->jobs.run([&]() { ran = true; }, counter);
+				submitters->queued += ran ? 0 : 1;
+				submitters->jobs.wait(counter);
+
+				submitters->arrived++;
+
+				while (submitters->arrived.load() < JobSystem::EXTERNAL_THREADS) {
+					SDL_Delay(1);
+				}
+
+				return 0;
+			}), "Submitter", &submitters));
+		}
+
+		for (auto thread : threads) {
+			SDL_WaitThread(thread, NULL);
+		}
+
+		CHECK_EQUAL(JobSystem::EXTERNAL_THREADS, submitters.queued.load());
+
+		// The exited threads gave their deques back
+		JobCounter counter;
+		bool ran = false;
+		submitters.jobs.run([&]() { ran = true; }, counter);
+		CHECK_EQUAL(false, ran);
+		submitters.jobs.wait(counter);
+		CHECK_EQUAL(true, ran);
+	}
+}
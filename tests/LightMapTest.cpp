@@ -0,0 +1,189 @@
+#include <unittest++/UnitTest++.h>
+
+#include "LightMap.h"
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace tiledl;
+
+/*
+ * Checks every level matches a map lit from scratch with the same lights
+ */
+static bool matches_rebuild(const TileGrid& grid, const LightMap& map, const std::vector<std::pair<Point, Color>>& lights)
+{
+	LightMap fresh(grid, map.getFalloff());
+
+	for (auto& light : lights) {
+		fresh.addLight(light.first, light.second);
+	}
+
+	for (int y = 0; y < grid.getHeight(); y++) {
+		for (int x = 0; x < grid.getWidth(); x++) {
+			for (int c = 0; c < LIGHT_CHANNELS; c++) {
+				if (map.getLevel(x, y, (LightChannel)c) != fresh.getLevel(x, y, (LightChannel)c)) {
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+SUITE(LightMapTests)
+{
+	TEST(Spread) {
+		TileGrid grid(20, 20, 16, 16);
+		LightMap map(grid, 32);
+
+		map.addLight(Point(10, 10), Color(255, 128, 0));
+
+		CHECK_EQUAL(255, map.getLevel(10, 10, LIGHT_RED));
+		CHECK_EQUAL(223, map.getLevel(11, 10, LIGHT_RED));
+		CHECK_EQUAL(191, map.getLevel(11, 11, LIGHT_RED));
+		CHECK_EQUAL(96, map.getLevel(11, 10, LIGHT_GREEN));
+		CHECK_EQUAL(0, map.getLevel(11, 10, LIGHT_BLUE));
+		CHECK_EQUAL(0, map.getLevel(18, 10, LIGHT_RED));
+		CHECK_EQUAL(1, map.getLightCount());
+	}
+
+	TEST(OpaqueBlocks) {
+		TileGrid grid(20, 5, 16, 16);
+		LightMap map(grid, 16);
+
+		for (int y = 0; y < 5; y++) {
+			grid.setOpaque(10, y, true);
+		}
+
+		map.rebuild();
+		map.addLight(Point(8, 2), Color(255, 255, 255));
+
+		CHECK_EQUAL(0, map.getLevel(10, 2, LIGHT_RED));
+		CHECK_EQUAL(0, map.getLevel(11, 2, LIGHT_RED));
+
+		// Opening a door lets the light through
+		grid.setOpaque(10, 2, false);
+		map.update(Point(10, 2));
+		CHECK_EQUAL(223, map.getLevel(10, 2, LIGHT_RED));
+		CHECK_EQUAL(207, map.getLevel(11, 2, LIGHT_RED));
+
+		grid.setOpaque(10, 2, true);
+		map.update(Point(10, 2));
+		CHECK_EQUAL(0, map.getLevel(11, 2, LIGHT_RED));
+	}
+
+	TEST(Remove) {
+		TileGrid grid(20, 20, 16, 16);
+		LightMap map(grid, 16);
+
+		map.addLight(Point(5, 5), Color(200, 200, 200));
+		map.addLight(Point(9, 5), Color(100, 100, 100));
+		map.removeLight(Point(5, 5));
+
+		CHECK_EQUAL(100, map.getLevel(9, 5, LIGHT_RED));
+		CHECK_EQUAL(36, map.getLevel(5, 5, LIGHT_RED));
+		CHECK_EQUAL(1, map.getLightCount());
+
+		map.removeLight(Point(9, 5));
+		CHECK_EQUAL(0, map.getLevel(7, 5, LIGHT_RED));
+	}
+
+	TEST(MatchesRebuild) {
+		TileGrid grid(48, 48, 16, 16);
+		LightMap map(grid, 12);
+		std::vector<std::pair<Point, Color>> lights;
+		srand(1357);
+
+		for (int i = 0; i < 250; i++) {
+			grid.setOpaque(rand() % 48, rand() % 48, true);
+		}
+
+		map.rebuild();
+
+		for (int i = 0; i < 300; i++) {
+			int action = rand() % 3;
+			Point tile(rand() % 48, rand() % 48);
+
+			if (action == 0 || lights.empty()) {
+				Color color(rand() % 256, rand() % 256, rand() % 256);
+				map.addLight(tile, color);
+
+				for (size_t j = 0; j < lights.size(); j++) {
+					if (lights[j].first == tile) {
+						lights.erase(lights.begin() + j);
+						break;
+					}
+				}
+
+				lights.push_back(std::make_pair(tile, color));
+			} else if (action == 1) {
+				size_t j = rand() % lights.size();
+				map.removeLight(lights[j].first);
+				lights.erase(lights.begin() + j);
+			} else {
+				grid.setOpaque(tile.x, tile.y, !grid.isOpaque(tile.x, tile.y));
+				map.update(tile);
+			}
+
+			if (i % 25 == 0) {
+				CHECK_EQUAL(true, matches_rebuild(grid, map, lights));
+			}
+		}
+
+		CHECK_EQUAL(true, matches_rebuild(grid, map, lights));
+	}
+
+	TEST(DirtyRect) {
+		TileGrid grid(64, 64, 16, 16);
+		LightMap map(grid, 64);
+
+		map.clearDirty();
+		CHECK_EQUAL(0, map.getDirtyRect().w);
+
+		map.addLight(Point(30, 30), Color(255, 0, 0));
+		CHECK_EQUAL(Rectangle(27, 27, 7, 7), map.getDirtyRect());
+	}
+
+	TEST(Upload) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 4, 4, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			auto renderer = SDL_CreateSoftwareRenderer(surf);
+			TileGrid grid(4, 4, 16, 16);
+			LightMap map(grid, 128);
+			Texture texture;
+
+			map.addLight(Point(0, 0), Color(200, 100, 0));
+
+			CHECK_EQUAL(true, texture.create(renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, 4, 4));
+			CHECK_EQUAL(true, map.upload(texture, map.getDirtyRect(), Color(20, 20, 20)));
+			SDL_RenderCopy(renderer, texture.getHandle(), NULL, NULL);
+
+			Uint32* pixels = (Uint32*)surf->pixels;
+			CHECK_EQUAL(0xff1464c8u, pixels[0]);
+			CHECK_EQUAL(0xff141448u, pixels[1]);
+			CHECK_EQUAL(0xff141414u, pixels[3]);
+
+			texture.setBlendMode(SDL_BLENDMODE_MOD);
+			CHECK_EQUAL(SDL_BLENDMODE_MOD, texture.getBlendMode());
+
+			texture.destroy();
+			SDL_DestroyRenderer(renderer);
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(Invalid) {
+		TileGrid grid(4, 4, 16, 16);
+		LightMap map(grid);
+
+		CHECK_THROW(LightMap(grid, 0), std::invalid_argument);
+		CHECK_THROW(map.addLight(Point(4, 0), Color(1, 1, 1)), std::out_of_range);
+	}
+}
@@ -0,0 +1,241 @@
+#include <unittest++/UnitTest++.h>
+
+#include "MapFile.h"
+#include "ChunkStreamer.h"
+#include <cstdio>
+#include <string>
+
+using namespace tiledl;
+
+static std::string temp_path(const char* name)
+{
+	char* base = SDL_GetPrefPath("tiledl", "tests");
+	std::string path = std::string(base) + name;
+	SDL_free(base);
+	return path;
+}
+
+static void build_map(TileStorage& storage, std::map<std::string, std::string>& properties)
+{
+	storage.resize(100, 70, 2);
+	storage.fill(0, 3);
+
+	for (int i = 0; i < 100; i++) {
+		storage.set(0, i, i % 70, 1000 + i);
+		storage.set(1, 99 - i, i % 70, 7);
+	}
+
+	properties["name"] = "Test map";
+	properties["empty"] = "";
+}
+
+SUITE(MapFileTests)
+{
+	TEST(SaveAndOpen) {
+		std::string path = temp_path("save.map");
+		TileStorage storage, loaded;
+		std::map<std::string, std::string> properties;
+		build_map(storage, properties);
+
+		CHECK_EQUAL(true, MapFile::save(path.c_str(), storage, properties));
+
+		MapFile map;
+		CHECK_EQUAL(true, map.open(path.c_str()));
+		CHECK_EQUAL(true, map.isOpen());
+		CHECK_EQUAL((int)MapFile::VERSION, map.getVersion());
+		CHECK_EQUAL(100, map.getWidth());
+		CHECK_EQUAL(70, map.getHeight());
+		CHECK_EQUAL(2, map.getLayerCount());
+		CHECK_EQUAL(4, map.getChunksWide());
+		CHECK_EQUAL(3, map.getChunksHigh());
+		CHECK_EQUAL("Test map", map.getProperty("name"));
+		CHECK_EQUAL("", map.getProperty("missing"));
+		CHECK_EQUAL(2, (int)map.getProperties().size());
+
+		CHECK_EQUAL(true, map.load(loaded));
+		bool same = true;
+
+		for (int layer = 0; layer < 2; layer++) {
+			for (int y = 0; y < 70; y++) {
+				for (int x = 0; x < 100; x++) {
+					same = same && loaded.get(layer, x, y) == storage.get(layer, x, y);
+				}
+			}
+		}
+
+		CHECK_EQUAL(true, same);
+
+		map.close();
+		CHECK_EQUAL(false, map.isOpen());
+		std::remove(path.c_str());
+	}
+
+	TEST(ReadChunk) {
+		std::string path = temp_path("chunk.map");
+		TileStorage storage;
+		std::map<std::string, std::string> properties;
+		build_map(storage, properties);
+		MapFile::save(path.c_str(), storage, properties);
+
+		MapFile map;
+		std::vector<TileChunk> layers;
+		map.open(path.c_str());
+
+		CHECK_EQUAL(true, map.readChunk(3, 2, layers));
+		CHECK_EQUAL(2, (int)layers.size());
+		CHECK_EQUAL(storage.get(0, 96, 64), layers[0].get(0, 0));
+		CHECK_EQUAL(storage.get(1, 99, 69), layers[1].get(3, 5));
+		CHECK_EQUAL(false, map.readChunk(4, 0, layers));
+		CHECK_EQUAL(false, map.readChunk(0, -1, layers));
+
+		// Uniform chunks are stored without indices
+		storage.resize(64, 32, 1);
+		MapFile::save(path.c_str(), storage, properties);
+		map.open(path.c_str());
+		CHECK_EQUAL(true, map.readChunk(1, 0, layers));
+		CHECK_EQUAL(true, layers[0].isUniform());
+		CHECK_EQUAL(0, layers[0].getBits());
+
+		std::remove(path.c_str());
+	}
+
+	TEST(Invalid) {
+		std::string path = temp_path("invalid.map");
+		TileStorage storage(10, 10, 1);
+		MapFile map;
+
+		CHECK_EQUAL(false, map.open(temp_path("missing.map").c_str()));
+
+		MapFile::save(path.c_str(), storage, std::map<std::string, std::string>());
+		CHECK_EQUAL(true, map.open(path.c_str()));
+
+		// A newer version than this reader knows
+		SDL_RWops* file = SDL_RWFromFile(path.c_str(), "r+b");
+		SDL_RWseek(file, 4, RW_SEEK_SET);
+		SDL_WriteLE16(file, MapFile::VERSION + 1);
+		SDL_RWclose(file);
+		CHECK_EQUAL(false, map.open(path.c_str()));
+		CHECK_EQUAL(false, map.isOpen());
+
+		// Sizes that are negative or have more chunks than an int counts
+		MapFile::save(path.c_str(), storage, std::map<std::string, std::string>());
+		file = SDL_RWFromFile(path.c_str(), "r+b");
+		SDL_RWseek(file, 8, RW_SEEK_SET);
+		SDL_WriteLE32(file, 0xFFFFFFFF);
+		SDL_RWclose(file);
+		CHECK_EQUAL(false, map.open(path.c_str()));
+
+		file = SDL_RWFromFile(path.c_str(), "r+b");
+		SDL_RWseek(file, 8, RW_SEEK_SET);
+		SDL_WriteLE32(file, 0x7FFFFFFF);
+		SDL_WriteLE32(file, 0x7FFFFFFF);
+		SDL_RWclose(file);
+		CHECK_EQUAL(false, map.open(path.c_str()));
+
+		// A property longer than the file
+		std::map<std::string, std::string> properties;
+		properties["k"] = "v";
+		MapFile::save(path.c_str(), storage, properties);
+		file = SDL_RWFromFile(path.c_str(), "r+b");
+		SDL_RWseek(file, 24, RW_SEEK_SET);
+		SDL_RWseek(file, (Sint64)SDL_ReadLE64(file) + 3, RW_SEEK_SET);
+		SDL_WriteLE32(file, 0xFFFFFFF0);
+		SDL_RWclose(file);
+		CHECK_EQUAL(false, map.open(path.c_str()));
+
+		file = SDL_RWFromFile(path.c_str(), "wb");
+		SDL_WriteLE32(file, 0x12345678);
+		SDL_RWclose(file);
+		CHECK_EQUAL(false, map.open(path.c_str()));
+
+		std::remove(path.c_str());
+	}
+
+	TEST(ParseText) {
+		TileStorage storage;
+		std::map<std::string, std::string> properties;
+		std::string text =
+		    "# A small map\n"
+		    "size 3 2 2\n"
+		    "property name  Two words \n"
+		    "layer 1\n"
+		    "1 2 3\n"
+		    "\n"
+		    "4 5 70000\n";
+
+		CHECK_EQUAL(true, MapFile::parseText(text, storage, properties));
+		CHECK_EQUAL(3, storage.getWidth());
+		CHECK_EQUAL(2, storage.getLayerCount());
+		CHECK_EQUAL("Two words ", properties["name"]);
+		CHECK_EQUAL(0u, storage.get(0, 2, 1));
+		CHECK_EQUAL(2u, storage.get(1, 1, 0));
+		CHECK_EQUAL(70000u, storage.get(1, 2, 1));
+
+		CHECK_EQUAL(false, MapFile::parseText("layer 0\n", storage, properties));
+		CHECK_EQUAL(false, MapFile::parseText("size 2 2 1\nlayer 0\n1 2\n", storage, properties));
+		CHECK_EQUAL(false, MapFile::parseText("size 2 1 1\nlayer 0\n1\n", storage, properties));
+		CHECK_EQUAL(false, MapFile::parseText("size 2 1 1\ntiles\n", storage, properties));
+	}
+
+	TEST(Convert) {
+		std::string text = temp_path("convert.txt");
+		std::string path = temp_path("convert.map");
+		const char layout[] = "size 2 2 1\nproperty author me\nlayer 0\n5 6\n7 8\n";
+
+		SDL_RWops* file = SDL_RWFromFile(text.c_str(), "wb");
+		SDL_RWwrite(file, layout, sizeof(layout) - 1, 1);
+		SDL_RWclose(file);
+
+		CHECK_EQUAL(true, MapFile::convert(text.c_str(), path.c_str()));
+
+		MapFile map;
+		TileStorage storage;
+		CHECK_EQUAL(true, map.open(path.c_str()));
+		CHECK_EQUAL("me", map.getProperty("author"));
+		CHECK_EQUAL(true, map.load(storage));
+		CHECK_EQUAL(8u, storage.get(0, 1, 1));
+
+		std::remove(text.c_str());
+		std::remove(path.c_str());
+	}
+
+	TEST(Streaming) {
+		std::string path = temp_path("stream.map");
+		TileStorage storage;
+		std::map<std::string, std::string> properties;
+		build_map(storage, properties);
+		MapFile::save(path.c_str(), storage, properties);
+
+		MapFile map;
+		map.open(path.c_str());
+
+		ChunkStreamer streamer(map, 2);
+		streamer.setRadii(1, 1);
+		Uint32 start = SDL_GetTicks();
+
+		do {
+			streamer.update(Point(1, 1));
+			SDL_Delay(1);
+		} while (streamer.getPendingCount() > 0 && SDL_GetTicks() - start < 1000);
+
+		// Chunks outside of the map are left empty
+		CHECK_EQUAL(9, streamer.getLoadedCount());
+		CHECK_EQUAL(storage.get(0, 40, 40), streamer.get(0, 40, 40));
+		CHECK_EQUAL(1010u, streamer.get(0, 10, 10));
+		CHECK_EQUAL(0u, streamer.get(0, -10, 10));
+
+		// Map files cannot be written, so edited chunks are still dropped
+		CHECK_EQUAL(true, map.isReadOnly());
+		CHECK_EQUAL(true, streamer.set(0, 10, 10, 5));
+		start = SDL_GetTicks();
+
+		do {
+			streamer.update(Point(3, 2));
+			SDL_Delay(1);
+		} while (streamer.getPendingCount() > 0 && SDL_GetTicks() - start < 1000);
+
+		CHECK_EQUAL(false, streamer.isLoaded(Point(0, 0)));
+
+		std::remove(path.c_str());
+	}
+}
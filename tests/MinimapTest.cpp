@@ -0,0 +1,128 @@
+#include <unittest++/UnitTest++.h>
+
+#include "Minimap.h"
+#include <stdexcept>
+
+using namespace tiledl;
+
+static Uint32 pixel(Surface& surface, int x, int y)
+{
+	return ((Uint32*)((Uint8*)surface.getPixels() + y * surface.getPitch()))[x];
+}
+
+SUITE(MinimapTests)
+{
+	TEST(Levels) {
+		TileStorage tiles(5, 3, 1);
+		Minimap map(tiles, 0);
+
+		CHECK_EQUAL(4, map.getLevelCount());
+		CHECK_EQUAL(5, map.getLevel(0).getWidth());
+		CHECK_EQUAL(3, map.getLevel(1).getWidth());
+		CHECK_EQUAL(2, map.getLevel(1).getHeight());
+		CHECK_EQUAL(1, map.getLevel(3).getWidth());
+		CHECK_EQUAL(1, map.findLevel(4, 4));
+		CHECK_EQUAL(0, map.findLevel(5, 3));
+		CHECK_EQUAL(3, map.findLevel(0, 0));
+		CHECK_THROW(Minimap(tiles, 1), std::out_of_range);
+	}
+
+	TEST(Colours) {
+		TileStorage tiles(4, 4, 1);
+		Minimap map(tiles, 0);
+		SDL_PixelFormat* format = map.getLevel(0).getFormat();
+
+		tiles.fill(0, 1);
+		tiles.set(0, 0, 0, 2);
+		map.setColor(1, Color(200, 0, 0, 255));
+		map.setColor(2, Color(0, 100, 0, 255));
+		map.setDefaultColor(Color(1, 2, 3, 255));
+		map.rebuild();
+
+		CHECK_EQUAL(SDL_MapRGBA(format, 0, 100, 0, 255), pixel(map.getLevel(0), 0, 0));
+		CHECK_EQUAL(SDL_MapRGBA(format, 200, 0, 0, 255), pixel(map.getLevel(0), 3, 3));
+		CHECK_EQUAL(SDL_MapRGBA(format, 150, 25, 0, 255), pixel(map.getLevel(1), 0, 0));
+		CHECK_EQUAL(SDL_MapRGBA(format, 200, 0, 0, 255), pixel(map.getLevel(1), 1, 1));
+
+		Color colour = map.getColor(7);
+		CHECK_EQUAL(3, (int)colour.b);
+	}
+
+	TEST(DirtyUpdate) {
+		TileStorage tiles(64, 64, 1);
+		Minimap map(tiles, 0);
+		SDL_PixelFormat* format = map.getLevel(0).getFormat();
+		map.setColor(1, Color(255, 255, 255, 255));
+
+		// Not recoloured until marked dirty
+		tiles.set(0, 10, 20, 1);
+		tiles.set(0, 63, 63, 1);
+		map.update();
+		CHECK_EQUAL(SDL_MapRGBA(format, 0, 0, 0, 255), pixel(map.getLevel(0), 10, 20));
+
+		map.markDirty(10, 20);
+		map.markDirty(63, 63);
+		CHECK_EQUAL(Rectangle(10, 20, 54, 44), map.getDirtyRect());
+		map.update();
+		CHECK_EQUAL(0, map.getDirtyRect().w);
+		CHECK_EQUAL(SDL_MapRGBA(format, 255, 255, 255, 255), pixel(map.getLevel(0), 10, 20));
+		CHECK_EQUAL(SDL_MapRGBA(format, 64, 64, 64, 255), pixel(map.getLevel(1), 5, 10));
+
+		// Every level matches a full rebuild
+		tiles.set(0, 33, 1, 1);
+		map.markDirty(Rectangle(33, 1, 1, 1));
+		map.update();
+
+		Minimap rebuilt(tiles, 0);
+		rebuilt.setColor(1, Color(255, 255, 255, 255));
+		rebuilt.rebuild();
+		bool same = true;
+
+		for (int level = 0; level < map.getLevelCount(); level++) {
+			for (int y = 0; y < map.getLevel(level).getHeight(); y++) {
+				for (int x = 0; x < map.getLevel(level).getWidth(); x++) {
+					same = same && pixel(map.getLevel(level), x, y) == pixel(rebuilt.getLevel(level), x, y);
+				}
+			}
+		}
+
+		CHECK_EQUAL(true, same);
+		CHECK_EQUAL(7, map.getLevelCount());
+	}
+
+	TEST(Upload) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 16, 16, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			Renderer renderer;
+			Texture texture;
+			renderer.initSW(surf);
+
+			TileStorage tiles(32, 32, 1);
+			Minimap map(tiles, 0);
+			map.setColor(0, Color(0, 0, 255, 255));
+			map.rebuild();
+
+			int level = map.findLevel(16, 16);
+			CHECK_EQUAL(1, level);
+			CHECK_EQUAL(true, map.upload(renderer, texture, level));
+			CHECK_EQUAL(16, texture.getWidth());
+
+			renderer.copy(texture, NULL, NULL);
+			CHECK_EQUAL(SDL_MapRGBA(surf->format, 0, 0, 255, 255), ((Uint32*)surf->pixels)[17]);
+
+			// Nothing changed, nothing to upload
+			CHECK_EQUAL(true, map.upload(renderer, texture, level));
+
+			texture.destroy();
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+}
@@ -0,0 +1,163 @@
+#include <unittest++/UnitTest++.h>
+
+#include "Pathfinder.h"
+#include <cstdlib>
+
+using namespace tiledl;
+
+/*
+ * Checks every step of a path is to a passable neighbour and that no
+ * diagonal step cuts the corner of a solid tile
+ */
+static bool valid_path(const TileGrid& grid, const std::vector<Point>& path)
+{
+	for (size_t i = 0; i < path.size(); i++) {
+		if (grid.isSolid(path[i].x, path[i].y)) {
+			return false;
+		}
+
+		if (i == 0) {
+			continue;
+		}
+
+		Point step = path[i] - path[i - 1];
+
+		if (std::abs(step.x) > 1 || std::abs(step.y) > 1 || step == Point(0, 0)) {
+			return false;
+		}
+
+		if (step.x != 0 && step.y != 0 &&
+		    (grid.isSolid(path[i - 1].x + step.x, path[i - 1].y) || grid.isSolid(path[i - 1].x, path[i - 1].y + step.y))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static Uint32 path_cost(const std::vector<Point>& path)
+{
+	Uint32 cost = 0;
+
+	for (size_t i = 1; i < path.size(); i++) {
+		cost += Pathfinder::distance(path[i - 1], path[i]);
+	}
+
+	return cost;
+}
+
+SUITE(PathfinderTests)
+{
+	TEST(Distance) {
+		CHECK_EQUAL(0u, Pathfinder::distance(Point(1, 1), Point(1, 1)));
+		CHECK_EQUAL(30u, Pathfinder::distance(Point(0, 0), Point(3, 0)));
+		CHECK_EQUAL(42u, Pathfinder::distance(Point(0, 0), Point(-3, 3)));
+		CHECK_EQUAL(48u, Pathfinder::distance(Point(0, 0), Point(2, 4)));
+	}
+
+	TEST(StartIsGoal) {
+		TileGrid grid(4, 4, 16, 16);
+		Pathfinder finder(grid);
+		std::vector<Point> path;
+
+		CHECK_EQUAL(true, finder.findPath(Point(1, 1), Point(1, 1), path));
+		CHECK_EQUAL(1, (int)path.size());
+		CHECK_EQUAL(0u, finder.getPathCost());
+	}
+
+	TEST(Straight) {
+		TileGrid grid(10, 10, 16, 16);
+		Pathfinder finder(grid);
+		std::vector<Point> path;
+
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(9, 0), path));
+		CHECK_EQUAL(10, (int)path.size());
+		CHECK_EQUAL(Point(0, 0), path.front());
+		CHECK_EQUAL(Point(9, 0), path.back());
+		CHECK_EQUAL(90u, finder.getPathCost());
+
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(9, 0), path, PATH_JUMP_POINT));
+		CHECK_EQUAL(10, (int)path.size());
+		CHECK_EQUAL(90u, finder.getPathCost());
+	}
+
+	TEST(Blocked) {
+		TileGrid grid(10, 10, 16, 16);
+		Pathfinder finder(grid);
+		std::vector<Point> path;
+
+		for (int y = 0; y < 10; y++) {
+			grid.setSolid(5, y, true);
+		}
+
+		CHECK_EQUAL(false, finder.findPath(Point(0, 0), Point(9, 9), path));
+		CHECK_EQUAL(0, (int)path.size());
+		CHECK_EQUAL(false, finder.findPath(Point(0, 0), Point(9, 9), path, PATH_JUMP_POINT));
+		CHECK_EQUAL(false, finder.findPath(Point(0, 0), Point(5, 5), path));
+		CHECK_EQUAL(false, finder.findPath(Point(0, 0), Point(-1, 0), path));
+	}
+
+	TEST(NoCornerCutting) {
+		TileGrid grid(3, 3, 16, 16);
+		Pathfinder finder(grid);
+		std::vector<Point> path;
+
+		grid.setSolid(1, 0, true);
+
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(2, 0), path));
+		CHECK_EQUAL(true, valid_path(grid, path));
+		CHECK_EQUAL(4 * Pathfinder::STRAIGHT_COST, finder.getPathCost());
+	}
+
+	TEST(JumpPointMatchesAStar) {
+		TileGrid grid(48, 48, 16, 16);
+		Pathfinder finder(grid);
+		std::vector<Point> astar, jps;
+		srand(1234);
+
+		for (int i = 0; i < 700; i++) {
+			grid.setSolid(rand() % 48, rand() % 48, true);
+		}
+
+		for (int i = 0; i < 200; i++) {
+			Point start(rand() % 48, rand() % 48);
+			Point goal(rand() % 48, rand() % 48);
+
+			bool found = finder.findPath(start, goal, astar, PATH_ASTAR);
+			Uint32 cost = finder.getPathCost();
+
+			CHECK_EQUAL(found, finder.findPath(start, goal, jps, PATH_JUMP_POINT));
+
+			if (found) {
+				CHECK_EQUAL(cost, finder.getPathCost());
+				CHECK_EQUAL(cost, path_cost(jps));
+				CHECK_EQUAL(true, valid_path(grid, astar));
+				CHECK_EQUAL(true, valid_path(grid, jps));
+				CHECK_EQUAL(start, jps.front());
+				CHECK_EQUAL(goal, jps.back());
+			}
+		}
+	}
+
+	TEST(GridResized) {
+		TileGrid grid(4, 4, 16, 16);
+		Pathfinder finder(grid);
+		std::vector<Point> path;
+
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(3, 3), path));
+		grid.resize(8, 8);
+		CHECK_EQUAL(true, finder.findPath(Point(0, 0), Point(7, 7), path));
+		CHECK_EQUAL(8, (int)path.size());
+	}
+
+	TEST(ToPixels) {
+		TileGrid grid(4, 4, 16, 16);
+		Pathfinder finder(grid);
+		std::vector<Point> path;
+
+		finder.findPath(Point(0, 0), Point(1, 0), path);
+		finder.toPixels(path);
+		CHECK_EQUAL(Point(8, 8), path[0]);
+		CHECK_EQUAL(Point(24, 8), path[1]);
+	}
+}
@@ -92,6 +92,99 @@ SUITE(RendererTests)
 		}
 	}
 
+	TEST(Stats) {
+		auto renderer = Renderer();
+
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 16, 16, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			renderer.initSW(surf);
+			CHECK_EQUAL(0u, renderer.getStats().getDrawCalls());
+
+			Texture first, second;
+			first.create(renderer.getHandle(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, 2, 2);
+			second.create(renderer.getHandle(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, 2, 2);
+			SDL_Rect dst = { 0, 0, 2, 2 };
+
+			renderer.setDrawColor(255, 0, 0, 255);
+			renderer.drawPoint(SDL_Point{ 1, 2 });
+			renderer.drawLine(0, 0, 3, 1);
+			std::vector<SDL_Point> points = { { 0, 0 }, { 4, 0 }, { 4, 4 } };
+			renderer.drawLines(points);
+			renderer.drawRect(0, 0, 3, 3);
+			renderer.fillRect(0, 0, 4, 2);
+			renderer.copy(first, nullptr, &dst);
+			renderer.copy(first, nullptr, &dst);
+			renderer.copy(second, nullptr, &dst);
+			renderer.present();
+
+			const RenderStats& stats = renderer.getStats();
+			CHECK_EQUAL(1u, stats.points);
+			CHECK_EQUAL(2u, stats.lines);
+			CHECK_EQUAL(1u, stats.rects);
+			CHECK_EQUAL(1u, stats.fills);
+			CHECK_EQUAL(3u, stats.copies);
+			CHECK_EQUAL(2u, stats.textureSwitches);
+			CHECK_EQUAL(1u, stats.presents);
+			CHECK_EQUAL(1u, stats.colorChanges);
+			CHECK_EQUAL(8u, stats.getDrawCalls());
+
+			// 1 point, 4 and 9 along lines, 8 around the rect, 8 filled, 3 copies of 4
+			CHECK_EQUAL(42u, stats.pixels);
+
+			renderer.resetStats();
+			CHECK_EQUAL(0u, renderer.getStats().getDrawCalls());
+			CHECK_EQUAL(0u, renderer.getStats().pixels);
+
+			// The first copy after a reset counts as a switch
+			renderer.copy(second, nullptr, &dst);
+			CHECK_EQUAL(1u, renderer.getStats().textureSwitches);
+
+			first.destroy();
+			second.destroy();
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(DestroyedTarget) {
+		auto renderer = Renderer();
+
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 16, 16, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			renderer.initSW(surf);
+
+			Texture texture;
+			texture.create(renderer.getHandle(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 4, 4);
+			CHECK_EQUAL(true, renderer.setTarget(texture));
+			renderer.clear();
+			CHECK_EQUAL(16u, renderer.getStats().pixels);
+
+			// Destroying the target sends drawing back to the surface
+			texture.destroy();
+			renderer.resetStats();
+			renderer.clear();
+			renderer.fillRect(nullptr);
+			CHECK_EQUAL(2u * 16 * 16, renderer.getStats().pixels);
+
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
 	TEST(ErrorNullHandle) {
 		auto renderer = Renderer();
 		CHECK(nullptr == renderer.getHandle());
@@ -0,0 +1,195 @@
+#include <unittest++/UnitTest++.h>
+#include <atomic>
+#include "Scheduler.h"
+
+using namespace tiledl;
+
+namespace
+{
+	struct Position {
+		float x, y;
+	};
+
+	struct Velocity {
+		float x, y;
+	};
+
+	struct Health {
+		int value;
+	};
+
+	template<int N>
+	struct Tag {
+		char bytes[N];
+	};
+
+	int firstUse(int n)
+	{
+		switch (n % 4) {
+		case 0:
+			return Components::id<Tag<1>>();
+		case 1:
+			return Components::id<Tag<2>>();
+		case 2:
+			return Components::id<Tag<3>>();
+		default:
+			return Components::id<Tag<4>>();
+		}
+	}
+}
+
+SUITE(SchedulerTests)
+{
+	TEST(Conflicts)
+	{
+		const ComponentMask position = Components::mask<Position>();
+		const ComponentMask velocity = Components::mask<Velocity>();
+
+		// Readers never conflict
+		CHECK(!Scheduler::conflicts(position, 0, position, 0));
+		CHECK(Scheduler::conflicts(0, position, position, 0));
+		CHECK(Scheduler::conflicts(position, 0, 0, position));
+		CHECK(Scheduler::conflicts(0, position, 0, position));
+		CHECK(!Scheduler::conflicts(velocity, position, 0, Components::mask<Health>()));
+	}
+
+	TEST(Waves)
+	{
+		World world;
+		JobSystem jobs;
+		Scheduler scheduler(world, jobs);
+		SystemFunction nothing = [](World&, CommandBuffer&) {};
+
+		int move = scheduler.addSystem("move", Components::mask<Velocity>(), Components::mask<Position>(), nothing);
+		int damage = scheduler.addSystem("damage", 0, Components::mask<Health>(), nothing);
+		int camera = scheduler.addSystem("camera", Components::mask<Position>(), 0, nothing);
+		int culling = scheduler.addSystem("culling", Components::mask<Position>(), 0, nothing);
+		int spawn = scheduler.addSystem("spawn", 0, Scheduler::ALL_COMPONENTS, nothing);
+
+		CHECK_EQUAL(0, scheduler.getWave(move));
+		CHECK_EQUAL(0, scheduler.getWave(damage));
+		CHECK_EQUAL(1, scheduler.getWave(camera));
+		CHECK_EQUAL(1, scheduler.getWave(culling));
+		CHECK_EQUAL(2, scheduler.getWave(spawn));
+		CHECK_EQUAL(3, scheduler.getWaveCount());
+
+		CHECK_EQUAL(1, (int)scheduler.getDependencies(camera).size());
+		CHECK_EQUAL(move, scheduler.getDependencies(camera)[0]);
+		CHECK_EQUAL(4, (int)scheduler.getDependencies(spawn).size());
+
+		// Disabled systems are left out of the graph
+		scheduler.setEnabled(move, false);
+		CHECK_EQUAL(-1, scheduler.getWave(move));
+		CHECK_EQUAL(0, scheduler.getWave(camera));
+		CHECK_EQUAL(1, scheduler.getWave(spawn));
+		CHECK_EQUAL("culling", scheduler.getName(culling));
+	}
+
+	TEST(Run)
+	{
+		World world;
+		JobSystem jobs;
+		jobs.start(2);
+		Scheduler scheduler(world, jobs);
+
+		for (int i = 0; i < 1000; i++) {
+			Entity entity = world.create();
+			world.add(entity, Position{ 0, 0 });
+			world.add(entity, Velocity{ 1, 2 });
+			world.add(entity, Health{ 10 });
+		}
+
+		scheduler.addSystem("move", Components::mask<Velocity>(), Components::mask<Position>(),
+		[](World & world, CommandBuffer&) {
+			world.each<Position, const Velocity>([](Entity, Position & position, const Velocity & velocity) {
+				position.x += velocity.x;
+				position.y += velocity.y;
+			});
+		});
+
+		scheduler.addSystem("damage", 0, Components::mask<Health>(), [](World & world, CommandBuffer & commands) {
+			world.each<Health>([&](Entity entity, Health & health) {
+				if (--health.value <= 0) {
+					commands.destroy(entity);
+				}
+			});
+		});
+
+		std::atomic<int> seen(0);
+		scheduler.addSystem("count", Components::mask<Position>(), 0, [&](World & world, CommandBuffer&) {
+			world.each<const Position>([&](Entity, const Position & position) {
+				if (position.y == 2 * position.x) {
+					seen++;
+				}
+			});
+		});
+
+		for (int tick = 1; tick <= 10; tick++) {
+			scheduler.run();
+			CHECK(!world.isIterating());
+		}
+
+		// Every tick counted every entity after moving it, then the last tick destroyed them
+		CHECK_EQUAL(10000, seen.load());
+		CHECK_EQUAL(0, world.getEntityCount());
+	}
+
+	TEST(SystemsUseTheJobSystem)
+	{
+		World world;
+		JobSystem jobs;
+		jobs.start(2);
+		Scheduler scheduler(world, jobs);
+		std::atomic<int> fanned(0), positions(0), healths(0);
+
+		// Fans out on the JobSystem the scheduler runs it on
+		scheduler.addSystem("paths", 0, Components::mask<Velocity>(), [&](World&, CommandBuffer&) {
+			jobs.parallelFor(64, [&](int) {
+				fanned++;
+			});
+		});
+
+		scheduler.addSystem("positions", 0, Components::mask<Position>(), [&](World&, CommandBuffer&) {
+			positions++;
+		});
+
+		scheduler.addSystem("healths", 0, Components::mask<Health>(), [&](World&, CommandBuffer&) {
+			healths++;
+		});
+
+		CHECK_EQUAL(1, scheduler.getWaveCount());
+
+		for (int tick = 0; tick < 20; tick++) {
+			scheduler.run();
+		}
+
+		CHECK_EQUAL(20 * 64, fanned.load());
+		CHECK_EQUAL(20, positions.load());
+		CHECK_EQUAL(20, healths.load());
+	}
+
+	TEST(ConcurrentRegistration)
+	{
+		JobSystem jobs;
+		jobs.start(4);
+		std::atomic<int> torn(0);
+
+		// Types first used on the workers, every registered entry is readable
+		jobs.parallelFor(256, [&](int n) {
+			const int id = firstUse(n);
+
+			if (Components::getInfo(id).size != (size_t)(n % 4 + 1)) {
+				torn++;
+			}
+
+			for (int other = 0; other < Components::getCount(); other++) {
+				if (Components::getInfo(other).size == 0) {
+					torn++;
+				}
+			}
+		}, 1);
+
+		CHECK_EQUAL(0, torn.load());
+		CHECK_EQUAL(sizeof(Tag<3>), Components::getInfo(Components::id<Tag<3>>()).size);
+	}
+}
@@ -0,0 +1,73 @@
+#include <unittest++/UnitTest++.h>
+
+#include "SpscQueue.h"
+#include <stdexcept>
+
+using namespace tiledl;
+
+SUITE(SpscQueueTests)
+{
+	TEST(Construct) {
+		SpscQueue<int> queue(5);
+
+		CHECK_EQUAL(8u, queue.getCapacity());
+		CHECK_EQUAL(true, queue.isEmpty());
+		CHECK_THROW(SpscQueue<int>(0), std::invalid_argument);
+	}
+
+	TEST(PushPop) {
+		SpscQueue<int> queue(4);
+		int value = 0;
+
+		for (int i = 0; i < 4; i++) {
+			CHECK_EQUAL(true, queue.push(i));
+		}
+
+		CHECK_EQUAL(false, queue.push(4));
+
+		for (int i = 0; i < 4; i++) {
+			CHECK_EQUAL(true, queue.pop(value));
+			CHECK_EQUAL(i, value);
+		}
+
+		CHECK_EQUAL(false, queue.pop(value));
+		CHECK_EQUAL(true, queue.isEmpty());
+	}
+
+	TEST(Threaded) {
+		struct Shared {
+			SpscQueue<int>* queue;
+			int count;
+		};
+
+		SpscQueue<int> queue(64);
+		Shared shared = { &queue, 20000 };
+
+		SDL_Thread* producer = SDL_CreateThread((SDL_ThreadFunction)([](void * ptr) -> int {
+			Shared* shared = (Shared*)ptr;
+
+			for (int i = 0; i < shared->count; i++) {
+				while (!shared->queue->push(i)) {
+					SDL_Delay(0);
+				}
+			}
+
+			return 0;
+		}), "Producer", &shared);
+
+		bool ordered = true;
+		int value;
+
+		for (int i = 0; i < shared.count; i++) {
+			while (!queue.pop(value)) {
+				SDL_Delay(0);
+			}
+
+			ordered = ordered && value == i;
+		}
+
+		SDL_WaitThread(producer, NULL);
+		CHECK_EQUAL(true, ordered);
+		CHECK_EQUAL(true, queue.isEmpty());
+	}
+}
@@ -0,0 +1,158 @@
+#include <unittest++/UnitTest++.h>
+
+#include "TileChunk.h"
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace tiledl;
+
+SUITE(TileChunkTests)
+{
+	TEST(Uniform) {
+		TileChunk chunk(7);
+
+		CHECK_EQUAL(true, chunk.isUniform());
+		CHECK_EQUAL(0, chunk.getBits());
+		CHECK_EQUAL(7u, chunk.get(31, 31));
+		CHECK_EQUAL(0, (int)chunk.getData().size());
+	}
+
+	TEST(Growth) {
+		TileChunk chunk;
+
+		chunk.set(1, 0, 5);
+		CHECK_EQUAL(1, chunk.getBits());
+		CHECK_EQUAL(5u, chunk.get(1, 0));
+		CHECK_EQUAL(0u, chunk.get(0, 0));
+
+		chunk.set(2, 0, 6);
+		CHECK_EQUAL(2, chunk.getBits());
+
+		for (Uint32 id = 0; id < 20; id++) {
+			chunk.set(id, 5, 100 + id);
+		}
+
+		CHECK_EQUAL(8, chunk.getBits());
+		CHECK_EQUAL(5u, chunk.get(1, 0));
+		CHECK_EQUAL(6u, chunk.get(2, 0));
+		CHECK_EQUAL(119u, chunk.get(19, 5));
+
+		for (int i = 0; i < TileChunk::AREA; i++) {
+			chunk.set(i % TileChunk::SIZE, i / TileChunk::SIZE, 0x80000000u + i);
+		}
+
+		CHECK_EQUAL(16, chunk.getBits());
+		CHECK_EQUAL(0x80000000u + 1023, chunk.get(31, 31));
+	}
+
+	TEST(ReusesFreeEntries) {
+		TileChunk chunk;
+
+		for (Uint32 id = 1; id < 200; id++) {
+			chunk.set(3, 3, id);
+		}
+
+		CHECK_EQUAL(2, chunk.getPaletteSize());
+		CHECK_EQUAL(1, chunk.getBits());
+		CHECK_EQUAL(199u, chunk.get(3, 3));
+	}
+
+	TEST(Compact) {
+		TileChunk chunk;
+
+		for (int i = 0; i < 40; i++) {
+			chunk.set(i % 32, i / 32, i + 1);
+		}
+
+		CHECK_EQUAL(8, chunk.getBits());
+
+		for (int i = 2; i < 40; i++) {
+			chunk.set(i % 32, i / 32, 0);
+		}
+
+		chunk.compact();
+		CHECK_EQUAL(2, chunk.getBits());
+		CHECK_EQUAL(3, chunk.getPaletteSize());
+		CHECK_EQUAL(2u, chunk.get(1, 0));
+
+		chunk.set(0, 0, 0);
+		chunk.set(1, 0, 0);
+		chunk.compact();
+		CHECK_EQUAL(true, chunk.isUniform());
+		CHECK_EQUAL(0u, chunk.get(1, 0));
+	}
+
+	TEST(MatchesArray) {
+		TileChunk chunk;
+		std::vector<Uint32> expected(TileChunk::AREA, 0);
+		srand(777);
+
+		for (int i = 0; i < 20000; i++) {
+			int x = rand() % 32, y = rand() % 32;
+			Uint32 id = (Uint32)(rand() % ((i / 2000) * 8 + 2));
+
+			chunk.set(x, y, id);
+			expected[y * 32 + x] = id;
+
+			if (i % 5000 == 0) {
+				chunk.compact();
+			}
+		}
+
+		for (int i = 0; i < TileChunk::AREA; i++) {
+			CHECK_EQUAL(expected[i], chunk.get(i % 32, i / 32));
+		}
+	}
+
+	TEST(SetData) {
+		TileChunk source;
+		source.set(4, 4, 9);
+		source.set(5, 4, 10);
+
+		TileChunk copy;
+		copy.setData(source.getBits(), source.getPalette(), source.getData());
+		CHECK_EQUAL(10u, copy.get(5, 4));
+		copy.set(4, 4, 0);
+		copy.set(5, 4, 0);
+		copy.compact();
+		CHECK_EQUAL(true, copy.isUniform());
+
+		CHECK_THROW(copy.setData(3, source.getPalette(), source.getData()), std::invalid_argument);
+		CHECK_THROW(copy.setData(1, std::vector<Uint32>(1, 0), std::vector<Uint64>()), std::invalid_argument);
+	}
+
+	TEST(ReadWrite) {
+		TileChunk source;
+		source.set(4, 4, 9);
+		source.set(5, 4, 10);
+
+		std::vector<Uint8> buffer(8192, 0);
+		SDL_RWops* rw = SDL_RWFromMem(&buffer[0], buffer.size());
+		CHECK_EQUAL(true, source.write(rw));
+		const int length = (int)SDL_RWtell(rw);
+		SDL_RWclose(rw);
+
+		TileChunk loaded(3);
+		rw = SDL_RWFromConstMem(&buffer[0], length);
+		CHECK_EQUAL(true, loaded.read(rw));
+		SDL_RWclose(rw);
+		CHECK_EQUAL(10u, loaded.get(5, 4));
+		CHECK_EQUAL(0u, loaded.get(6, 4));
+
+		// A truncated stream leaves the chunk unchanged
+		TileChunk unchanged(3);
+		rw = SDL_RWFromConstMem(&buffer[0], length - 1);
+		CHECK_EQUAL(false, unchanged.read(rw));
+		SDL_RWclose(rw);
+		CHECK_EQUAL(true, unchanged.isUniform());
+		CHECK_EQUAL(3u, unchanged.get(5, 4));
+
+		// So does an index past the end of the palette
+		buffer[1] = 1; // palette size, low byte
+		buffer[2] = 0;
+		rw = SDL_RWFromConstMem(&buffer[0], length - 8);
+		CHECK_EQUAL(false, unchanged.read(rw));
+		SDL_RWclose(rw);
+		CHECK_EQUAL(3u, unchanged.get(5, 4));
+	}
+}
@@ -0,0 +1,172 @@
+#include <unittest++/UnitTest++.h>
+
+#include "TileCollision.h"
+#include <cmath>
+#include <cstdlib>
+
+using namespace tiledl;
+
+/*
+ * Reference implementation: move in small steps and stop an axis
+ * as soon as the box overlaps a solid tile
+ */
+static Vector substep_move(const TileGrid& grid, Vector pos, const Vector& size, const Vector& delta, int steps)
+{
+	Vector step = delta / steps;
+
+	for (int i = 0; i < steps; i++) {
+		for (int axis = 0; axis < 2; axis++) {
+			Vector next = pos;
+			(axis == 0 ? next.x : next.y) += (axis == 0 ? step.x : step.y);
+
+			int x0 = (int)std::floor(next.x / grid.getTileWidth());
+			int y0 = (int)std::floor(next.y / grid.getTileHeight());
+			int x1 = (int)std::ceil((next.x + size.x) / grid.getTileWidth()) - 1;
+			int y1 = (int)std::ceil((next.y + size.y) / grid.getTileHeight()) - 1;
+			bool blocked = false;
+
+			for (int y = y0; y <= y1; y++) {
+				for (int x = x0; x <= x1; x++) {
+					blocked = blocked || grid.isSolid(x, y);
+				}
+			}
+
+			if (!blocked) {
+				pos = next;
+			}
+		}
+	}
+
+	return pos;
+}
+
+SUITE(TileCollisionTests)
+{
+	TEST(NoHit) {
+		TileGrid grid(10, 10, 16, 16);
+		auto result = TileCollision::sweep(grid, Rectangle(16, 16, 16, 16), Vector(20.0, 30.0));
+		CHECK_EQUAL(false, result.hit);
+		CHECK_CLOSE(1.0, result.time, 1e-9);
+	}
+
+	TEST(HitWall) {
+		TileGrid grid(10, 10, 16, 16);
+		grid.setSolid(5, 1, true);
+
+		auto result = TileCollision::sweep(grid, Rectangle(16, 16, 16, 16), Vector(64.0, 0.0));
+		CHECK_EQUAL(true, result.hit);
+		CHECK_CLOSE(0.75, result.time, 1e-9); // 48 of 64 pixels
+		CHECK_EQUAL(Point(-1, 0), result.normal);
+		CHECK_EQUAL(Point(5, 1), result.tile);
+	}
+
+	TEST(HitFloor) {
+		TileGrid grid(10, 10, 16, 16);
+		grid.setSolid(1, 4, true);
+
+		auto result = TileCollision::sweep(grid, Rectangle(20, 16, 8, 8), Vector(0.0, 100.0));
+		CHECK_EQUAL(true, result.hit);
+		CHECK_CLOSE(0.4, result.time, 1e-9);
+		CHECK_EQUAL(Point(0, -1), result.normal);
+	}
+
+	TEST(NoTunneling) {
+		TileGrid grid(100, 3, 16, 16);
+		grid.setSolid(90, 1, true);
+
+		auto result = TileCollision::sweep(grid, Rectangle(0, 16, 4, 4), Vector(10000.0, 0.0));
+		CHECK_EQUAL(true, result.hit);
+		CHECK_EQUAL(Point(90, 1), result.tile);
+	}
+
+	TEST(RestingOnEdge) {
+		TileGrid grid(10, 10, 16, 16);
+		grid.setSolid(2, 1, true);
+
+		// Touching the wall, moving away or along it is free
+		CHECK_EQUAL(false, TileCollision::sweep(grid, Rectangle(16, 16, 16, 16), Vector(-5.0, 0.0)).hit);
+		CHECK_EQUAL(false, TileCollision::sweep(grid, Rectangle(16, 0, 16, 16), Vector(5.0, 0.0)).hit);
+
+		// Moving into it stops immediately
+		auto result = TileCollision::sweep(grid, Rectangle(16, 16, 16, 16), Vector(5.0, 0.0));
+		CHECK_EQUAL(true, result.hit);
+		CHECK_CLOSE(0.0, result.time, 1e-9);
+	}
+
+	TEST(Corner) {
+		TileGrid grid(10, 10, 16, 16);
+		grid.setSolid(2, 2, true);
+
+		auto result = TileCollision::sweep(grid, Rectangle(16, 16, 16, 16), Vector(16.0, 16.0));
+		CHECK_EQUAL(true, result.hit);
+		CHECK_EQUAL(Point(2, 2), result.tile);
+		CHECK_CLOSE(0.0, result.time, 1e-9);
+	}
+
+	TEST(OutsideGrid) {
+		TileGrid grid(4, 4, 16, 16);
+		auto result = TileCollision::sweep(grid, Rectangle(16, 16, 16, 16), Vector(-100.0, 0.0));
+		CHECK_EQUAL(true, result.hit);
+		CHECK_EQUAL(Point(-1, 1), result.tile);
+	}
+
+	TEST(SlideAlongFloor) {
+		TileGrid grid(10, 10, 16, 16);
+
+		for (int x = 0; x < 10; x++) {
+			grid.setSolid(x, 5, true);
+		}
+
+		SweepResult contact;
+		Vector pos = TileCollision::move(grid, Vector(16.0, 70.0), Vector(8.0, 8.0), Vector(40.0, 40.0), &contact);
+		CHECK_EQUAL(true, contact.hit);
+		CHECK_EQUAL(Point(0, -1), contact.normal);
+		CHECK_CLOSE(56.0, pos.x, 1e-9);
+		CHECK_CLOSE(72.0, pos.y, 1e-9);
+
+		// Gravity while standing on the floor keeps sliding over tile seams
+		for (int i = 0; i < 10; i++) {
+			pos = TileCollision::move(grid, pos, Vector(8.0, 8.0), Vector(3.0, 1.0));
+		}
+
+		CHECK_CLOSE(86.0, pos.x, 1e-9);
+		CHECK_CLOSE(72.0, pos.y, 1e-9);
+	}
+
+	TEST(MatchesSubstepping) {
+		TileGrid grid(20, 20, 16, 16);
+		srand(7);
+
+		for (int i = 0; i < 60; i++) {
+			grid.setSolid(rand() % 20, rand() % 20, true);
+		}
+
+		for (int i = 0; i < 200; i++) {
+			Vector pos(rand() % 300, rand() % 300);
+			Vector size(4 + rand() % 12, 4 + rand() % 12);
+			Vector delta((rand() % 81) - 40, (rand() % 81) - 40);
+			int x0 = (int)(pos.x / 16), y0 = (int)(pos.y / 16);
+			int x1 = (int)std::ceil((pos.x + size.x) / 16) - 1, y1 = (int)std::ceil((pos.y + size.y) / 16) - 1;
+			bool stuck = false;
+
+			for (int y = y0; y <= y1; y++) {
+				for (int x = x0; x <= x1; x++) {
+					stuck = stuck || grid.isSolid(x, y);
+				}
+			}
+
+			if (stuck) {
+				continue;
+			}
+
+			// Sub-stepping also resolves axes separately, so compare the straight moves
+			Vector swept = TileCollision::move(grid, pos, size, Vector(delta.x, 0.0));
+			Vector stepped = substep_move(grid, pos, size, Vector(delta.x, 0.0), 4096);
+			CHECK_CLOSE(stepped.x, swept.x, 0.05);
+
+			swept = TileCollision::move(grid, pos, size, Vector(0.0, delta.y));
+			stepped = substep_move(grid, pos, size, Vector(0.0, delta.y), 4096);
+			CHECK_CLOSE(stepped.y, swept.y, 0.05);
+		}
+	}
+}
@@ -0,0 +1,80 @@
+#include <unittest++/UnitTest++.h>
+
+#include "TileGrid.h"
+#include <stdexcept>
+
+using namespace tiledl;
+
+SUITE(TileGridTests)
+{
+	TEST(ConstructorEmpty) {
+		TileGrid grid;
+		CHECK_EQUAL(0, grid.getWidth());
+		CHECK_EQUAL(0, grid.getHeight());
+		CHECK_EQUAL(true, grid.isSolid(0, 0));
+	}
+
+	TEST(Constructor) {
+		TileGrid grid(4, 3, 16, 8);
+		CHECK_EQUAL(4, grid.getWidth());
+		CHECK_EQUAL(3, grid.getHeight());
+		CHECK_EQUAL(16, grid.getTileWidth());
+		CHECK_EQUAL(8, grid.getTileHeight());
+		CHECK_EQUAL(false, grid.isSolid(3, 2));
+		CHECK_THROW(TileGrid(1, 1, 0, 1), std::invalid_argument);
+	}
+
+	TEST(OutsideIsSolid) {
+		TileGrid grid(4, 3, 16, 16);
+		CHECK_EQUAL(true, grid.isSolid(-1, 0));
+		CHECK_EQUAL(true, grid.isSolid(0, -1));
+		CHECK_EQUAL(true, grid.isSolid(4, 0));
+		CHECK_EQUAL(true, grid.isSolid(0, 3));
+		CHECK_THROW(grid.setSolid(4, 0, true), std::out_of_range);
+	}
+
+	TEST(SetSolid) {
+		TileGrid grid(4, 3, 16, 16);
+		Uint32 version = grid.getVersion();
+
+		grid.setSolid(1, 2, true);
+		CHECK_EQUAL(true, grid.isSolid(1, 2));
+		CHECK_EQUAL(TILE_SOLID, grid.getFlags(1, 2));
+		CHECK(version != grid.getVersion());
+
+		grid.setSolid(1, 2, false);
+		CHECK_EQUAL(false, grid.isSolid(1, 2));
+	}
+
+	TEST(SetOpaque) {
+		TileGrid grid(4, 3, 16, 16);
+
+		grid.setOpaque(2, 1, true);
+		CHECK_EQUAL(true, grid.isOpaque(2, 1));
+		CHECK_EQUAL(false, grid.isSolid(2, 1));
+
+		grid.setSolid(2, 1, true);
+		CHECK_EQUAL(TILE_SOLID | TILE_OPAQUE, grid.getFlags(2, 1));
+
+		grid.setOpaque(2, 1, false);
+		CHECK_EQUAL(false, grid.isOpaque(2, 1));
+		CHECK_EQUAL(true, grid.isOpaque(-1, 0));
+	}
+
+	TEST(Resize) {
+		TileGrid grid(2, 2, 16, 16);
+		grid.setSolid(1, 1, true);
+		grid.resize(3, 3);
+		CHECK_EQUAL(true, grid.isSolid(1, 1));
+		CHECK_EQUAL(false, grid.isSolid(2, 2));
+	}
+
+	TEST(Conversions) {
+		TileGrid grid(4, 4, 16, 8);
+		CHECK_EQUAL(Point(1, 2), grid.toTile(Point(17, 16)));
+		CHECK_EQUAL(Point(-1, -1), grid.toTile(Point(-1, -1)));
+		CHECK_EQUAL(Point(16, 16), grid.toPixel(Point(1, 2)));
+		CHECK_EQUAL(Point(24, 20), grid.getTileCenter(Point(1, 2)));
+		CHECK_EQUAL(Rectangle(16, 16, 16, 8), grid.getTileRect(Point(1, 2)));
+	}
+}
@@ -0,0 +1,64 @@
+#include <unittest++/UnitTest++.h>
+
+#include "TileStorage.h"
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace tiledl;
+
+SUITE(TileStorageTests)
+{
+	TEST(Construct) {
+		TileStorage storage(100, 40, 2);
+
+		CHECK_EQUAL(100, storage.getWidth());
+		CHECK_EQUAL(40, storage.getHeight());
+		CHECK_EQUAL(2, storage.getLayerCount());
+		CHECK_EQUAL(4, storage.getChunksWide());
+		CHECK_EQUAL(2, storage.getChunksHigh());
+		CHECK_EQUAL(0u, storage.get(1, 99, 39));
+	}
+
+	TEST(GetSet) {
+		TileStorage storage(100, 40, 2);
+
+		storage.set(0, 99, 39, 12);
+		storage.set(1, 99, 39, 34);
+		storage.fill(0, 5);
+		storage.set(0, 33, 1, 6);
+
+		CHECK_EQUAL(5u, storage.get(0, 99, 39));
+		CHECK_EQUAL(34u, storage.get(1, 99, 39));
+		CHECK_EQUAL(6u, storage.get(0, 33, 1));
+		CHECK_EQUAL(6u, storage.getChunk(0, 1, 0).get(1, 1));
+
+		CHECK_EQUAL(0u, storage.get(0, -1, 0));
+		CHECK_EQUAL(0u, storage.get(2, 0, 0));
+		CHECK_THROW(storage.set(0, 100, 0, 1), std::out_of_range);
+		CHECK_THROW(storage.set(2, 0, 0, 1), std::out_of_range);
+		CHECK_THROW(storage.getChunk(0, 4, 0), std::out_of_range);
+	}
+
+	TEST(MemoryUsage) {
+		// Terrain of a few ids in large areas with scattered decorations
+		const int size = 1024;
+		TileStorage storage(size, size, 2);
+		srand(4242);
+
+		for (int y = 0; y < size; y++) {
+			for (int x = 0; x < size; x++) {
+				storage.set(0, x, y, (Uint32)(((x / 200) + (y / 150)) % 4 + 1));
+			}
+		}
+
+		for (int i = 0; i < 20000; i++) {
+			storage.set(1, rand() % size, rand() % size, 1000 + rand() % 6);
+		}
+
+		storage.compact();
+
+		size_t plain = (size_t)size * size * 2 * sizeof(Uint32);
+		CHECK(storage.getMemoryUsage() * 10 < plain);
+		CHECK_EQUAL((Uint32)(((500 / 200) + (700 / 150)) % 4 + 1), storage.get(0, 500, 700));
+	}
+}
@@ -0,0 +1,347 @@
+#include <unittest++/UnitTest++.h>
+
+#include "TilemapRenderer.h"
+#include <stdexcept>
+
+using namespace tiledl;
+
+static const Uint32 RED = 0xff0000ffu;
+static const Uint32 GREEN = 0xff00ff00u;
+
+/*
+ * A tileset of two 4x4 tiles, red then green
+ */
+static bool create_tileset(Renderer& renderer, Texture& tileset)
+{
+	Uint32 pixels[4 * 8];
+
+	for (int i = 0; i < 4 * 8; i++) {
+		pixels[i] = (i % 8 < 4) ? RED : GREEN;
+	}
+
+	if (!tileset.create(renderer.getHandle(), SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, 8, 4)) {
+		return false;
+	}
+
+	tileset.setBlendMode(SDL_BLENDMODE_BLEND);
+	return tileset.updateTexture(NULL, pixels, 8 * 4);
+}
+
+SUITE(TilemapRendererTests)
+{
+	TEST(Passes) {
+		TileStorage tiles(100, 70, 4);
+		TilemapRenderer map(tiles, 4, 4);
+		Texture tileset;
+
+		map.addLayer(0, tileset, Vector(1.0, 1.0), false);
+		map.addLayer(1, tileset, Vector(1.0, 1.0), false);
+		map.addLayer(2, tileset, Vector(0.5, 0.5), false);
+		map.addLayer(3, tileset, Vector(0.5, 0.5), true);
+
+		CHECK_EQUAL(4, map.getLayerCount());
+		CHECK_EQUAL(3, map.getPassCount());
+		map.setFlatten(false);
+		CHECK_EQUAL(4, map.getPassCount());
+		map.setFlatten(true);
+		map.setLayerVisible(1, false);
+		CHECK_EQUAL(3, map.getPassCount());
+		CHECK_EQUAL(false, map.getLayer(1).visible);
+
+		CHECK_THROW(map.addLayer(4, tileset, Vector(1.0, 1.0), false), std::out_of_range);
+		CHECK_THROW(TilemapRenderer(tiles, 0, 4), std::invalid_argument);
+	}
+
+	TEST(Occupancy) {
+		TileStorage tiles(100, 70, 2);
+		TilemapRenderer map(tiles, 4, 4);
+		Texture tileset;
+
+		tiles.set(1, 40, 40, 1);
+		map.addLayer(0, tileset, Vector(1.0, 1.0), false);
+		map.addLayer(1, tileset, Vector(1.0, 1.0), false);
+
+		CHECK_EQUAL(false, map.isOccupied(0, 1, 1));
+		CHECK_EQUAL(true, map.isOccupied(1, 1, 1));
+		CHECK_EQUAL(false, map.isOccupied(1, 0, 1));
+
+		tiles.set(1, 40, 40, 0);
+		tiles.set(0, 0, 33, 2);
+		map.invalidate(1, 1, 1);
+		CHECK_EQUAL(false, map.isOccupied(1, 1, 1));
+		CHECK_EQUAL(false, map.isOccupied(0, 0, 1));
+		map.invalidate();
+		CHECK_EQUAL(true, map.isOccupied(0, 0, 1));
+	}
+
+	TEST(Draw) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 64, 48, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			Renderer renderer;
+			Texture tileset;
+			renderer.initSW(surf);
+			CHECK_EQUAL(true, create_tileset(renderer, tileset));
+
+			TileStorage tiles(100, 70, 2);
+			TilemapRenderer map(tiles, 4, 4);
+			Uint32* pixels = (Uint32*)surf->pixels;
+
+			tiles.fill(0, 1);
+			tiles.set(1, 1, 0, 2);
+			map.addLayer(0, tileset, Vector(1.0, 1.0), false);
+			map.addLayer(1, tileset, Vector(1.0, 1.0), false);
+
+			map.draw(renderer, Vector(0, 0), Rectangle(0, 0, 64, 48));
+			CHECK_EQUAL(RED, pixels[0]);
+			CHECK_EQUAL(GREEN, pixels[64 + 5]);
+			CHECK_EQUAL(1, map.getDrawnCount());
+			CHECK_EQUAL(1, map.getBakedCount());
+			CHECK_EQUAL(1, map.getCachedCount());
+
+			// Cached from now on, until invalidated
+			tiles.set(1, 0, 0, 2);
+			map.draw(renderer, Vector(0, 0), Rectangle(0, 0, 64, 48));
+			CHECK_EQUAL(0, map.getBakedCount());
+			CHECK_EQUAL(RED, pixels[0]);
+
+			map.invalidate(1, 0, 0);
+			map.draw(renderer, Vector(0, 0), Rectangle(0, 0, 64, 48));
+			CHECK_EQUAL(1, map.getBakedCount());
+			CHECK_EQUAL(GREEN, pixels[0]);
+
+			// Scrolled so the first tile is off screen
+			map.draw(renderer, Vector(4, 0), Rectangle(0, 0, 64, 48));
+			CHECK_EQUAL(GREEN, pixels[0]);
+			CHECK_EQUAL(RED, pixels[4]);
+
+			tileset.destroy();
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(MapEdges) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 256, 256, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			Renderer renderer;
+			Texture tileset;
+			renderer.initSW(surf);
+			CHECK_EQUAL(true, create_tileset(renderer, tileset));
+
+			// 40x40 tiles of 4 pixels, the edge chunks are 8 tiles wide or high
+			TileStorage tiles(40, 40, 1);
+			tiles.fill(0, 1);
+			CHECK_EQUAL(0u, tiles.getChunk(0, 1, 1).get(8, 0));
+			CHECK_EQUAL(1u, tiles.getChunk(0, 1, 1).get(7, 7));
+
+			// Padding cells filled by something else are never drawn either
+			tiles.getChunk(0, 1, 0).fill(1);
+			tiles.getChunk(0, 0, 1).set(0, 20, 2);
+
+			TilemapRenderer map(tiles, 4, 4);
+			Uint32* pixels = (Uint32*)surf->pixels;
+			map.addLayer(0, tileset, Vector(1.0, 1.0), false);
+
+			for (int capacity = 8; capacity >= 0; capacity -= 8) {
+				map.setCacheCapacity(capacity);
+				renderer.setDrawColor(0, 0, 0, 0);
+				renderer.clear();
+				map.draw(renderer, Vector(0, 0), Rectangle(0, 0, 256, 256));
+
+				CHECK_EQUAL(RED, pixels[159 * 256 + 159]);
+				CHECK_EQUAL(0u, pixels[10 * 256 + 200]);
+				CHECK_EQUAL(0u, pixels[160 * 256 + 10]);
+				CHECK_EQUAL(0u, pixels[208 * 256 + 0]);
+			}
+
+			// A chunk with tiles only past the edge has nothing to draw
+			TileStorage padding(40, 40, 1);
+			padding.getChunk(0, 1, 0).set(20, 0, 1);
+			TilemapRenderer empty(padding, 4, 4);
+			empty.addLayer(0, tileset, Vector(1.0, 1.0), false);
+			CHECK_EQUAL(false, empty.isOccupied(0, 1, 0));
+
+			tileset.destroy();
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(ParallaxAndSkipping) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 256, 16, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			Renderer renderer;
+			Texture tileset;
+			renderer.initSW(surf);
+			create_tileset(renderer, tileset);
+
+			TileStorage tiles(100, 70, 2);
+			TilemapRenderer map(tiles, 4, 4);
+			Uint32* pixels = (Uint32*)surf->pixels;
+
+			tiles.set(0, 2, 0, 1);
+			tiles.set(1, 4, 0, 2);
+			map.addLayer(0, tileset, Vector(0.5, 0.5), false);
+			map.addLayer(1, tileset, Vector(1.0, 1.0), true);
+
+			// Three chunks across in each layer, only the first has tiles
+			map.draw(renderer, Vector(8, 0), Rectangle(0, 0, 256, 16));
+			CHECK_EQUAL(2, map.getDrawnCount());
+			CHECK_EQUAL(4, map.getSkippedCount());
+			CHECK_EQUAL(RED, pixels[4]);
+			CHECK_EQUAL(GREEN, pixels[8]);
+
+			// Dynamic layers need no invalidation
+			tiles.set(1, 5, 0, 1);
+			map.draw(renderer, Vector(8, 0), Rectangle(0, 0, 256, 16));
+			CHECK_EQUAL(RED, pixels[12]);
+			CHECK_EQUAL(0, map.getBakedCount());
+
+			map.setCacheCapacity(0);
+			CHECK_EQUAL(0, map.getCachedCount());
+			SDL_FillRect(surf, NULL, 0);
+			map.draw(renderer, Vector(8, 0), Rectangle(0, 0, 256, 16));
+			CHECK_EQUAL(RED, pixels[4]);
+
+			tileset.destroy();
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(Animation) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 64, 16, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			Renderer renderer;
+			Texture tileset;
+			renderer.initSW(surf);
+			create_tileset(renderer, tileset);
+
+			TileStorage tiles(100, 70, 2);
+			TilemapRenderer map(tiles, 4, 4);
+			Uint32* pixels = (Uint32*)surf->pixels;
+			std::vector<Uint32> frames;
+			frames.push_back(1);
+			frames.push_back(2);
+
+			tiles.fill(0, 1);
+			tiles.set(0, 2, 0, 3);
+			tiles.set(0, 40, 40, 3);
+			tiles.set(1, 5, 0, 3);
+			map.addLayer(0, tileset, Vector(1.0, 1.0), false);
+			map.addLayer(1, tileset, Vector(1.0, 1.0), true);
+
+			CHECK_THROW(map.addAnimation(3, std::vector<Uint32>(), 100), std::invalid_argument);
+			CHECK_EQUAL(0, map.addAnimation(3, frames, 100));
+			CHECK_EQUAL(1, map.getAnimationCount());
+			CHECK_EQUAL(1, map.getAnimatedCellCount(0, 0, 0));
+			CHECK_EQUAL(1, map.getAnimatedCellCount(0, 1, 1));
+			CHECK_EQUAL(0, map.getAnimatedCellCount(0, 1, 0));
+			CHECK_EQUAL(0, map.getAnimatedCellCount(1, 0, 0));
+
+			map.animate(50);
+			map.draw(renderer, Vector(0, 0), Rectangle(0, 0, 64, 16));
+			CHECK_EQUAL(1u, map.getFrame(3));
+			CHECK_EQUAL(7u, map.getFrame(7));
+			CHECK_EQUAL(RED, pixels[8]);
+			CHECK_EQUAL(RED, pixels[20]);
+			CHECK_EQUAL(1, map.getAnimatedCount());
+
+			// The next frame without redrawing the cached chunk
+			map.animate(150);
+			map.draw(renderer, Vector(0, 0), Rectangle(0, 0, 64, 16));
+			CHECK_EQUAL(0, map.getBakedCount());
+			CHECK_EQUAL(GREEN, pixels[8]);
+			CHECK_EQUAL(GREEN, pixels[20]);
+			CHECK_EQUAL(RED, pixels[4]);
+
+			map.animate(200);
+			map.draw(renderer, Vector(0, 0), Rectangle(0, 0, 64, 16));
+			CHECK_EQUAL(RED, pixels[8]);
+
+			tiles.set(0, 2, 0, 1);
+			map.invalidate(0, 0, 0);
+			CHECK_EQUAL(0, map.getAnimatedCellCount(0, 0, 0));
+
+			tileset.destroy();
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+
+	TEST(AnimatedUnderFlattened) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 16, 16, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			Renderer renderer;
+			Texture tileset;
+			renderer.initSW(surf);
+			create_tileset(renderer, tileset);
+
+			// Animated water with a green decoration over its top left tile
+			TileStorage tiles(4, 4, 2);
+			TilemapRenderer map(tiles, 4, 4);
+			Uint32* pixels = (Uint32*)surf->pixels;
+			std::vector<Uint32> frames;
+			frames.push_back(1);
+
+			tiles.fill(0, 3);
+			tiles.set(1, 0, 0, 2);
+			map.addLayer(0, tileset, Vector(1.0, 1.0), false);
+			map.addLayer(1, tileset, Vector(1.0, 1.0), false);
+			CHECK_EQUAL(1, map.getPassCount());
+
+			map.addAnimation(3, frames, 100);
+			CHECK_EQUAL(2, map.getPassCount());
+
+			map.animate(0);
+			map.draw(renderer, Vector(0, 0), Rectangle(0, 0, 16, 16));
+			CHECK_EQUAL(GREEN, pixels[0]);
+			CHECK_EQUAL(RED, pixels[4]);
+			CHECK(renderer.getTarget() == nullptr);
+
+			// Without animated tiles the layers share a pass again
+			tiles.fill(0, 1);
+			map.invalidate(0, 0, 0);
+			CHECK_EQUAL(1, map.getPassCount());
+
+			tileset.destroy();
+			renderer.destroy();
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+}
@@ -0,0 +1,92 @@
+#include <unittest++/UnitTest++.h>
+
+#include "VisibilityMap.h"
+#include <stdexcept>
+
+using namespace tiledl;
+
+SUITE(VisibilityMapTests)
+{
+	TEST(SetAndClear) {
+		VisibilityMap map(100, 3);
+
+		CHECK_EQUAL(0, map.count());
+		map.set(0, 0);
+		map.set(70, 1);
+		map.set(99, 2);
+
+		CHECK_EQUAL(true, map.isVisible(70, 1));
+		CHECK_EQUAL(false, map.isVisible(71, 1));
+		CHECK_EQUAL(false, map.isVisible(-1, 0));
+		CHECK_EQUAL(false, map.isVisible(100, 2));
+		CHECK_EQUAL(3, map.count());
+
+		map.clear(Rectangle(65, 1, 2, 1));
+		CHECK_EQUAL(false, map.isVisible(70, 1));
+		CHECK_EQUAL(2, map.count());
+
+		map.clear();
+		CHECK_EQUAL(0, map.count());
+	}
+
+	TEST(Merge) {
+		VisibilityMap a(80, 4), b(80, 4);
+
+		a.set(1, 1);
+		b.set(2, 2);
+		b.set(70, 3);
+
+		a.merge(b, Rectangle(0, 0, 10, 4));
+		CHECK_EQUAL(true, a.isVisible(1, 1));
+		CHECK_EQUAL(true, a.isVisible(2, 2));
+		CHECK_EQUAL(false, a.isVisible(70, 3));
+
+		VisibilityMap small(10, 10);
+		CHECK_THROW(a.merge(small, Rectangle(0, 0, 10, 10)), std::invalid_argument);
+	}
+
+	TEST(Diff) {
+		VisibilityMap a(130, 10), b(130, 10);
+
+		CHECK_EQUAL(0, a.diff(b).w);
+
+		a.set(3, 2);
+		b.set(128, 7);
+		CHECK_EQUAL(Rectangle(3, 2, 126, 6), a.diff(b));
+
+		b.set(3, 2);
+		b.clear();
+		b.set(3, 2);
+		CHECK_EQUAL(0, a.diff(b).w);
+	}
+
+	TEST(Upload) {
+		if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+			auto surf = SDL_CreateRGBSurface(0, 4, 4, 32,
+			                                 0x000000ff,
+			                                 0x0000ff00,
+			                                 0x00ff0000,
+			                                 0xff000000);
+			auto renderer = SDL_CreateSoftwareRenderer(surf);
+			Texture texture;
+			VisibilityMap map(4, 4);
+
+			map.set(1, 2);
+
+			CHECK_EQUAL(true, texture.create(renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, 4, 4));
+			CHECK_EQUAL(true, map.upload(texture, Rectangle(0, 0, 4, 4), 0xffffffff, 0xff000000));
+			SDL_RenderCopy(renderer, texture.getHandle(), NULL, NULL);
+
+			Uint32* pixels = (Uint32*)surf->pixels;
+			CHECK_EQUAL(0xffffffffu, pixels[2 * surf->pitch / 4 + 1]);
+			CHECK_EQUAL(0xff000000u, pixels[0]);
+
+			texture.destroy();
+			SDL_DestroyRenderer(renderer);
+			SDL_FreeSurface(surf);
+			SDL_Quit();
+		} else {
+			SDL_Log("Could not init SDL with SDL_INIT_VIDEO : %s", SDL_GetError());
+		}
+	}
+}
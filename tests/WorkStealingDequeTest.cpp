@@ -0,0 +1,106 @@
+#include <unittest++/UnitTest++.h>
+
+#include "WorkStealingDeque.h"
+#include <stdexcept>
+#include <atomic>
+#include <vector>
+
+using namespace tiledl;
+
+SUITE(WorkStealingDequeTests)
+{
+	TEST(Construct) {
+		WorkStealingDeque<int> deque(5);
+
+		CHECK_EQUAL(8u, deque.getCapacity());
+		CHECK_EQUAL(true, deque.isEmpty());
+		CHECK(deque.pop() == nullptr);
+		CHECK(deque.steal() == nullptr);
+		CHECK_THROW(WorkStealingDeque<int>(0), std::invalid_argument);
+	}
+
+	TEST(PopIsLastInStealIsFirstIn) {
+		WorkStealingDeque<int> deque(4);
+		int items[5] = { 0, 1, 2, 3, 4 };
+
+		for (int i = 0; i < 4; i++) {
+			CHECK_EQUAL(true, deque.push(&items[i]));
+		}
+
+		CHECK_EQUAL(false, deque.push(&items[4]));
+
+		CHECK_EQUAL(&items[3], deque.pop());
+		CHECK_EQUAL(&items[0], deque.steal());
+		CHECK_EQUAL(&items[2], deque.pop());
+		CHECK_EQUAL(&items[1], deque.steal());
+		CHECK(deque.pop() == nullptr);
+		CHECK(deque.steal() == nullptr);
+		CHECK_EQUAL(true, deque.isEmpty());
+
+		// Room again once emptied
+		CHECK_EQUAL(true, deque.push(&items[4]));
+		CHECK_EQUAL(&items[4], deque.pop());
+	}
+
+	TEST(Threaded) {
+		struct Shared {
+			WorkStealingDeque<int>* deque;
+			std::atomic<int>* taken; // times each item was taken
+			std::atomic<bool> done;
+		};
+
+		const int count = 20000;
+		std::vector<int> items(count);
+		std::vector<std::atomic<int>> taken(count);
+		WorkStealingDeque<int> deque(64);
+
+		for (int i = 0; i < count; i++) {
+			items[i] = i;
+			taken[i] = 0;
+		}
+
+		Shared shared;
+		shared.deque = &deque;
+		shared.taken = &taken[0];
+		shared.done = false;
+
+		SDL_Thread* thief = SDL_CreateThread((SDL_ThreadFunction)([](void * ptr) -> int {
+			Shared* shared = (Shared*)ptr;
+
+			while (!shared->done || !shared->deque->isEmpty()) {
+				if (int* item = shared->deque->steal()) {
+					shared->taken[*item]++;
+				} else {
+					SDL_Delay(0);
+				}
+			}
+
+			return 0;
+		}), "Thief", &shared);
+
+		// Push everything, popping every other item to race the thief
+		for (int i = 0; i < count; i++) {
+			while (!deque.push(&items[i])) {
+				SDL_Delay(0);
+			}
+
+			if (i % 2 == 1) {
+				if (int* item = deque.pop()) {
+					taken[*item]++;
+				}
+			}
+		}
+
+		shared.done = true;
+		SDL_WaitThread(thief, NULL);
+
+		bool once = true;
+
+		for (int i = 0; i < count; i++) {
+			once = once && taken[i] == 1;
+		}
+
+		CHECK_EQUAL(true, once);
+		CHECK_EQUAL(true, deque.isEmpty());
+	}
+}
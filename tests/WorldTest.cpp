@@ -0,0 +1,256 @@
+#include <unittest++/UnitTest++.h>
+#include <string>
+#include <stdexcept>
+#include "World.h"
+#include "CommandBuffer.h"
+
+using namespace tiledl;
+
+namespace
+{
+	struct Position {
+		float x, y;
+	};
+
+	struct Velocity {
+		float x, y;
+	};
+
+	struct Name {
+		std::string value;
+	};
+}
+
+SUITE(WorldTests)
+{
+	TEST(ComponentIds)
+	{
+		CHECK_EQUAL(Components::id<Position>(), Components::id<Position>());
+		CHECK_EQUAL(Components::id<Position>(), Components::id<const Position>());
+		CHECK(Components::id<Position>() != Components::id<Velocity>());
+
+		CHECK_EQUAL(sizeof(Position), Components::getInfo(Components::id<Position>()).size);
+		CHECK_EQUAL(((ComponentMask)1 << Components::id<Position>()) | ((ComponentMask)1 << Components::id<Velocity>()),
+		            (Components::mask<Position, Velocity>()));
+	}
+
+	TEST(HandleGenerations)
+	{
+		World world;
+		Entity first = world.create();
+		CHECK(world.isAlive(first));
+		CHECK(!world.isAlive(Entity()));
+		CHECK_EQUAL(1, world.getEntityCount());
+
+		CHECK(world.destroy(first));
+		CHECK(!world.destroy(first));
+		CHECK(!world.isAlive(first));
+		CHECK_EQUAL(0, world.getEntityCount());
+
+		// The index is reused, the stale handle stays dead
+		Entity second = world.create();
+		CHECK_EQUAL(first.index, second.index);
+		CHECK(first.generation != second.generation);
+		CHECK(world.isAlive(second));
+		CHECK(!world.isAlive(first));
+
+		world.add(second, Position{ 1, 2 });
+		CHECK(world.get<Position>(first) == nullptr);
+		CHECK_THROW(world.add(first, Position{ 0, 0 }), std::invalid_argument);
+	}
+
+	TEST(AddRemove)
+	{
+		World world;
+		Entity entity = world.create();
+		world.add(entity, Position{ 1, 2 });
+		world.add(entity, Name{ "player" });
+		world.add(entity, Velocity{ 3, 4 });
+
+		CHECK(world.has<Position>(entity));
+		CHECK(world.has<Velocity>(entity));
+		CHECK_EQUAL(2.0f, world.get<Position>(entity)->y);
+		CHECK_EQUAL(3.0f, world.get<Velocity>(entity)->x);
+		CHECK_EQUAL("player", world.get<Name>(entity)->value);
+
+		// Moving between archetypes keeps the other components
+		CHECK(world.remove<Velocity>(entity));
+		CHECK(!world.remove<Velocity>(entity));
+		CHECK(!world.has<Velocity>(entity));
+		CHECK(world.get<Velocity>(entity) == nullptr);
+		CHECK_EQUAL(1.0f, world.get<Position>(entity)->x);
+		CHECK_EQUAL("player", world.get<Name>(entity)->value);
+
+		// Adding again overwrites in place
+		world.add(entity, Name{ "enemy" });
+		CHECK_EQUAL("enemy", world.get<Name>(entity)->value);
+
+		// Position, Position+Name, Position+Name+Velocity and the empty archetype
+		CHECK_EQUAL(4, world.getArchetypeCount());
+	}
+
+	TEST(SwapRemoveKeepsHandles)
+	{
+		World world;
+		std::vector<Entity> entities;
+
+		for (int i = 0; i < 10; i++) {
+			Entity entity = world.create();
+			world.add(entity, Position{ (float)i, 0 });
+			entities.push_back(entity);
+		}
+
+		world.destroy(entities[2]);
+		world.remove<Position>(entities[5]);
+
+		for (int i = 0; i < 10; i++) {
+			if (i == 2 || i == 5) {
+				continue;
+			}
+
+			CHECK_EQUAL((float)i, world.get<Position>(entities[i])->x);
+		}
+
+		CHECK(world.isAlive(entities[5]));
+		CHECK_EQUAL(9, world.getEntityCount());
+	}
+
+	TEST(Each)
+	{
+		World world;
+
+		for (int i = 0; i < 100; i++) {
+			Entity entity = world.create();
+			world.add(entity, Position{ (float)i, 0 });
+
+			if (i % 2 == 0) {
+				world.add(entity, Velocity{ 1, 2 });
+			}
+		}
+
+		world.each<Position, const Velocity>([](Entity, Position& position, const Velocity& velocity) {
+			position.x += velocity.x;
+			position.y += velocity.y;
+		});
+
+		int count = 0;
+		float sum = 0;
+
+		world.each<const Position>([&](Entity, const Position& position) {
+			count++;
+			sum += position.y;
+		});
+
+		CHECK_EQUAL(100, count);
+		CHECK_EQUAL(100.0f, sum);
+
+		int moving = 0;
+		world.each<Velocity>([&](Entity, Velocity&) { moving++; });
+		CHECK_EQUAL(50, moving);
+	}
+
+	TEST(ChunksAreContiguous)
+	{
+		World world;
+		const int total = 100000;
+
+		for (int i = 0; i < total; i++) {
+			Entity entity = world.create();
+			world.add(entity, Position{ (float)i, 1 });
+		}
+
+		int chunks = 0, count = 0;
+		bool contiguous = true;
+
+		world.eachChunk<Position>([&](int size, const Entity* entities, Position* positions) {
+			chunks++;
+			count += size;
+
+			for (int i = 0; i < size; i++) {
+				if (positions[i].y != 1 || entities[i].generation == 0) {
+					contiguous = false;
+				}
+			}
+		});
+
+		CHECK(contiguous);
+		CHECK_EQUAL(total, count);
+
+		// Every chunk but the last is full
+		Archetype* archetype = world.getArchetypes().back();
+		CHECK_EQUAL(total, archetype->getCount());
+		CHECK_EQUAL((total + archetype->getChunkCapacity() - 1) / archetype->getChunkCapacity(), chunks);
+		CHECK(archetype->getChunkCapacity() > 1);
+	}
+
+	TEST(StructuralChangesWhileIterating)
+	{
+		World world;
+		Entity entity = world.create();
+		world.add(entity, Position{ 0, 0 });
+
+		bool threw = false;
+
+		world.each<Position>([&](Entity e, Position&) {
+			try {
+				world.add(e, Velocity{ 0, 0 });
+			} catch (std::logic_error&) {
+				threw = true;
+			}
+		});
+
+		CHECK(threw);
+		CHECK(!world.isIterating());
+		CHECK(!world.has<Velocity>(entity));
+	}
+
+	TEST(DeferredChanges)
+	{
+		World world;
+
+		for (int i = 0; i < 10; i++) {
+			Entity entity = world.create();
+			world.add(entity, Position{ (float)i, 0 });
+		}
+
+		world.each<Position>([&](Entity entity, Position& position) {
+			if ((int)position.x % 2 == 0) {
+				world.getCommands().destroy(entity);
+			} else {
+				world.getCommands().add(entity, Velocity{ 1, 1 });
+			}
+
+			world.getCommands().create(Position{ 100, 0 }, Name{ "spawned" });
+		});
+
+		CHECK_EQUAL(20, world.getCommands().getCount());
+		CHECK_EQUAL(10, world.getEntityCount());
+
+		world.flush();
+		CHECK(world.getCommands().isEmpty());
+		CHECK_EQUAL(15, world.getEntityCount());
+
+		int moving = 0, spawned = 0;
+		world.each<Position, Velocity>([&](Entity, Position&, Velocity&) { moving++; });
+		world.each<Name>([&](Entity, Name& name) { spawned += (name.value == "spawned"); });
+		CHECK_EQUAL(5, moving);
+		CHECK_EQUAL(10, spawned);
+	}
+
+	TEST(StaleCommandsAreSkipped)
+	{
+		World world;
+		Entity entity = world.create();
+
+		CommandBuffer commands;
+		commands.destroy(entity);
+		commands.add(entity, Position{ 0, 0 });
+		commands.remove<Position>(entity);
+		commands.destroy(entity);
+
+		commands.playback(world);
+		CHECK(!world.isAlive(entity));
+		CHECK_EQUAL(0, world.getEntityCount());
+		CHECK(commands.isEmpty());
+	}
+}